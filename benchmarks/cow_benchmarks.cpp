@@ -0,0 +1,38 @@
+#include "../myLib/cow_train.h"
+#include "fixtures.h"
+
+using namespace benchFixtures;
+
+namespace {
+
+  /// @brief One what-if alternative: copy the base train, board a group and insert a wagon in the middle.
+  /// @tparam Consist Train or CowTrain.
+  /// @param base The train the alternative starts from.
+  /// @return The number of wagons of the alternative.
+  template <typename Consist>
+  int whatIfAlternative(const Consist& base) {
+    Consist alternative = base;
+    alternative.boardPassengersToMostAvailableWagon(1, WagonType::ECONOMY);
+    alternative.addWagonAtIndex(Wagon(WagonType::SITTING), alternative.getNumWagons() / 2);
+    return alternative.getNumWagons();
+  }
+
+} // namespace
+
+// Альтернатива на глубокой копии поезда
+static void BM_WhatIfTrain(benchmark::State& state) {
+  const Train base = makeTrain(static_cast<int>(state.range(0)), MIX_BALANCED);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(whatIfAlternative(base));
+  }
+}
+BENCHMARK(BM_WhatIfTrain)->ArgName("wagons")->Arg(256)->Arg(4096)->Arg(65536);
+
+// Та же альтернатива на копии при записи: клонируются только затронутые куски
+static void BM_WhatIfCowTrain(benchmark::State& state) {
+  const CowTrain base(makeTrain(static_cast<int>(state.range(0)), MIX_BALANCED));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(whatIfAlternative(base));
+  }
+}
+BENCHMARK(BM_WhatIfCowTrain)->ArgName("wagons")->Arg(256)->Arg(4096)->Arg(65536);
@@ -0,0 +1,87 @@
+#ifndef FIXTURES_H
+#define FIXTURES_H
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include "../myLib/train.h"
+
+using namespace lab2ComplexClass;
+using namespace lab2SimpleClass;
+
+namespace benchFixtures {
+
+  /// @brief Type mixes used to parameterize the benchmarks (second benchmark argument).
+  enum TypeMix { MIX_BALANCED = 0, MIX_ECONOMY_HEAVY = 1, MIX_SINGLE_TYPE = 2 };
+
+  /// @brief Human-readable label of a type mix for the benchmark report.
+  /// @param mix The type mix.
+  /// @return The label.
+  inline const char* mixLabel(int mix) {
+    switch (mix) {
+      case MIX_ECONOMY_HEAVY:
+        return "economy-heavy";
+      case MIX_SINGLE_TYPE:
+        return "single-type";
+      default:
+        return "balanced";
+    }
+  }
+
+  /// @brief Pick a wagon type according to the requested mix.
+  /// @param mix The type mix.
+  /// @param rng The random number generator.
+  /// @return The wagon type.
+  inline WagonType pickType(int mix, std::mt19937& rng) {
+    int roll = static_cast<int>(rng() % 100);
+    switch (mix) {
+      case MIX_ECONOMY_HEAVY:
+        if (roll < 70) return WagonType::ECONOMY;
+        if (roll < 85) return WagonType::SITTING;
+        if (roll < 95) return WagonType::LUXURY;
+        return WagonType::RESTAURANT;
+      case MIX_SINGLE_TYPE:
+        return WagonType::ECONOMY;
+      default:
+        return static_cast<WagonType>(roll % 4);
+    }
+  }
+
+  /// @brief Build a half-occupied wagon of the given type with default capacity.
+  /// @param type The wagon type.
+  /// @param rng The random number generator.
+  /// @return The wagon.
+  inline Wagon makeWagon(WagonType type, std::mt19937& rng) {
+    Wagon wagon(type);
+    if (wagon.getMaxCapacity() > 0) {
+      wagon.setOccupiedSeats(static_cast<int>(rng() % (wagon.getMaxCapacity() / 2 + 1)));
+    }
+    return wagon;
+  }
+
+  /// @brief Build a deterministic train of the given size and type mix.
+  /// @param size The number of wagons.
+  /// @param mix The type mix.
+  /// @return The train.
+  inline Train makeTrain(int size, int mix) {
+    std::mt19937 rng(static_cast<unsigned>(size * 31 + mix));
+    Train train;
+    for (int i = 0; i < size; i++) {
+      train.addWagon(makeWagon(pickType(mix, rng), rng));
+    }
+    return train;
+  }
+
+  /// @brief Register the standard train size x type mix grid on a benchmark.
+  /// @param bench The benchmark to parameterize.
+  inline void sizeAndMix(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({"wagons", "mix"});
+    for (int mix = MIX_BALANCED; mix <= MIX_SINGLE_TYPE; mix++) {
+      for (int size = 8; size <= 4096; size *= 8) {
+        bench->Args({size, mix});
+      }
+    }
+  }
+
+} // namespace benchFixtures
+
+#endif // FIXTURES_H
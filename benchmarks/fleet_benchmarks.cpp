@@ -0,0 +1,74 @@
+#include <vector>
+#include "../myLib/fleet_index.h"
+#include "fixtures.h"
+
+using namespace benchFixtures;
+
+namespace {
+
+  constexpr int FLEET_TRAIN_WAGONS = 8;   // Вагонов в каждом поезде парка
+  constexpr int WANTED_LUXURY_SEATS = 80; // Искомое число свободных мест люкс
+
+  /// @brief Build a fleet of different half-occupied trains with the balanced type mix.
+  /// @param numTrains The number of trains.
+  /// @return The trains.
+  std::vector<Train> makeFleet(int numTrains) {
+    std::mt19937 rng(static_cast<unsigned>(numTrains));
+    std::vector<Train> fleet(numTrains);
+    for (Train& train : fleet) {
+      for (int i = 0; i < FLEET_TRAIN_WAGONS; i++) {
+        train.addWagon(makeWagon(pickType(MIX_BALANCED, rng), rng));
+      }
+    }
+    return fleet;
+  }
+
+} // namespace
+
+// Поиск поездов со свободными местами люкс перебором всего парка
+static void BM_FleetScanForFreeSeats(benchmark::State& state) {
+  std::vector<Train> fleet = makeFleet(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    std::vector<int> found;
+    for (int id = 0; id < static_cast<int>(fleet.size()); id++) {
+      int occupied, capacity;
+      fleet[id].getPassengerCountByType(WagonType::LUXURY, occupied, capacity);
+      if (capacity - occupied >= WANTED_LUXURY_SEATS) {
+        found.push_back(id);
+      }
+    }
+    benchmark::DoNotOptimize(found.data());
+  }
+}
+BENCHMARK(BM_FleetScanForFreeSeats)->ArgName("trains")->Arg(1000)->Arg(10000)->Arg(100000);
+
+// Тот же поиск по упорядоченному индексу парка
+static void BM_FleetIndexForFreeSeats(benchmark::State& state) {
+  FleetAvailabilityIndex index;
+  for (Train& train : makeFleet(static_cast<int>(state.range(0)))) {
+    index.addTrain(std::move(train));
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(index.findTrainsWithFreeSeats(WagonType::LUXURY, WANTED_LUXURY_SEATS).data());
+  }
+}
+BENCHMARK(BM_FleetIndexForFreeSeats)->ArgName("trains")->Arg(1000)->Arg(10000)->Arg(100000);
+
+// Посадка через индекс: цена поддержания ключей при каждом изменении
+static void BM_FleetIndexBoarding(benchmark::State& state) {
+  FleetAvailabilityIndex index;
+  for (Train& train : makeFleet(static_cast<int>(state.range(0)))) {
+    index.addTrain(std::move(train));
+  }
+  int id = 0;
+  for (auto _ : state) {
+    index.modifyTrain(id, [](Train& train) {
+      Wagon& wagon = train[0];
+      if (wagon.getMaxCapacity() > 0) {
+        wagon.setOccupiedSeats(wagon.getMaxCapacity() - wagon.getOccupiedSeats());
+      }
+    });
+    id = (id + 1) % index.getTrainCount();
+  }
+}
+BENCHMARK(BM_FleetIndexBoarding)->ArgName("trains")->Arg(1000)->Arg(10000)->Arg(100000);
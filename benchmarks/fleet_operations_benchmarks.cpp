@@ -0,0 +1,61 @@
+#include <vector>
+#include "../myLib/fleet_operations.h"
+#include "fixtures.h"
+
+using namespace benchFixtures;
+
+namespace {
+
+  constexpr int BATCH_FLEET_SIZE = 512; // Поездов в ночном пакете
+
+  /// @brief Build a fleet with wildly uneven train sizes: most trains are short, a few are very long.
+  /// @return The trains.
+  std::vector<Train> makeUnevenFleet() {
+    std::mt19937 rng(2024);
+    std::vector<Train> fleet(BATCH_FLEET_SIZE);
+    for (Train& train : fleet) {
+      int size = 4 << (rng() % 4 == 0 ? rng() % 11 : rng() % 3);
+      for (int i = 0; i < size; i++) {
+        train.addWagon(makeWagon(pickType(MIX_BALANCED, rng), rng));
+      }
+    }
+    return fleet;
+  }
+
+  /// @brief The nightly batch.
+  constexpr FleetOperation NIGHTLY_BATCH[] = {FleetOperation::REDISTRIBUTE_PASSENGERS, FleetOperation::OPTIMIZE_TRAIN,
+                                              FleetOperation::OPTIMIZE_RESTAURANT_PLACEMENT};
+
+} // namespace
+
+// Ночной пакет операций над неоднородным парком; масштабирование по числу потоков
+static void BM_FleetNightlyBatch(benchmark::State& state) {
+  const std::vector<Train> fleet = makeUnevenFleet();
+  ThreadPool pool(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<Train> work = fleet;
+    state.ResumeTiming();
+    runFleetOperations(work, NIGHTLY_BATCH, pool);
+    benchmark::DoNotOptimize(work.data());
+  }
+  state.counters["steals"] = static_cast<double>(pool.getStealCount()) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_FleetNightlyBatch)->ArgName("threads")->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+
+// Тот же пакет последовательным циклом без пула
+static void BM_FleetNightlyBatchSequential(benchmark::State& state) {
+  const std::vector<Train> fleet = makeUnevenFleet();
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<Train> work = fleet;
+    state.ResumeTiming();
+    for (Train& train : work) {
+      for (FleetOperation operation : NIGHTLY_BATCH) {
+        applyFleetOperation(train, operation);
+      }
+    }
+    benchmark::DoNotOptimize(work.data());
+  }
+}
+BENCHMARK(BM_FleetNightlyBatchSequential)->UseRealTime();
@@ -0,0 +1,71 @@
+#include <random>
+#include <vector>
+#include "../myLib/demand_forecast.h"
+#include "fixtures.h"
+
+using namespace benchFixtures;
+
+namespace {
+
+  constexpr int FORECAST_SCENARIOS = 10'000; // Сценариев в одном прогнозе
+
+  /// @brief Build a 16-wagon consist with the balanced mix and the demand that roughly fills it.
+  /// @param model The demand to fill in.
+  /// @return The consist.
+  Train makeForecastConsist(DemandModel& model) {
+    Train consist = makeTrain(16, MIX_BALANCED);
+    for (const Wagon& wagon : consist.view()) {
+      if (wagonTypeTraits(wagon.getType()).canBoard) {
+        model.meanGroups[static_cast<int>(wagon.getType())] += (wagon.getMaxCapacity() - wagon.getOccupiedSeats()) / 2.5;
+      }
+    }
+    model.numScenarios = FORECAST_SCENARIOS;
+    return consist;
+  }
+
+} // namespace
+
+// Прогноз спроса на пуле: рабочие буферы и потоковые накопители; масштабирование по числу потоков
+static void BM_ForecastDemand(benchmark::State& state) {
+  DemandModel model;
+  const Train consist = makeForecastConsist(model);
+  ThreadPool pool(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    DemandForecast forecast = forecastDemand(consist, model, pool);
+    benchmark::DoNotOptimize(forecast.scenarios);
+  }
+  state.SetItemsProcessed(state.iterations() * FORECAST_SCENARIOS);
+}
+BENCHMARK(BM_ForecastDemand)->ArgName("threads")->RangeMultiplier(2)->Range(1, 8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Прежний подход: копия поезда и генератор на каждый сценарий, итоги хранятся до конца прогона
+static void BM_ForecastDemandCopyPerScenario(benchmark::State& state) {
+  DemandModel model;
+  const Train consist = makeForecastConsist(model);
+  for (auto _ : state) {
+    std::vector<std::vector<int>> occupancy(WAGON_TYPE_COUNT);
+    int64_t rejected = 0;
+    for (int scenario = 0; scenario < FORECAST_SCENARIOS; scenario++) {
+      Train train = consist;
+      std::mt19937 rng(static_cast<unsigned>(scenario));
+      for (int type = 0; type < WAGON_TYPE_COUNT; type++) {
+        int groups = std::poisson_distribution<int>(model.meanGroups[type] > 0 ? model.meanGroups[type] : 1)(rng);
+        for (int group = 0; model.meanGroups[type] > 0 && group < groups; group++) {
+          try {
+            train.boardPassengersToMostAvailableWagon(1 + static_cast<int>(rng() % model.maxGroupSize), static_cast<WagonType>(type));
+          } catch (const std::invalid_argument&) {
+            rejected++;
+          }
+        }
+        int occupied = 0;
+        int seats = 0;
+        train.getPassengerCountByType(static_cast<WagonType>(type), occupied, seats);
+        occupancy[type].push_back(seats == 0 ? 0 : occupied * 100 / seats);
+      }
+    }
+    benchmark::DoNotOptimize(rejected);
+    benchmark::DoNotOptimize(occupancy.data());
+  }
+  state.SetItemsProcessed(state.iterations() * FORECAST_SCENARIOS);
+}
+BENCHMARK(BM_ForecastDemandCopyPerScenario)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,105 @@
+#include <queue>
+#include <random>
+#include <vector>
+#include "../myLib/train_holds.h"
+#include "fixtures.h"
+
+using namespace benchFixtures;
+
+namespace {
+
+  constexpr int HOLD_WAGONS = 8; // Вагонов в поезде для удержаний
+
+  /// @brief Build an economy train roomy enough for every pending hold.
+  /// @return The train.
+  Train makeHoldTrain() {
+    Train train;
+    for (int i = 0; i < HOLD_WAGONS; i++) {
+      train.addWagon(Wagon(1'000'000, 0, WagonType::ECONOMY));
+    }
+    return train;
+  }
+
+  /// @brief A hold tracked by an external timer heap, the way holds were made before TrainHolds.
+  struct HeapHold {
+    int64_t expiry;  // Время истечения
+    int id;          // Номер удержания
+    int wagon;       // Индекс вагона
+    int passengers;  // Число мест
+
+    bool operator>(const HeapHold& other) const { return expiry > other.expiry; }
+  };
+
+} // namespace
+
+// Поток удержаний с истечением на колесе таймеров: за миллисекунду одно новое удержание,
+// половина удержаний отменяется до истечения; аргумент - среднее время удержания
+static void BM_TrainHoldsChurn(benchmark::State& state) {
+  const int64_t meanTtl = state.range(0);
+  std::mt19937_64 rng(50);
+  TrainHolds holds(makeHoldTrain());
+  std::vector<HoldId> recent(64, ~HoldId{0});
+  int64_t now = 0;
+  auto step = [&] {
+    holds.advanceTo(++now);
+    HoldId id = holds.hold(1 + static_cast<int>(rng() % 4), WagonType::ECONOMY, 1 + static_cast<int64_t>(rng() % (2 * meanTtl)));
+    HoldId& slot = recent[now % recent.size()];
+    if (rng() % 2 == 0) {
+      holds.release(slot);
+    }
+    slot = id;
+  };
+  // Разгон до установившегося числа удержаний
+  for (int64_t i = 0; i < 2 * meanTtl; i++) {
+    step();
+  }
+  for (auto _ : state) {
+    step();
+  }
+  state.counters["pending"] = static_cast<double>(holds.getActiveHoldCount());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TrainHoldsChurn)->ArgName("ttl")->RangeMultiplier(10)->Range(1'000, 1'000'000);
+
+// Тот же поток: посадка и внешняя куча таймеров с ленивой отменой, каждое истечение высаживает отдельно
+static void BM_TimerHeapHoldsChurn(benchmark::State& state) {
+  const int64_t meanTtl = state.range(0);
+  std::mt19937_64 rng(50);
+  Train train = makeHoldTrain();
+  std::priority_queue<HeapHold, std::vector<HeapHold>, std::greater<>> timers;
+  std::vector<bool> cancelled;
+  std::vector<HeapHold> recent(64, HeapHold{0, -1, 0, 0});
+  int64_t now = 0;
+  auto step = [&] {
+    now++;
+    while (!timers.empty() && timers.top().expiry <= now) {
+      const HeapHold& top = timers.top();
+      if (!cancelled[top.id]) {
+        cancelled[top.id] = true;
+        train[top.wagon].disembarkPassengers(top.passengers);
+      }
+      timers.pop();
+    }
+    int passengers = 1 + static_cast<int>(rng() % 4);
+    int64_t expiry = now + 1 + static_cast<int64_t>(rng() % (2 * meanTtl));
+    int wagon = train.boardPassengersToMostAvailableWagon(passengers, WagonType::ECONOMY);
+    HeapHold hold{expiry, static_cast<int>(cancelled.size()), wagon, passengers};
+    cancelled.push_back(false);
+    timers.push(hold);
+    HeapHold& slot = recent[now % recent.size()];
+    if (rng() % 2 == 0 && slot.id >= 0 && !cancelled[slot.id]) {
+      cancelled[slot.id] = true;
+      train[slot.wagon].disembarkPassengers(slot.passengers);
+    }
+    slot = hold;
+  };
+  for (int64_t i = 0; i < 2 * meanTtl; i++) {
+    step();
+  }
+  for (auto _ : state) {
+    step();
+  }
+  state.counters["queued"] = static_cast<double>(timers.size());
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimerHeapHoldsChurn)->ArgName("ttl")->RangeMultiplier(10)->Range(1'000, 1'000'000);
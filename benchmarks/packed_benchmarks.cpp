@@ -0,0 +1,41 @@
+#include "../myLib/packed_train.h"
+#include "fixtures.h"
+
+using namespace benchFixtures;
+
+namespace {
+
+  /// @brief Register fleet-scale sizes, from L1-resident to well beyond the last-level cache.
+  /// @param bench The benchmark to parameterize.
+  void scanSizes(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("wagons");
+    for (int size = 4096; size <= (1 << 22); size *= 16) {
+      bench->Arg(size);
+    }
+  }
+
+} // namespace
+
+// Подсчет пассажиров одного класса по обычному поезду (12 байт на вагон)
+static void BM_ScanTrain(benchmark::State& state) {
+  Train train = makeTrain(static_cast<int>(state.range(0)), MIX_BALANCED);
+  for (auto _ : state) {
+    int occupied, capacity;
+    train.getPassengerCountByType(WagonType::ECONOMY, occupied, capacity);
+    benchmark::DoNotOptimize(occupied + capacity);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(Wagon)));
+}
+BENCHMARK(BM_ScanTrain)->Apply(scanSizes);
+
+// Тот же подсчет по упакованному поезду (4 байта на вагон)
+static void BM_ScanPackedTrain(benchmark::State& state) {
+  PackedTrain train(makeTrain(static_cast<int>(state.range(0)), MIX_BALANCED).view());
+  for (auto _ : state) {
+    int occupied, capacity;
+    train.getPassengerCountByType(WagonType::ECONOMY, occupied, capacity);
+    benchmark::DoNotOptimize(occupied + capacity);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(PackedWagon)));
+}
+BENCHMARK(BM_ScanPackedTrain)->Apply(scanSizes);
@@ -0,0 +1,62 @@
+#include <vector>
+#include "../myLib/persistent_train.h"
+#include "fixtures.h"
+
+using namespace benchFixtures;
+
+namespace {
+
+  constexpr int AUDITED_OPERATIONS = 64; // Операций в одном журнале
+
+  /// @brief Index of the wagon changed by the i-th audited operation, spread over the train.
+  /// @param operation The number of the operation.
+  /// @param numWagons The number of wagons.
+  /// @return The index of the wagon.
+  int auditedIndex(int operation, int numWagons) { return static_cast<int>((operation * 2654435761u) % numWagons); }
+
+} // namespace
+
+// Журнал из полных копий поезда после каждой операции
+static void BM_AuditTrainCopies(benchmark::State& state) {
+  const Train base = makeTrain(static_cast<int>(state.range(0)), MIX_BALANCED);
+  for (auto _ : state) {
+    std::vector<Train> history{base};
+    for (int i = 0; i < AUDITED_OPERATIONS; i++) {
+      Train next = history.back();
+      next[auditedIndex(i, next.getNumWagons())] = Wagon(WagonType::ECONOMY);
+      history.push_back(std::move(next));
+    }
+    benchmark::DoNotOptimize(history.data());
+  }
+}
+BENCHMARK(BM_AuditTrainCopies)->ArgName("wagons")->Arg(256)->Arg(4096)->Arg(65536);
+
+// Тот же журнал из неизменяемых версий с общей структурой
+static void BM_AuditPersistentTrain(benchmark::State& state) {
+  const PersistentTrain base(makeTrain(static_cast<int>(state.range(0)), MIX_BALANCED));
+  for (auto _ : state) {
+    TrainHistory history(base);
+    for (int i = 0; i < AUDITED_OPERATIONS; i++) {
+      const PersistentTrain& last = history.current();
+      history.commit(last.setWagon(auditedIndex(i, last.getNumWagons()), Wagon(WagonType::ECONOMY)));
+    }
+    benchmark::DoNotOptimize(history.getVersionCount());
+  }
+}
+BENCHMARK(BM_AuditPersistentTrain)->ArgName("wagons")->Arg(256)->Arg(4096)->Arg(65536);
+
+// Чтение вагона из случайной исторической версии
+static void BM_PersistentHistoricalRead(benchmark::State& state) {
+  const int numWagons = static_cast<int>(state.range(0));
+  TrainHistory history{PersistentTrain(makeTrain(numWagons, MIX_BALANCED))};
+  for (int i = 0; i < AUDITED_OPERATIONS; i++) {
+    history.commit(history.current().boardPassengersToMostAvailableWagon(1, WagonType::ECONOMY));
+  }
+  int i = 0;
+  for (auto _ : state) {
+    const PersistentTrain& version = history.at(i % history.getVersionCount());
+    benchmark::DoNotOptimize(version.getWagonByIndex(auditedIndex(i, numWagons)).getOccupiedSeats());
+    i++;
+  }
+}
+BENCHMARK(BM_PersistentHistoricalRead)->ArgName("wagons")->Arg(256)->Arg(4096)->Arg(65536);
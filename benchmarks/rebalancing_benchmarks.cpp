@@ -0,0 +1,45 @@
+#include <vector>
+#include "../myLib/rebalancing.h"
+#include "fixtures.h"
+
+using namespace benchFixtures;
+
+namespace {
+
+  /// @brief Build a corridor of trains with the economy-heavy mix and uneven occupancy.
+  /// @param numTrains The number of trains.
+  /// @return The trains in corridor order.
+  std::vector<Train> makeCorridor(int numTrains) {
+    std::mt19937 rng(static_cast<unsigned>(numTrains));
+    std::vector<Train> corridor(numTrains);
+    for (Train& train : corridor) {
+      for (int i = 0; i < 8; i++) {
+        Wagon wagon(pickType(MIX_ECONOMY_HEAVY, rng));
+        if (wagon.getMaxCapacity() > 0) {
+          wagon.setOccupiedSeats(static_cast<int>(rng() % (wagon.getMaxCapacity() + 1)));
+        }
+        train.addWagon(wagon);
+      }
+    }
+    return corridor;
+  }
+
+} // namespace
+
+// Выравнивание загрузки поездов коридора
+static void BM_PlanRebalancingBalance(benchmark::State& state) {
+  const std::vector<Train> corridor = makeCorridor(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(planRebalancing(corridor, RebalanceGoal::BALANCE).totalCost);
+  }
+}
+BENCHMARK(BM_PlanRebalancingBalance)->ArgName("trains")->Arg(100)->Arg(1000)->Arg(5000)->Unit(benchmark::kMillisecond);
+
+// Освобождение поездов коридора пересадкой пассажиров в остальные
+static void BM_PlanRebalancingConsolidate(benchmark::State& state) {
+  const std::vector<Train> corridor = makeCorridor(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(planRebalancing(corridor, RebalanceGoal::CONSOLIDATE).totalCost);
+  }
+}
+BENCHMARK(BM_PlanRebalancingConsolidate)->ArgName("trains")->Arg(100)->Arg(1000)->Arg(5000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,90 @@
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "../myLib/replay.h"
+
+using namespace lab2ComplexClass;
+
+namespace {
+
+  /// @brief Print the command line usage.
+  /// @param program The program name.
+  void printUsage(const char* program) {
+    std::cerr << "usage: " << program << " TRACE [--repeat N] [--dump-state FILE] [--reference FILE]" << std::endl;
+  }
+
+} // namespace
+
+// Воспроизведение записанного потока операций над поездом с замером задержек
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    printUsage(argv[0]);
+    return 2;
+  }
+
+  const char* tracePath = argv[1];
+  const char* dumpPath = nullptr;
+  const char* referencePath = nullptr;
+  int repeat = 1;
+
+  for (int i = 2; i < argc; i++) {
+    if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+      char* end = nullptr;
+      long value = std::strtol(argv[++i], &end, 10);
+      if (*end != '\0' || end == argv[i] || value <= 0 || value > INT_MAX) {
+        printUsage(argv[0]);
+        return 2;
+      }
+      repeat = static_cast<int>(value);
+    } else if (std::strcmp(argv[i], "--dump-state") == 0 && i + 1 < argc) {
+      dumpPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--reference") == 0 && i + 1 < argc) {
+      referencePath = argv[++i];
+    } else {
+      printUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  std::ifstream traceFile(tracePath);
+  Trace trace;
+  if (!(traceFile >> trace)) {
+    std::cerr << "Failed to read trace: " << tracePath << std::endl;
+    return 2;
+  }
+
+  Train train;
+  for (int run = 0; run < repeat; run++) {
+    ReplayReport report = replayTrace(trace, train);
+    std::cout << "run " << run + 1 << " of " << repeat << std::endl << report;
+  }
+
+  // The final state is written in the same format the trace uses for the initial train
+  if (dumpPath != nullptr) {
+    std::ofstream dumpFile(dumpPath);
+    dumpFile << train.getNumWagons() << '\n';
+    for (int i = 0; i < train.getNumWagons(); i++) {
+      writeWagonRecord(dumpFile, train.getWagonByIndex(i));
+    }
+  }
+
+  if (referencePath != nullptr) {
+    std::ifstream referenceFile(referencePath);
+    Train reference;
+    referenceFile >> reference;
+    if (referenceFile.fail()) {
+      std::cerr << "Failed to read reference state: " << referencePath << std::endl;
+      return 2;
+    }
+    int difference = findFirstDifference(train, reference);
+    if (difference >= 0) {
+      std::cout << "final state differs from reference at wagon " << difference << std::endl;
+      return 1;
+    }
+    std::cout << "final state matches reference" << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "../myLib/route_reservations.h"
+#include "fixtures.h"
+
+using namespace benchFixtures;
+
+namespace {
+
+  constexpr int ROUTE_WAGONS = 32; // Вагонов в поезде маршрута
+
+  /// @brief A random journey of one or two passengers.
+  struct Journey {
+    int passengers;
+    int from;
+    int to;
+  };
+
+  /// @brief Random journeys over a route.
+  /// @param numStops The number of stops.
+  /// @param count The number of journeys.
+  /// @return The journeys.
+  std::vector<Journey> makeJourneys(int numStops, int count) {
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<int> stop(0, numStops - 1);
+    std::vector<Journey> journeys(count);
+    for (Journey& journey : journeys) {
+      int a = stop(generator);
+      int b = stop(generator);
+      journey = {1 + (a & 1), std::min(a, b), std::max(a, b) + (a == b)};
+      if (journey.to >= numStops) {
+        journey.from--;
+        journey.to--;
+      }
+    }
+    return journeys;
+  }
+
+} // namespace
+
+// Бронирование с перебором остановок в каждом вагоне
+static void BM_BookPerStopScan(benchmark::State& state) {
+  const int numStops = static_cast<int>(state.range(0));
+  const std::vector<Journey> journeys = makeJourneys(numStops, 256);
+  for (auto _ : state) {
+    std::vector<std::vector<int>> occupancy(ROUTE_WAGONS, std::vector<int>(numStops - 1, 0));
+    int booked = 0;
+    for (const Journey& journey : journeys) {
+      int best = -1;
+      int bestPeak = 0;
+      for (int wagon = 0; wagon < ROUTE_WAGONS; wagon++) {
+        int peak = *std::max_element(occupancy[wagon].begin() + journey.from, occupancy[wagon].begin() + journey.to);
+        if (50 - peak >= journey.passengers && (best < 0 || peak > bestPeak)) {
+          best = wagon;
+          bestPeak = peak;
+        }
+      }
+      if (best >= 0) {
+        for (int segment = journey.from; segment < journey.to; segment++) {
+          occupancy[best][segment] += journey.passengers;
+        }
+        booked++;
+      }
+    }
+    benchmark::DoNotOptimize(booked);
+  }
+}
+BENCHMARK(BM_BookPerStopScan)->ArgName("stops")->Arg(16)->Arg(256)->Arg(4096);
+
+// То же бронирование на деревьях отрезков
+static void BM_BookSegmentTree(benchmark::State& state) {
+  const int numStops = static_cast<int>(state.range(0));
+  const std::vector<Journey> journeys = makeJourneys(numStops, 256);
+  Train train;
+  for (int wagon = 0; wagon < ROUTE_WAGONS; wagon++) {
+    train.addWagon(Wagon(WagonType::ECONOMY));
+  }
+  for (auto _ : state) {
+    RouteReservations reservations(train, numStops);
+    int booked = 0;
+    for (const Journey& journey : journeys) {
+      int best = reservations.findMostAvailableWagon(journey.passengers, WagonType::ECONOMY, journey.from, journey.to);
+      if (best >= 0) {
+        reservations.book(best, journey.passengers, journey.from, journey.to);
+        booked++;
+      }
+    }
+    benchmark::DoNotOptimize(booked);
+  }
+}
+BENCHMARK(BM_BookSegmentTree)->ArgName("stops")->Arg(16)->Arg(256)->Arg(4096);
@@ -0,0 +1,85 @@
+#include <random>
+#include <vector>
+#include "../myLib/seat_map.h"
+#include "fixtures.h"
+
+using namespace benchFixtures;
+
+namespace {
+
+  /// @brief Occupancy of a fragmented wagon: every seat is taken with probability 0.7.
+  /// @param numSeats The number of seats.
+  /// @return The occupancy of each seat.
+  std::vector<bool> fragmentedSeats(int numSeats) {
+    std::mt19937 generator(7);
+    std::bernoulli_distribution taken(0.7);
+    std::vector<bool> occupied(numSeats);
+    for (int seat = 0; seat < numSeats; seat++) {
+      occupied[seat] = taken(generator);
+    }
+    return occupied;
+  }
+
+  /// @brief Seat-by-seat search for a block of adjacent free seats, as a separate per-seat map would do it.
+  /// @param occupied The occupancy of each seat.
+  /// @param count The number of seats in the block.
+  /// @return The first seat of the block, or -1 if there is none.
+  int findAdjacentSeatBySeat(const std::vector<bool>& occupied, int count) {
+    int runLength = 0;
+    for (int seat = 0; seat < static_cast<int>(occupied.size()); seat++) {
+      runLength = occupied[seat] ? 0 : runLength + 1;
+      if (runLength == count) {
+        return seat - count + 1;
+      }
+    }
+    return -1;
+  }
+
+} // namespace
+
+// Поиск группы соседних мест перебором по одному месту
+static void BM_AdjacentSeatsSeatBySeat(benchmark::State& state) {
+  const std::vector<bool> occupied = fragmentedSeats(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(findAdjacentSeatBySeat(occupied, 8));
+  }
+}
+BENCHMARK(BM_AdjacentSeatsSeatBySeat)->ArgName("seats")->Arg(100)->Arg(1024)->Arg(16384);
+
+// Тот же поиск по 64-битным словам карты мест
+static void BM_AdjacentSeatsSeatMap(benchmark::State& state) {
+  const std::vector<bool> occupied = fragmentedSeats(static_cast<int>(state.range(0)));
+  SeatMap seats(static_cast<int>(occupied.size()));
+  for (int seat = 0; seat < seats.getNumSeats(); seat++) {
+    if (occupied[seat]) {
+      seats.occupy(seat);
+    }
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(seats.findAdjacentFreeSeats(8));
+  }
+}
+BENCHMARK(BM_AdjacentSeatsSeatMap)->ArgName("seats")->Arg(100)->Arg(1024)->Arg(16384);
+
+// Посадка в вагон только со счётчиком мест
+static void BM_BoardCountOnly(benchmark::State& state) {
+  for (auto _ : state) {
+    Wagon wagon(WagonType::SITTING);
+    for (int i = 0; i < 25; i++) {
+      wagon.boardPassengers(4);
+    }
+    benchmark::DoNotOptimize(wagon);
+  }
+}
+BENCHMARK(BM_BoardCountOnly);
+
+// Та же посадка с назначением конкретных мест
+static void BM_BoardWithSeats(benchmark::State& state) {
+  for (auto _ : state) {
+    SeatedWagon wagon(WagonType::SITTING);
+    for (int i = 0; i < 25; i++) {
+      benchmark::DoNotOptimize(wagon.boardPassengersWithSeats(4).data());
+    }
+  }
+}
+BENCHMARK(BM_BoardWithSeats);
@@ -0,0 +1,86 @@
+#include <queue>
+#include <random>
+#include <vector>
+#include "../myLib/simulation.h"
+#include "fixtures.h"
+
+using namespace benchFixtures;
+
+namespace {
+
+  constexpr int SIMULATED_FLEET_SIZE = 256; // Поездов в нагрузочном прогоне
+
+  /// @brief Build a fleet of 12-wagon trains with the balanced mix.
+  /// @return The trains.
+  std::vector<Train> makeSimulatedFleet() {
+    std::mt19937 rng(48);
+    std::vector<Train> fleet(SIMULATED_FLEET_SIZE);
+    for (Train& train : fleet) {
+      for (int i = 0; i < 12; i++) {
+        train.addWagon(makeWagon(pickType(MIX_BALANCED, rng), rng));
+      }
+    }
+    return fleet;
+  }
+
+  /// @brief Fill a queue with the given number of events for the hold benchmarks.
+  /// @param size The number of events.
+  /// @param rng The generator.
+  /// @return The events.
+  std::vector<SimulationEvent> makeHoldEvents(int size, std::mt19937_64& rng) {
+    std::vector<SimulationEvent> events(size);
+    for (int i = 0; i < size; i++) {
+      events[i] = {static_cast<int64_t>(rng() % 1'000'000), i, SimulationEventType::PASSENGER_ARRIVAL, 0};
+    }
+    return events;
+  }
+
+} // namespace
+
+// Сутки работы парка: события в секунду; масштабирование по числу потоков
+static void BM_SimulateFleetDay(benchmark::State& state) {
+  const std::vector<Train> fleet = makeSimulatedFleet();
+  SimulationConfig config;
+  config.meanGroupInterval = 30'000;
+  ThreadPool pool(static_cast<int>(state.range(0)));
+  int64_t events = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<Train> work = fleet;
+    state.ResumeTiming();
+    events += runSimulation(work, config, pool).events;
+  }
+  state.SetItemsProcessed(events);
+}
+BENCHMARK(BM_SimulateFleetDay)->ArgName("threads")->RangeMultiplier(2)->Range(1, 8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Модель "hold": извлечь минимум и вставить событие позже; календарная очередь
+static void BM_EventQueueHold(benchmark::State& state) {
+  std::mt19937_64 rng(1);
+  EventQueue queue;
+  for (const SimulationEvent& event : makeHoldEvents(static_cast<int>(state.range(0)), rng)) {
+    queue.push(event);
+  }
+  for (auto _ : state) {
+    SimulationEvent event = queue.pop();
+    event.time += static_cast<int64_t>(rng() % 1'000'000);
+    queue.push(event);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EventQueueHold)->ArgName("queued")->RangeMultiplier(100)->Range(100, 1'000'000);
+
+// Та же модель на std::priority_queue для сравнения
+static void BM_PriorityQueueHold(benchmark::State& state) {
+  std::mt19937_64 rng(1);
+  std::vector<SimulationEvent> events = makeHoldEvents(static_cast<int>(state.range(0)), rng);
+  std::priority_queue<SimulationEvent, std::vector<SimulationEvent>, std::greater<>> queue(std::greater<>(), std::move(events));
+  for (auto _ : state) {
+    SimulationEvent event = queue.top();
+    queue.pop();
+    event.time += static_cast<int64_t>(rng() % 1'000'000);
+    queue.push(event);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PriorityQueueHold)->ArgName("queued")->RangeMultiplier(100)->Range(100, 1'000'000);
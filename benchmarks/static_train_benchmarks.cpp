@@ -0,0 +1,107 @@
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include "../myLib/packed_wagon.h"
+#include "../myLib/static_train.h"
+#include "fixtures.h"
+
+using namespace benchFixtures;
+
+namespace {
+
+  /// @brief Fill a consist with the regional unit pattern: alternating sitting and economy wagons, luxury wagon last.
+  /// @tparam Consist Train, StaticTrain or another BasicTrain.
+  /// @param consist The consist to fill.
+  /// @param size The number of wagons.
+  template <typename Consist>
+  void fillRegionalUnit(Consist& consist, int size) {
+    for (int i = 0; i < size; i++) {
+      WagonType type = i == size - 1 ? WagonType::LUXURY : (i % 2 == 0 ? WagonType::SITTING : WagonType::ECONOMY);
+      consist.addWagon(typename Consist::value_type(Wagon(80, (i * 7) % 40, type)));
+    }
+  }
+
+  /// @brief One planning cycle: build the consist, board, redistribute, optimize and place the restaurant.
+  /// @tparam Consist Train, StaticTrain or another BasicTrain.
+  /// @param size The number of wagons.
+  /// @param storage The storage of the consist, if it takes one.
+  /// @return The number of wagons after the cycle.
+  template <typename Consist, typename... StorageArgs>
+  int planningCycle(int size, StorageArgs... storage) {
+    Consist consist(storage...);
+    fillRegionalUnit(consist, size - 1);
+    consist.boardPassengersToMostAvailableWagon(10, WagonType::SITTING);
+    consist.boardPassengersToMostAvailableWagon(5, WagonType::ECONOMY);
+    consist.redistributePassengers();
+    consist.optimizeTrain();
+    consist.optimizeRestaurantPlacement();
+    return consist.getNumWagons();
+  }
+
+} // namespace
+
+// Цикл планирования на поезде с вагонами в куче
+static void BM_TrainPlanningCycle(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(planningCycle<Train>(size));
+  }
+}
+BENCHMARK(BM_TrainPlanningCycle)->ArgName("wagons")->Arg(4)->Arg(8)->Arg(16);
+
+// Тот же цикл на поезде фиксированной емкости без выделения памяти
+template <int N>
+static void BM_StaticTrainPlanningCycle(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(planningCycle<StaticTrain<N>>(N));
+  }
+}
+BENCHMARK_TEMPLATE(BM_StaticTrainPlanningCycle, 4);
+BENCHMARK_TEMPLATE(BM_StaticTrainPlanningCycle, 8);
+BENCHMARK_TEMPLATE(BM_StaticTrainPlanningCycle, 16);
+
+// Тот же цикл на поезде со встроенным буфером на 16 вагонов
+static void BM_SmallBufferTrainPlanningCycle(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(planningCycle<BasicTrain<Wagon, SmallBufferStorage<16>>>(size));
+  }
+}
+BENCHMARK(BM_SmallBufferTrainPlanningCycle)->ArgName("wagons")->Arg(4)->Arg(8)->Arg(16);
+
+// Тот же цикл на упакованных вагонах, массивы которых берутся из арены на стеке
+static void BM_PackedArenaTrainPlanningCycle(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  std::array<std::byte, 4096> buffer;
+  for (auto _ : state) {
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+    benchmark::DoNotOptimize(planningCycle<BasicTrain<PackedWagon, ArenaStorage>>(size, &arena));
+  }
+}
+BENCHMARK(BM_PackedArenaTrainPlanningCycle)->ArgName("wagons")->Arg(4)->Arg(8)->Arg(16);
+
+// Подсчет пассажиров по классу: цикл по N слотам против цикла по числу вагонов
+static void BM_TrainPassengerCount(benchmark::State& state) {
+  Train train;
+  fillRegionalUnit(train, static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    int occupied, capacity;
+    train.getPassengerCountByType(WagonType::ECONOMY, occupied, capacity);
+    benchmark::DoNotOptimize(occupied + capacity);
+  }
+}
+BENCHMARK(BM_TrainPassengerCount)->ArgName("wagons")->Arg(4)->Arg(8)->Arg(16);
+
+template <int N>
+static void BM_StaticTrainPassengerCount(benchmark::State& state) {
+  StaticTrain<N> train;
+  fillRegionalUnit(train, N);
+  for (auto _ : state) {
+    int occupied, capacity;
+    train.getPassengerCountByType(WagonType::ECONOMY, occupied, capacity);
+    benchmark::DoNotOptimize(occupied + capacity);
+  }
+}
+BENCHMARK_TEMPLATE(BM_StaticTrainPassengerCount, 4);
+BENCHMARK_TEMPLATE(BM_StaticTrainPassengerCount, 8);
+BENCHMARK_TEMPLATE(BM_StaticTrainPassengerCount, 16);
@@ -0,0 +1,275 @@
+#include <numeric>
+#include <span>
+#include <sstream>
+#include "fixtures.h"
+
+using namespace benchFixtures;
+
+// Построение поезда вагон за вагоном через addWagon
+static void BM_AddWagon(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  std::mt19937 rng(42);
+  Wagon wagon = makeWagon(pickType(static_cast<int>(state.range(1)), rng), rng);
+  for (auto _ : state) {
+    Train train;
+    for (int i = 0; i < size; i++) {
+      train.addWagon(wagon);
+    }
+    benchmark::DoNotOptimize(train.getWagons());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+  state.SetLabel(mixLabel(static_cast<int>(state.range(1))));
+}
+BENCHMARK(BM_AddWagon)->Apply(sizeAndMix);
+
+// Построение поезда из готовой последовательности вагонов одной операцией
+static void BM_AppendSpan(benchmark::State& state) {
+  Train source = makeTrain(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  std::span<const Wagon> feed(source.getWagons(), source.getNumWagons());
+  for (auto _ : state) {
+    Train train;
+    train.append(feed);
+    benchmark::DoNotOptimize(train.getWagons());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetLabel(mixLabel(static_cast<int>(state.range(1))));
+}
+BENCHMARK(BM_AppendSpan)->Apply(sizeAndMix);
+
+// Построение поезда вагон за вагоном через emplaceWagon
+static void BM_EmplaceWagon(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    Train train;
+    for (int i = 0; i < size; i++) {
+      train.emplaceWagon(60, 30, WagonType::ECONOMY);
+    }
+    benchmark::DoNotOptimize(train.getWagons());
+  }
+  state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_EmplaceWagon)->ArgName("wagons")->RangeMultiplier(8)->Range(8, 4096);
+
+// Вставка вагона в середину поезда
+static void BM_AddWagonAtIndex(benchmark::State& state) {
+  Train base = makeTrain(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  Wagon wagon(WagonType::ECONOMY);
+  for (auto _ : state) {
+    state.PauseTiming();
+    Train train(base);
+    state.ResumeTiming();
+    train.addWagonAtIndex(wagon, train.getNumWagons() / 2);
+    benchmark::DoNotOptimize(train.getWagons());
+  }
+  state.SetLabel(mixLabel(static_cast<int>(state.range(1))));
+}
+BENCHMARK(BM_AddWagonAtIndex)->Apply(sizeAndMix);
+
+// Удаление первого вагона (худший случай сдвига)
+static void BM_RemoveWagonByIndex(benchmark::State& state) {
+  Train base = makeTrain(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    state.PauseTiming();
+    Train train(base);
+    state.ResumeTiming();
+    train.removeWagonByIndex(0);
+    benchmark::DoNotOptimize(train.getWagons());
+  }
+  state.SetLabel(mixLabel(static_cast<int>(state.range(1))));
+}
+BENCHMARK(BM_RemoveWagonByIndex)->Apply(sizeAndMix);
+
+// Посадка одного пассажира в наиболее свободный вагон эконом-класса
+static void BM_BoardPassengersToMostAvailableWagon(benchmark::State& state) {
+  Train base = makeTrain(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  base.addWagon(Wagon(WagonType::ECONOMY));
+  int boardable = 0, occupied = 0, capacity = 0;
+  base.getPassengerCountByType(WagonType::ECONOMY, occupied, capacity);
+  Train train(base);
+  for (auto _ : state) {
+    if (boardable == capacity - occupied) {
+      state.PauseTiming();
+      train = base;
+      boardable = 0;
+      state.ResumeTiming();
+    }
+    train.boardPassengersToMostAvailableWagon(1, WagonType::ECONOMY);
+    boardable++;
+  }
+  state.SetLabel(mixLabel(static_cast<int>(state.range(1))));
+}
+BENCHMARK(BM_BoardPassengersToMostAvailableWagon)->Apply(sizeAndMix);
+
+// Поиск кратчайшей группы соседних вагонов перебором всех начальных вагонов
+static void BM_FindAdjacentWagonsQuadratic(benchmark::State& state) {
+  const Train train = makeTrain(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  const std::span<const Wagon> wagons = train.view();
+  for (auto _ : state) {
+    int bestLength = 0;
+    for (size_t first = 0; first < wagons.size(); first++) {
+      int free = 0;
+      for (size_t last = first; last < wagons.size() && wagons[last].getType() == WagonType::ECONOMY; last++) {
+        free += wagons[last].getMaxCapacity() - wagons[last].getOccupiedSeats();
+        if (free >= 120) {
+          if (bestLength == 0 || static_cast<int>(last - first + 1) < bestLength) {
+            bestLength = static_cast<int>(last - first + 1);
+          }
+          break;
+        }
+      }
+    }
+    benchmark::DoNotOptimize(bestLength);
+  }
+}
+BENCHMARK(BM_FindAdjacentWagonsQuadratic)->Apply(sizeAndMix);
+
+// Тот же поиск скользящим окном по префиксным суммам свободных мест
+static void BM_FindAdjacentWagonsForGroup(benchmark::State& state) {
+  const Train train = makeTrain(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(train.findAdjacentWagonsForGroup(120, WagonType::ECONOMY));
+  }
+}
+BENCHMARK(BM_FindAdjacentWagonsForGroup)->Apply(sizeAndMix);
+
+// Балансировка пассажиров по вагонам (повторный вызов идемпотентен)
+static void BM_RedistributePassengers(benchmark::State& state) {
+  Train train = makeTrain(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    train.redistributePassengers();
+    benchmark::DoNotOptimize(train.getWagons());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetLabel(mixLabel(static_cast<int>(state.range(1))));
+}
+BENCHMARK(BM_RedistributePassengers)->Apply(sizeAndMix);
+
+// Оптимизация поезда (удаляет вагоны, поэтому каждый раз начинаем с копии)
+static void BM_OptimizeTrain(benchmark::State& state) {
+  Train base = makeTrain(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    state.PauseTiming();
+    Train train(base);
+    state.ResumeTiming();
+    train.optimizeTrain();
+    benchmark::DoNotOptimize(train.getWagons());
+  }
+  state.SetLabel(mixLabel(static_cast<int>(state.range(1))));
+}
+BENCHMARK(BM_OptimizeTrain)->Apply(sizeAndMix);
+
+// Размещение вагона-ресторана (добавляет вагон, поэтому каждый раз начинаем с копии)
+static void BM_OptimizeRestaurantPlacement(benchmark::State& state) {
+  Train base = makeTrain(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    state.PauseTiming();
+    Train train(base);
+    state.ResumeTiming();
+    train.optimizeRestaurantPlacement();
+    benchmark::DoNotOptimize(train.getWagons());
+  }
+  state.SetLabel(mixLabel(static_cast<int>(state.range(1))));
+}
+BENCHMARK(BM_OptimizeRestaurantPlacement)->Apply(sizeAndMix);
+
+// Копирующий конструктор
+static void BM_CopyConstruct(benchmark::State& state) {
+  Train base = makeTrain(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    Train copy(base);
+    benchmark::DoNotOptimize(copy.getWagons());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(Wagon)));
+  state.SetLabel(mixLabel(static_cast<int>(state.range(1))));
+}
+BENCHMARK(BM_CopyConstruct)->Apply(sizeAndMix);
+
+// Многократное копирующее присваивание поездов близкого размера в один рабочий поезд
+static void BM_CopyAssignScratch(benchmark::State& state) {
+  int size = static_cast<int>(state.range(0));
+  Train sources[2] = {makeTrain(size, static_cast<int>(state.range(1))),
+                      makeTrain(size - size / 8, static_cast<int>(state.range(1)))};
+  Train scratch;
+  int next = 0;
+  for (auto _ : state) {
+    scratch = sources[next];
+    next ^= 1;
+    benchmark::DoNotOptimize(scratch.getWagons());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<int64_t>(sizeof(Wagon)));
+  state.SetLabel(mixLabel(static_cast<int>(state.range(1))));
+}
+BENCHMARK(BM_CopyAssignScratch)->Apply(sizeAndMix);
+
+// Подсчет пассажиров через проверяемый operator[]
+static void BM_TotalOccupancyIndexed(benchmark::State& state) {
+  const Train train = makeTrain(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    int total = 0;
+    for (int i = 0; i < train.getNumWagons(); i++) {
+      total += train[i].getOccupiedSeats();
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetLabel(mixLabel(static_cast<int>(state.range(1))));
+}
+BENCHMARK(BM_TotalOccupancyIndexed)->Apply(sizeAndMix);
+
+// Подсчет пассажиров по ленивому столбцу занятых мест
+static void BM_TotalOccupancyColumn(benchmark::State& state) {
+  const Train train = makeTrain(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    auto column = train.occupancyColumn();
+    int total = std::reduce(column.begin(), column.end());
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetLabel(mixLabel(static_cast<int>(state.range(1))));
+}
+BENCHMARK(BM_TotalOccupancyColumn)->Apply(sizeAndMix);
+
+// Перемещающие конструктор и присваивание
+static void BM_Move(benchmark::State& state) {
+  Train train = makeTrain(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    Train moved(std::move(train));
+    train = std::move(moved);
+    benchmark::DoNotOptimize(train.getWagons());
+  }
+  state.SetLabel(mixLabel(static_cast<int>(state.range(1))));
+}
+BENCHMARK(BM_Move)->Apply(sizeAndMix);
+
+// Вывод поезда в поток
+static void BM_StreamOutput(benchmark::State& state) {
+  Train train = makeTrain(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    std::ostringstream os;
+    os << train;
+    benchmark::DoNotOptimize(os.str().size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetLabel(mixLabel(static_cast<int>(state.range(1))));
+}
+BENCHMARK(BM_StreamOutput)->Apply(sizeAndMix);
+
+// Ввод поезда из потока
+static void BM_StreamInput(benchmark::State& state) {
+  Train base = makeTrain(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+  std::ostringstream os;
+  os << base.getNumWagons() << '\n';
+  for (int i = 0; i < base.getNumWagons(); i++) {
+    writeWagonRecord(os, base.getWagonByIndex(i));
+  }
+  std::string text = os.str();
+  for (auto _ : state) {
+    std::istringstream is(text);
+    Train train;
+    is >> train;
+    benchmark::DoNotOptimize(train.getWagons());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetLabel(mixLabel(static_cast<int>(state.range(1))));
+}
+BENCHMARK(BM_StreamInput)->Apply(sizeAndMix);
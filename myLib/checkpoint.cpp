@@ -0,0 +1,208 @@
+#include <iostream>
+#include "checkpoint.h"
+
+namespace lab2ComplexClass {
+
+  namespace {
+
+    /**
+     * @brief Grow or shrink a train to the given number of wagons.
+     *
+     * New wagons are default-constructed and are expected to be overwritten by the checkpoint record.
+     *
+     * @param train The train to resize.
+     * @param numWagons The required number of wagons.
+     */
+    void resizeTrain(Train& train, int numWagons) {
+      while (train.getNumWagons() > numWagons) {
+        train.removeWagonByIndex(train.getNumWagons() - 1);
+      }
+      train.reserve(numWagons);
+      while (train.getNumWagons() < numWagons) {
+        train.emplaceWagon();
+      }
+    }
+
+  } // namespace
+
+  /**
+   * @brief Constructor for the CheckpointWriter class.
+   *
+   * @param os The output stream checkpoints are appended to.
+   * @param compactionInterval The number of checkpoints between two full snapshots.
+   * @throws std::invalid_argument if compactionInterval is not positive.
+   */
+  CheckpointWriter::CheckpointWriter(std::ostream& os, int compactionInterval)
+      : os(os), compactionInterval(compactionInterval), checkpointsSinceSnapshot(0) {
+    if (compactionInterval <= 0) {
+      throw std::invalid_argument("Compaction interval must be positive.");
+    }
+  }
+
+  /**
+   * @brief Write the next checkpoint of the fleet.
+   *
+   * The writer falls back to a full snapshot when no snapshot was written yet, when the compaction
+   * interval has elapsed or when the number of trains differs from the previous checkpoint. The
+   * dirty state of every train is cleared afterwards.
+   *
+   * @param trains An array of trains.
+   * @param numTrains The number of trains in the array.
+   * @return True if a full snapshot was written, false if a delta was written.
+   */
+  bool CheckpointWriter::writeCheckpoint(Train trains[], int numTrains) {
+    if (numTrains < 0) {
+      throw std::invalid_argument("Number of trains cannot be negative.");
+    }
+
+    bool snapshot = lastNumWagons.empty() && numTrains > 0;
+    snapshot = snapshot || static_cast<int>(lastNumWagons.size()) != numTrains;
+    snapshot = snapshot || checkpointsSinceSnapshot >= compactionInterval;
+
+    if (snapshot) {
+      writeSnapshot(trains, numTrains);
+      checkpointsSinceSnapshot = 0;
+    } else {
+      writeDelta(trains, numTrains);
+      checkpointsSinceSnapshot++;
+    }
+
+    lastNumWagons.resize(numTrains);
+    for (int i = 0; i < numTrains; i++) {
+      lastNumWagons[i] = trains[i].getNumWagons();
+      trains[i].clearDirty();
+    }
+    return snapshot;
+  }
+
+  /**
+   * @brief Force the next checkpoint to be a full snapshot.
+   */
+  void CheckpointWriter::requestSnapshot() {
+    checkpointsSinceSnapshot = compactionInterval;
+  }
+
+  /**
+   * @brief Write a full snapshot of all trains.
+   *
+   * @param trains An array of trains.
+   * @param numTrains The number of trains in the array.
+   */
+  void CheckpointWriter::writeSnapshot(Train trains[], int numTrains) {
+    os << "F " << numTrains << '\n';
+    for (int i = 0; i < numTrains; i++) {
+      const Train& train = trains[i];
+      os << train.getNumWagons() << '\n';
+      for (int j = 0; j < train.getNumWagons(); j++) {
+        writeWagonRecord(os, train[j]);
+      }
+    }
+  }
+
+  /**
+   * @brief Write only the wagons changed since the previous checkpoint.
+   *
+   * A train is included if at least one of its wagons is dirty or if its number of wagons changed
+   * (wagons removed from the tail leave no dirty bits behind).
+   *
+   * @param trains An array of trains.
+   * @param numTrains The number of trains in the array.
+   */
+  void CheckpointWriter::writeDelta(Train trains[], int numTrains) {
+    int numChanged = 0;
+    for (int i = 0; i < numTrains; i++) {
+      if (trains[i].getDirtyCount() > 0 || trains[i].getNumWagons() != lastNumWagons[i]) {
+        numChanged++;
+      }
+    }
+
+    os << "D " << numTrains << ' ' << numChanged << '\n';
+    for (int i = 0; i < numTrains; i++) {
+      const Train& train = trains[i];
+      int numDirty = train.getDirtyCount();
+      if (numDirty == 0 && train.getNumWagons() == lastNumWagons[i]) {
+        continue;
+      }
+      os << i << ' ' << train.getNumWagons() << ' ' << numDirty << '\n';
+      for (int j = 0; j < train.getNumWagons(); j++) {
+        if (train.isWagonDirty(j)) {
+          os << j << ' ';
+          writeWagonRecord(os, train[j]);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Read one checkpoint record and apply it to the fleet.
+   *
+   * @param is The input stream to read the checkpoint from.
+   * @param trains The fleet to apply the checkpoint to.
+   * @return A reference to the input stream; failbit is set if the record is malformed.
+   */
+  std::istream& readCheckpoint(std::istream& is, std::vector<Train>& trains) {
+    char kind;
+    int numTrains;
+    is >> kind >> numTrains;
+
+    // Check for EOF
+    if (!is.good()) {
+      return is;
+    }
+
+    // Check for invalid input
+    if ((kind != 'F' && kind != 'D') || numTrains < 0) {
+      is.setstate(std::ios::failbit);
+      return is;
+    }
+
+    if (kind == 'F') {
+      std::vector<Train> snapshot(numTrains);
+      for (int i = 0; i < numTrains; i++) {
+        is >> snapshot[i];
+        if (is.fail()) {
+          return is;
+        }
+        snapshot[i].clearDirty();
+      }
+      trains = std::move(snapshot);
+      return is;
+    }
+
+    int numChanged;
+    is >> numChanged;
+    if (!is.good() || numChanged < 0 || numChanged > numTrains || static_cast<int>(trains.size()) != numTrains) {
+      is.setstate(std::ios::failbit);
+      return is;
+    }
+
+    for (int i = 0; i < numChanged; i++) {
+      int trainIndex, numWagons, numDirty;
+      is >> trainIndex >> numWagons >> numDirty;
+      if (!is.good() || trainIndex < 0 || trainIndex >= numTrains || numWagons < 0 || numDirty < 0 || numDirty > numWagons) {
+        is.setstate(std::ios::failbit);
+        return is;
+      }
+
+      Train& train = trains[trainIndex];
+      resizeTrain(train, numWagons);
+      for (int j = 0; j < numDirty; j++) {
+        int wagonIndex;
+        Wagon wagon;
+        is >> wagonIndex;
+        if (!is.good() || wagonIndex < 0 || wagonIndex >= numWagons) {
+          is.setstate(std::ios::failbit);
+          return is;
+        }
+        if (readWagonRecord(is, wagon).fail()) {
+          return is;
+        }
+        train[wagonIndex] = wagon;
+      }
+      train.clearDirty();
+    }
+
+    return is;
+  }
+
+} // namespace lab2ComplexClass
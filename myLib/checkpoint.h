@@ -0,0 +1,89 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <iostream>
+#include <vector>
+#include "train.h"
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief The CheckpointWriter class persists the state of a fleet of trains incrementally.
+   *
+   * The first checkpoint (and every compactionInterval-th one after it) is a full snapshot of every
+   * wagon of every train. All other checkpoints are deltas that contain only the wagons marked dirty
+   * since the previous checkpoint, so the amount of written data scales with churn rather than with
+   * the size of the fleet. After a checkpoint is written the dirty state of each train is cleared.
+   *
+   * Record format (whitespace separated, one wagon per line as "type maxCapacity occupiedSeats"):
+   * - full snapshot:  "F numTrains", then for each train "numWagons" followed by its wagons;
+   * - delta:          "D numTrains numChangedTrains", then for each changed train
+   *                   "trainIndex numWagons numDirtyWagons" followed by "wagonIndex type maxCapacity occupiedSeats" lines.
+   */
+  class CheckpointWriter {
+    private:
+      std::ostream& os;                // Поток для записи контрольных точек
+      int compactionInterval;          // Через сколько дельт записывается полный снимок
+      int checkpointsSinceSnapshot;    // Количество дельт после последнего полного снимка
+      std::vector<int> lastNumWagons;  // Число вагонов каждого поезда в последней контрольной точке
+
+      /**
+       * @brief Write a full snapshot of all trains.
+       *
+       * @param trains An array of trains.
+       * @param numTrains The number of trains in the array.
+       */
+      void writeSnapshot(Train trains[], int numTrains);
+
+      /**
+       * @brief Write only the wagons changed since the previous checkpoint.
+       *
+       * @param trains An array of trains.
+       * @param numTrains The number of trains in the array.
+       */
+      void writeDelta(Train trains[], int numTrains);
+
+    public:
+
+      /**
+       * @brief Constructor for the CheckpointWriter class.
+       *
+       * @param os The output stream checkpoints are appended to.
+       * @param compactionInterval The number of checkpoints between two full snapshots.
+       * @throws std::invalid_argument if compactionInterval is not positive.
+       */
+      explicit CheckpointWriter(std::ostream& os, int compactionInterval = 16);
+
+      /**
+       * @brief Write the next checkpoint of the fleet.
+       *
+       * A full snapshot is written for the first checkpoint, every compactionInterval checkpoints and
+       * whenever the number of trains changes; otherwise a delta is written.
+       *
+       * @param trains An array of trains.
+       * @param numTrains The number of trains in the array.
+       * @return True if a full snapshot was written, false if a delta was written.
+       */
+      bool writeCheckpoint(Train trains[], int numTrains);
+
+      /**
+       * @brief Force the next checkpoint to be a full snapshot.
+       */
+      void requestSnapshot();
+  };
+
+  /**
+   * @brief Read one checkpoint record and apply it to the fleet.
+   *
+   * A full snapshot replaces the contents of the vector; a delta updates the trains in place.
+   * Restored trains have their dirty state cleared.
+   *
+   * @param is The input stream to read the checkpoint from.
+   * @param trains The fleet to apply the checkpoint to.
+   * @return A reference to the input stream; failbit is set if the record is malformed.
+   */
+  std::istream& readCheckpoint(std::istream& is, std::vector<Train>& trains);
+
+} // namespace lab2ComplexClass
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,525 @@
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_set>
+#include "cow_train.h"
+
+namespace lab2ComplexClass {
+
+  namespace {
+
+    /// @brief Check whether a pointer is the only reference to its object.
+    ///
+    /// The acquire fence orders our writes after the reads of copies released on other threads.
+    template <typename T>
+    bool isUnique(const std::shared_ptr<T>& pointer) {
+      if (pointer.use_count() != 1) {
+        return false;
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return true;
+    }
+
+  } // namespace
+
+  /**
+   * @brief Default constructor, creates an empty train.
+   */
+  CowTrain::CowTrain() : table(std::make_shared<Table>()) {}
+
+  /**
+   * @brief Constructor that copies a sequence of wagons into fresh chunks of CHUNK_SIZE wagons.
+   *
+   * @param wagons The wagons in order.
+   */
+  CowTrain::CowTrain(std::span<const Wagon> wagons) : table(std::make_shared<Table>()) {
+    for (size_t offset = 0; offset < wagons.size(); offset += CHUNK_SIZE) {
+      std::span<const Wagon> part = wagons.subspan(offset, std::min<size_t>(CHUNK_SIZE, wagons.size() - offset));
+      table->chunks.push_back(std::make_shared<Chunk>(part.begin(), part.end()));
+    }
+    rebuildStarts(*table);
+  }
+
+  /**
+   * @brief Constructor that copies the wagons of a train into fresh chunks.
+   *
+   * @param train The train to copy.
+   */
+  CowTrain::CowTrain(const Train& train) : CowTrain(train.view()) {}
+
+  /**
+   * @brief Convert to a train.
+   *
+   * @return A train with the same wagons.
+   */
+  Train CowTrain::toTrain() const {
+    Train train;
+    train.reserve(table->numWagons);
+    for (const auto& chunk : table->chunks) {
+      train.append(*chunk);
+    }
+    return train;
+  }
+
+  /**
+   * @brief Equality operator, compares every wagon.
+   *
+   * Trains that still share their table are equal without looking at the wagons.
+   *
+   * @param other The train to compare with.
+   * @return True if both trains have the same wagons in the same order.
+   */
+  bool CowTrain::operator==(const CowTrain& other) const {
+    if (table == other.table) {
+      return true;
+    }
+    if (table->numWagons != other.table->numWagons) {
+      return false;
+    }
+    int index = 0;
+    for (const auto& chunk : table->chunks) {
+      for (const Wagon& wagon : *chunk) {
+        if (!(wagon == other.getWagonByIndex(index))) {
+          return false;
+        }
+        index++;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief Get the number of wagons in the train.
+   *
+   * @return The number of wagons.
+   */
+  int CowTrain::getNumWagons() const { return table->numWagons; }
+
+  /**
+   * @brief Get a wagon by its index.
+   *
+   * @param index The index of the wagon.
+   * @return A const reference to the wagon.
+   * @throws std::out_of_range if the index is invalid.
+   */
+  const Wagon& CowTrain::getWagonByIndex(int index) const {
+    if (index < 0 || index >= table->numWagons) {
+      throw std::out_of_range("Invalid wagon index.");
+    }
+    auto [chunkIndex, offset] = locate(index);
+    return (*table->chunks[chunkIndex])[offset];
+  }
+
+  /**
+   * @brief Overloaded const subscript operator for reading wagons.
+   *
+   * @param index The index of the wagon.
+   * @return A const reference to the wagon.
+   * @throws std::out_of_range if the index is invalid.
+   */
+  const Wagon& CowTrain::operator[](int index) const {
+    if (index < 0 || index >= table->numWagons) {
+      throw std::out_of_range("Index out of range");
+    }
+    auto [chunkIndex, offset] = locate(index);
+    return (*table->chunks[chunkIndex])[offset];
+  }
+
+  /**
+   * @brief Overloaded subscript operator for modifying wagons.
+   *
+   * Only the chunk holding the wagon is cloned if it is shared.
+   *
+   * @param index The index of the wagon.
+   * @return A reference to the wagon.
+   * @throws std::invalid_argument if the index is invalid.
+   */
+  Wagon& CowTrain::operator[](int index) {
+    if (index < 0 || index >= table->numWagons) {
+      throw std::invalid_argument("Invalid wagon index.");
+    }
+    auto [chunkIndex, offset] = locate(index);
+    return mutableChunk(chunkIndex)[offset];
+  }
+
+  /**
+   * @brief Add a wagon to the end of the train.
+   *
+   * @param wagon The wagon to add.
+   */
+  void CowTrain::addWagon(const Wagon& wagon) {
+    addWagonAtIndex(wagon, table->numWagons);
+  }
+
+  /**
+   * @brief Add a wagon at the specified index.
+   *
+   * The wagon goes into the chunk that holds the index (the last chunk when appending). A chunk that grows
+   * past 2 * CHUNK_SIZE wagons is split in half, so insertions stay local.
+   *
+   * @param newWagon The wagon to add.
+   * @param index The index at which to insert the wagon.
+   * @throws std::invalid_argument if the index is out of bounds.
+   */
+  void CowTrain::addWagonAtIndex(const Wagon& newWagon, int index) {
+    if (index < 0 || index > table->numWagons) {
+      throw std::invalid_argument("Invalid index for adding a wagon.");
+    }
+
+    // The new wagon may refer to a wagon of this train, which could be cloned away
+    Wagon inserted = newWagon;
+    Table& owned = mutableTable();
+    if (owned.chunks.empty()) {
+      owned.chunks.push_back(std::make_shared<Chunk>(1, inserted));
+      rebuildStarts(owned);
+      return;
+    }
+
+    int chunkIndex = static_cast<int>(owned.chunks.size()) - 1;
+    int offset = static_cast<int>(owned.chunks[chunkIndex]->size());
+    if (index < owned.numWagons) {
+      std::tie(chunkIndex, offset) = locate(index);
+    }
+
+    Chunk& chunk = mutableChunk(chunkIndex);
+    chunk.insert(chunk.begin() + offset, inserted);
+    if (static_cast<int>(chunk.size()) > 2 * CHUNK_SIZE) {
+      auto half = chunk.begin() + static_cast<std::ptrdiff_t>(chunk.size() / 2);
+      auto tail = std::make_shared<Chunk>(half, chunk.end());
+      chunk.erase(half, chunk.end());
+      owned.chunks.insert(owned.chunks.begin() + chunkIndex + 1, std::move(tail));
+    }
+    rebuildStarts(owned);
+  }
+
+  /**
+   * @brief Remove a wagon by its index; a chunk left empty is dropped.
+   *
+   * @param index The index of the wagon.
+   * @throws std::out_of_range if the index is invalid.
+   */
+  void CowTrain::removeWagonByIndex(int index) {
+    if (index < 0 || index >= table->numWagons) {
+      throw std::out_of_range("Invalid wagon index.");
+    }
+    auto [chunkIndex, offset] = locate(index);
+    Chunk& chunk = mutableChunk(chunkIndex);
+    chunk.erase(chunk.begin() + offset);
+    if (chunk.empty()) {
+      table->chunks.erase(table->chunks.begin() + chunkIndex);
+    }
+    rebuildStarts(*table);
+  }
+
+  /**
+   * @brief Board passengers into the wagon Train::boardPassengersToMostAvailableWagon would choose.
+   *
+   * The wagons are scanned without unsharing anything; only the chunk of the chosen wagon is cloned.
+   *
+   * @param passengers The number of passengers to board.
+   * @param wagonType The class of wagon to board passengers into.
+   * @throws std::invalid_argument if no wagon of the class can take the passengers.
+   */
+  void CowTrain::boardPassengersToMostAvailableWagon(int passengers, WagonType wagonType) {
+    int best = -1;
+    int bestOccupancy = 0;
+    int index = 0;
+    for (const auto& chunk : table->chunks) {
+      for (const Wagon& wagon : *chunk) {
+        if (wagon.getType() == wagonType && wagon.getMaxCapacity() - wagon.getOccupiedSeats() >= passengers &&
+            (best < 0 || wagon.getOccupiedSeats() > bestOccupancy)) {
+          best = index;
+          bestOccupancy = wagon.getOccupiedSeats();
+        }
+        index++;
+      }
+    }
+
+    if (best < 0) {
+      throw std::invalid_argument("No available wagons of the specified type can accommodate the specified number of passengers.");
+    }
+
+    auto [chunkIndex, offset] = locate(best);
+    mutableChunk(chunkIndex)[offset].boardPassengers(passengers);
+  }
+
+  /**
+   * @brief Get the number of passengers and the total capacity of the wagons of a class.
+   *
+   * @param wagonType The class of wagons to consider.
+   * @param occupiedSeats The total number of occupied seats.
+   * @param maxCapacity The total capacity.
+   */
+  void CowTrain::getPassengerCountByType(WagonType wagonType, int& occupiedSeats, int& maxCapacity) const {
+    occupiedSeats = 0;
+    maxCapacity = 0;
+    for (const auto& chunk : table->chunks) {
+      for (const Wagon& wagon : *chunk) {
+        if (wagon.getType() == wagonType) {
+          occupiedSeats += wagon.getOccupiedSeats();
+          maxCapacity += wagon.getMaxCapacity();
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Redistribute passengers like Train::redistributePassengers.
+   *
+   * A chunk is cloned only when one of its wagons gets a different number of passengers.
+   */
+  void CowTrain::redistributePassengers() {
+    int occupiedByType[WAGON_TYPE_COUNT] = {};
+    int capacityByType[WAGON_TYPE_COUNT] = {};
+    for (const auto& chunk : table->chunks) {
+      for (const Wagon& wagon : *chunk) {
+        int type = static_cast<int>(wagon.getType());
+        occupiedByType[type] += wagon.getOccupiedSeats();
+        capacityByType[type] += wagon.getMaxCapacity();
+      }
+    }
+
+    double occupancyByType[WAGON_TYPE_COUNT] = {};
+    for (int type = 0; type < WAGON_TYPE_COUNT; type++) {
+      if (capacityByType[type] != 0) {
+        occupancyByType[type] = static_cast<double>(occupiedByType[type]) / capacityByType[type];
+      }
+    }
+
+    int chunkCount = static_cast<int>(table->chunks.size());
+    for (int c = 0; c < chunkCount; c++) {
+      Chunk* chunk = table->chunks[c].get();
+      bool owned = false;
+      for (size_t i = 0; i < chunk->size(); i++) {
+        int type = static_cast<int>((*chunk)[i].getType());
+        if (!WAGON_TYPE_TRAITS[type].canBoard) {
+          continue;
+        }
+        int seats = static_cast<int>((*chunk)[i].getMaxCapacity() * occupancyByType[type]);
+        if ((*chunk)[i].getOccupiedSeats() != seats) {
+          if (!owned) {
+            chunk = &mutableChunk(c);
+            owned = true;
+          }
+          (*chunk)[i].setOccupiedSeats(seats);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Optimize the train like Train::optimizeTrain.
+   *
+   * Chunks in which no wagon changes and none is removed are kept shared; the others are rebuilt without
+   * their empty wagons.
+   */
+  void CowTrain::optimizeTrain() {
+    int remainingByType[WAGON_TYPE_COUNT] = {};
+    for (const auto& chunk : table->chunks) {
+      for (const Wagon& wagon : *chunk) {
+        remainingByType[static_cast<int>(wagon.getType())] += wagon.getOccupiedSeats();
+      }
+    }
+
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    chunks.reserve(table->chunks.size());
+    bool changed = false;
+    for (const auto& chunk : table->chunks) {
+      // Fill the wagons of each class in order; the chunk is untouched if every wagon keeps its passengers
+      std::vector<int> seats(chunk->size());
+      bool chunkChanged = false;
+      for (size_t i = 0; i < chunk->size(); i++) {
+        const Wagon& wagon = (*chunk)[i];
+        int type = static_cast<int>(wagon.getType());
+        seats[i] = wagon.getOccupiedSeats();
+        if (WAGON_TYPE_TRAITS[type].canBoard) {
+          seats[i] = std::min(remainingByType[type], wagon.getMaxCapacity());
+          remainingByType[type] -= seats[i];
+        }
+        chunkChanged = chunkChanged || seats[i] != wagon.getOccupiedSeats() || seats[i] == 0;
+      }
+
+      if (!chunkChanged) {
+        chunks.push_back(chunk);
+        continue;
+      }
+      changed = true;
+      auto rebuilt = std::make_shared<Chunk>();
+      for (size_t i = 0; i < chunk->size(); i++) {
+        if (seats[i] == 0) {
+          continue;
+        }
+        Wagon wagon = (*chunk)[i];
+        if (wagon.getOccupiedSeats() != seats[i]) {
+          wagon.setOccupiedSeats(seats[i]);
+        }
+        rebuilt->push_back(wagon);
+      }
+      if (!rebuilt->empty()) {
+        chunks.push_back(std::move(rebuilt));
+      }
+    }
+
+    if (changed) {
+      auto optimized = std::make_shared<Table>();
+      optimized->chunks = std::move(chunks);
+      rebuildStarts(*optimized);
+      table = std::move(optimized);
+    }
+  }
+
+  /**
+   * @brief Insert a restaurant wagon where Train::optimizeRestaurantPlacement would insert it.
+   */
+  void CowTrain::optimizeRestaurantPlacement() {
+    int totalPassengers = 0;
+    for (const auto& chunk : table->chunks) {
+      for (const Wagon& wagon : *chunk) {
+        if (wagon.getType() != WagonType::LUXURY) {
+          totalPassengers += wagon.getOccupiedSeats();
+        }
+      }
+    }
+
+    int midPassengers = totalPassengers / 2;
+    int needPosition = 0;
+    int index = 0;
+    bool found = false;
+    for (const auto& chunk : table->chunks) {
+      for (const Wagon& wagon : *chunk) {
+        if (wagon.getType() != WagonType::LUXURY) {
+          totalPassengers -= wagon.getOccupiedSeats();
+          needPosition = totalPassengers != midPassengers ? index + 1 : index;
+          found = true;
+          break;
+        }
+        index++;
+      }
+      if (found) {
+        break;
+      }
+    }
+
+    addWagonAtIndex(Wagon(), needPosition);
+  }
+
+  /**
+   * @brief Get the number of chunks.
+   *
+   * @return The number of chunks.
+   */
+  int CowTrain::getChunkCount() const { return static_cast<int>(table->chunks.size()); }
+
+  /**
+   * @brief Get the number of chunks shared with another train.
+   *
+   * @param other The other train.
+   * @return The number of chunks both trains reference.
+   */
+  int CowTrain::countSharedChunks(const CowTrain& other) const {
+    if (table == other.table) {
+      return getChunkCount();
+    }
+    std::unordered_set<const Chunk*> otherChunks;
+    for (const auto& chunk : other.table->chunks) {
+      otherChunks.insert(chunk.get());
+    }
+    int shared = 0;
+    for (const auto& chunk : table->chunks) {
+      shared += otherChunks.count(chunk.get()) != 0 ? 1 : 0;
+    }
+    return shared;
+  }
+
+  /**
+   * @brief Get the memory of the chunks that belong to this train alone.
+   *
+   * @return The number of bytes of wagon storage not shared with any copy.
+   */
+  size_t CowTrain::bytesOwned() const {
+    if (table.use_count() != 1) {
+      return 0;
+    }
+    size_t bytes = 0;
+    for (const auto& chunk : table->chunks) {
+      if (chunk.use_count() == 1) {
+        bytes += chunk->capacity() * sizeof(Wagon);
+      }
+    }
+    return bytes;
+  }
+
+  /**
+   * @brief Output operator, writes the train in the same format as Train.
+   *
+   * @param os The output stream.
+   * @param train The train to write.
+   * @return The output stream.
+   */
+  std::ostream& operator<<(std::ostream& os, const CowTrain& train) {
+    os << train.table->numWagons << std::endl;
+    for (const auto& chunk : train.table->chunks) {
+      for (const Wagon& wagon : *chunk) {
+        os << wagon;
+      }
+    }
+    return os;
+  }
+
+  /**
+   * @brief Get the table for modification, cloning it if it is shared with a copy.
+   *
+   * Cloning copies one pointer per chunk; the chunks themselves stay shared.
+   *
+   * @return The table owned by this train alone.
+   */
+  CowTrain::Table& CowTrain::mutableTable() {
+    if (!isUnique(table)) {
+      table = std::make_shared<Table>(*table);
+    }
+    return *table;
+  }
+
+  /**
+   * @brief Get a chunk for modification, cloning it if it is shared with a copy.
+   *
+   * @param chunkIndex The index of the chunk.
+   * @return The chunk owned by this train alone.
+   */
+  CowTrain::Chunk& CowTrain::mutableChunk(int chunkIndex) {
+    std::shared_ptr<Chunk>& chunk = mutableTable().chunks[chunkIndex];
+    if (!isUnique(chunk)) {
+      chunk = std::make_shared<Chunk>(*chunk);
+    }
+    return *chunk;
+  }
+
+  /**
+   * @brief Find the chunk holding a wagon with a binary search over the chunk starts.
+   *
+   * @param index The index of the wagon, must be valid.
+   * @return The chunk index and the offset of the wagon in the chunk.
+   */
+  std::pair<int, int> CowTrain::locate(int index) const {
+    auto next = std::upper_bound(table->starts.begin(), table->starts.end(), index);
+    int chunkIndex = static_cast<int>(next - table->starts.begin()) - 1;
+    return {chunkIndex, index - table->starts[chunkIndex]};
+  }
+
+  /**
+   * @brief Recompute the chunk starts and the number of wagons after a structural change.
+   *
+   * @param table The table to update.
+   */
+  void CowTrain::rebuildStarts(Table& table) {
+    table.starts.resize(table.chunks.size());
+    int start = 0;
+    for (size_t c = 0; c < table.chunks.size(); c++) {
+      table.starts[c] = start;
+      start += static_cast<int>(table.chunks[c]->size());
+    }
+    table.numWagons = start;
+  }
+
+} // namespace lab2ComplexClass
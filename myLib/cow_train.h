@@ -0,0 +1,232 @@
+#ifndef COW_TRAIN_H
+#define COW_TRAIN_H
+
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+#include "train.h"
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief A copy-on-write train for cheap what-if snapshots.
+   *
+   * The wagons are split into chunks of up to 2 * CHUNK_SIZE wagons held by reference-counted pointers, and
+   * the table of chunks is itself reference-counted. Copying a CowTrain shares the table in O(1); the first
+   * mutation of a copy clones the table (one pointer per chunk) and then only the chunks it actually changes.
+   * A what-if alternative therefore costs time and memory proportional to the wagons it modifies.
+   *
+   * The operations give the same results as the Train operations of the same name. Copies may be handed to
+   * other threads; a single CowTrain object must not be used concurrently.
+   */
+  class CowTrain {
+    public:
+      static constexpr int CHUNK_SIZE = 64; ///< Wagons per chunk when a train is built; chunks split at twice this.
+
+    private:
+      using Chunk = std::vector<Wagon>;
+
+      /// @brief The chunk table shared between copies.
+      struct Table {
+        std::vector<std::shared_ptr<Chunk>> chunks; // Куски поезда по порядку
+        std::vector<int> starts;                    // Индекс первого вагона каждого куска
+        int numWagons = 0;                          // Общее количество вагонов
+      };
+
+      std::shared_ptr<Table> table; // Таблица кусков, общая с копиями до первого изменения
+
+      /**
+       * @brief Get the table for modification, cloning it if it is shared with a copy.
+       *
+       * @return The table owned by this train alone.
+       */
+      Table& mutableTable();
+
+      /**
+       * @brief Get a chunk for modification, cloning it if it is shared with a copy.
+       *
+       * @param chunkIndex The index of the chunk.
+       * @return The chunk owned by this train alone.
+       */
+      Chunk& mutableChunk(int chunkIndex);
+
+      /**
+       * @brief Find the chunk holding a wagon.
+       *
+       * @param index The index of the wagon, must be valid.
+       * @return The chunk index and the offset of the wagon in the chunk.
+       */
+      std::pair<int, int> locate(int index) const;
+
+      /**
+       * @brief Recompute the chunk starts and the number of wagons after a structural change.
+       *
+       * @param table The table to update.
+       */
+      static void rebuildStarts(Table& table);
+
+    public:
+      /**
+       * @brief Default constructor, creates an empty train.
+       */
+      CowTrain();
+
+      /**
+       * @brief Constructor that copies a sequence of wagons into fresh chunks.
+       *
+       * @param wagons The wagons in order.
+       */
+      explicit CowTrain(std::span<const Wagon> wagons);
+
+      /**
+       * @brief Constructor that copies the wagons of a train into fresh chunks.
+       *
+       * @param train The train to copy.
+       */
+      explicit CowTrain(const Train& train);
+
+      /**
+       * @brief Convert to a train.
+       *
+       * @return A train with the same wagons.
+       */
+      Train toTrain() const;
+
+      /**
+       * @brief Equality operator, compares every wagon.
+       *
+       * @param other The train to compare with.
+       * @return True if both trains have the same wagons in the same order.
+       */
+      bool operator==(const CowTrain& other) const;
+
+      /**
+       * @brief Get the number of wagons in the train.
+       *
+       * @return The number of wagons.
+       */
+      int getNumWagons() const;
+
+      /**
+       * @brief Get a wagon by its index.
+       *
+       * @param index The index of the wagon.
+       * @return A const reference to the wagon.
+       * @throws std::out_of_range if the index is invalid.
+       */
+      const Wagon& getWagonByIndex(int index) const;
+
+      /**
+       * @brief Overloaded const subscript operator for reading wagons.
+       *
+       * @param index The index of the wagon.
+       * @return A const reference to the wagon.
+       * @throws std::out_of_range if the index is invalid.
+       */
+      const Wagon& operator[](int index) const;
+
+      /**
+       * @brief Overloaded subscript operator for modifying wagons; unshares the chunk of the wagon.
+       *
+       * The reference is invalidated by any structural change and by copying the train: writes through it
+       * after a copy would be seen by the copy as well.
+       *
+       * @param index The index of the wagon.
+       * @return A reference to the wagon.
+       * @throws std::invalid_argument if the index is invalid.
+       */
+      Wagon& operator[](int index);
+
+      /**
+       * @brief Add a wagon to the end of the train.
+       *
+       * @param wagon The wagon to add.
+       */
+      void addWagon(const Wagon& wagon);
+
+      /**
+       * @brief Add a wagon at the specified index; only the chunk receiving the wagon is unshared.
+       *
+       * @param newWagon The wagon to add.
+       * @param index The index at which to insert the wagon.
+       * @throws std::invalid_argument if the index is out of bounds.
+       */
+      void addWagonAtIndex(const Wagon& newWagon, int index);
+
+      /**
+       * @brief Remove a wagon by its index; only the chunk losing the wagon is unshared.
+       *
+       * @param index The index of the wagon.
+       * @throws std::out_of_range if the index is invalid.
+       */
+      void removeWagonByIndex(int index);
+
+      /**
+       * @brief Board passengers into the wagon Train::boardPassengersToMostAvailableWagon would choose.
+       *
+       * @param passengers The number of passengers to board.
+       * @param wagonType The class of wagon to board passengers into.
+       * @throws std::invalid_argument if no wagon of the class can take the passengers.
+       */
+      void boardPassengersToMostAvailableWagon(int passengers, WagonType wagonType);
+
+      /**
+       * @brief Get the number of passengers and the total capacity of the wagons of a class.
+       *
+       * @param wagonType The class of wagons to consider.
+       * @param occupiedSeats The total number of occupied seats.
+       * @param maxCapacity The total capacity.
+       */
+      void getPassengerCountByType(WagonType wagonType, int& occupiedSeats, int& maxCapacity) const;
+
+      /**
+       * @brief Redistribute passengers like Train::redistributePassengers; unchanged chunks stay shared.
+       */
+      void redistributePassengers();
+
+      /**
+       * @brief Optimize the train like Train::optimizeTrain; unchanged chunks stay shared.
+       */
+      void optimizeTrain();
+
+      /**
+       * @brief Insert a restaurant wagon where Train::optimizeRestaurantPlacement would insert it.
+       */
+      void optimizeRestaurantPlacement();
+
+      /**
+       * @brief Get the number of chunks.
+       *
+       * @return The number of chunks.
+       */
+      int getChunkCount() const;
+
+      /**
+       * @brief Get the number of chunks shared with another train.
+       *
+       * @param other The other train.
+       * @return The number of chunks both trains reference.
+       */
+      int countSharedChunks(const CowTrain& other) const;
+
+      /**
+       * @brief Get the memory of the chunks that belong to this train alone.
+       *
+       * @return The number of bytes of wagon storage not shared with any copy.
+       */
+      size_t bytesOwned() const;
+
+      /**
+       * @brief Output operator, writes the train in the same format as Train.
+       *
+       * @param os The output stream.
+       * @param train The train to write.
+       * @return The output stream.
+       */
+      friend std::ostream& operator<<(std::ostream& os, const CowTrain& train);
+  };
+
+} // namespace lab2ComplexClass
+
+#endif // COW_TRAIN_H
@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "demand_forecast.h"
+#include "random_stream.h"
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief Add a value.
+   *
+   * @param percent The value, 0 .. 100.
+   * @throws std::out_of_range if the value is out of range.
+   */
+  void PercentDistribution::add(int percent) {
+    if (percent < 0 || percent > 100) {
+      throw std::out_of_range("Percent must be between 0 and 100.");
+    }
+    counts[percent]++;
+    count++;
+    sum += percent;
+  }
+
+  /**
+   * @brief Add all values of another distribution.
+   *
+   * @param other The distribution.
+   */
+  void PercentDistribution::merge(const PercentDistribution& other) {
+    for (size_t percent = 0; percent < counts.size(); percent++) {
+      counts[percent] += other.counts[percent];
+    }
+    count += other.count;
+    sum += other.sum;
+  }
+
+  /**
+   * @brief Get the number of values equal to a percent.
+   *
+   * @param percent The percent, 0 .. 100.
+   * @return The number of values.
+   * @throws std::out_of_range if the percent is out of range.
+   */
+  int64_t PercentDistribution::getCountAt(int percent) const {
+    if (percent < 0 || percent > 100) {
+      throw std::out_of_range("Percent must be between 0 and 100.");
+    }
+    return counts[percent];
+  }
+
+  /**
+   * @brief Get the mean.
+   *
+   * @return The mean, 0 if there are no values.
+   */
+  double PercentDistribution::getMean() const { return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count); }
+
+  /**
+   * @brief Get the population standard deviation.
+   *
+   * The variance is summed over the 101 bins around the mean, so it neither overflows nor cancels however
+   * many values there are.
+   *
+   * @return The standard deviation, 0 if there are no values.
+   */
+  double PercentDistribution::getStandardDeviation() const {
+    if (count == 0) {
+      return 0.0;
+    }
+    double mean = getMean();
+    double squares = 0.0;
+    for (int percent = 0; percent <= 100; percent++) {
+      double deviation = percent - mean;
+      squares += static_cast<double>(counts[percent]) * deviation * deviation;
+    }
+    return std::sqrt(squares / static_cast<double>(count));
+  }
+
+  /**
+   * @brief Get the smallest percent that at least the given share of the values do not exceed.
+   *
+   * @param share The share, in [0, 1].
+   * @return The percentile, 0 if there are no values.
+   * @throws std::out_of_range if the share is out of range.
+   */
+  int PercentDistribution::getPercentile(double share) const {
+    if (share < 0 || share > 1) {
+      throw std::out_of_range("Share must be between 0 and 1.");
+    }
+    double needed = std::max(share * static_cast<double>(count), 1.0);
+    int64_t seen = 0;
+    for (int percent = 0; percent <= 100; percent++) {
+      seen += counts[percent];
+      if (static_cast<double>(seen) >= needed) {
+        return percent;
+      }
+    }
+    return 0;
+  }
+
+  /**
+   * @brief Get the share of rejected groups over all scenarios.
+   *
+   * @return The rejection rate, 0 if no group asked for the class.
+   */
+  double ClassForecast::getRejectionRate() const {
+    return groups == 0 ? 0.0 : static_cast<double>(rejectedGroups) / static_cast<double>(groups);
+  }
+
+  namespace {
+
+    constexpr int SCENARIO_BATCH = 64; // Сценариев, которые рабочий забирает за один раз
+
+    /**
+     * @brief Run one scenario on a scratch train and add its outcome to a forecast.
+     *
+     * @param consist The consist.
+     * @param seats Seats of every class in the consist.
+     * @param model The demand.
+     * @param scratch The train to run on; overwritten.
+     * @param random The stream of the scenario.
+     * @param forecast The forecast to add to.
+     */
+    void runScenario(const Train& consist, const std::array<int64_t, WAGON_TYPE_COUNT>& seats, const DemandModel& model,
+                     Train& scratch, RandomStream& random, DemandForecast& forecast) {
+      scratch = consist;
+      for (int type = 0; type < WAGON_TYPE_COUNT; type++) {
+        if (seats[type] == 0) {
+          continue;
+        }
+        WagonType wagonType = static_cast<WagonType>(type);
+        ClassForecast& result = forecast.classes[type];
+        int groups = model.meanGroups[type] > 0 ? std::poisson_distribution<int>(model.meanGroups[type])(random) : 0;
+        int rejected = 0;
+        for (int group = 0; group < groups; group++) {
+          int passengers = 1 + random.below(model.maxGroupSize);
+          if (scratch.hasWagonWithRoom(passengers, wagonType)) {
+            scratch.boardPassengersToMostAvailableWagon(passengers, wagonType);
+          } else {
+            rejected++;
+          }
+        }
+        result.groups += groups;
+        result.rejectedGroups += rejected;
+        if (groups > 0) {
+          result.rejection.add(static_cast<int>(static_cast<int64_t>(rejected) * 100 / groups));
+        }
+
+        int64_t occupied = 0;
+        for (const Wagon& wagon : scratch.view()) {
+          if (wagon.getType() == wagonType) {
+            occupied += wagon.getOccupiedSeats();
+          }
+        }
+        result.occupancy.add(static_cast<int>(occupied * 100 / seats[type]));
+      }
+      forecast.scenarios++;
+    }
+
+  } // namespace
+
+  /**
+   * @brief Run random demand scenarios against a consist in parallel and aggregate the outcome.
+   *
+   * @param consist The consist, including the passengers already on board.
+   * @param model The demand.
+   * @param pool The pool to run on.
+   * @return The forecast.
+   * @throws std::invalid_argument if the model is invalid.
+   */
+  DemandForecast forecastDemand(const Train& consist, const DemandModel& model, ThreadPool& pool) {
+    if (model.maxGroupSize <= 0 || model.numScenarios < 0 ||
+        std::any_of(model.meanGroups.begin(), model.meanGroups.end(), [](double mean) { return !(mean >= 0); })) {
+      throw std::invalid_argument("Invalid demand model.");
+    }
+
+    // Места считаются только в классах, куда можно сажать пассажиров
+    std::array<int64_t, WAGON_TYPE_COUNT> seats{};
+    for (const Wagon& wagon : consist.view()) {
+      if (wagonTypeTraits(wagon.getType()).canBoard) {
+        seats[static_cast<int>(wagon.getType())] += wagon.getMaxCapacity();
+      }
+    }
+
+    int numWorkers = std::max(std::min(pool.getThreadCount(), model.numScenarios), 1);
+    std::vector<DemandForecast> partial(numWorkers);
+    std::atomic<int> nextScenario{0};
+    pool.parallelFor(numWorkers, [&](int worker) {
+      Train scratch;
+      RandomStream random(model.seed, 0);
+      while (true) {
+        int first = nextScenario.fetch_add(SCENARIO_BATCH, std::memory_order_relaxed);
+        if (first >= model.numScenarios) {
+          break;
+        }
+        int last = std::min(first + SCENARIO_BATCH, model.numScenarios);
+        for (int scenario = first; scenario < last; scenario++) {
+          random = RandomStream(model.seed, static_cast<uint64_t>(scenario));
+          runScenario(consist, seats, model, scratch, random, partial[worker]);
+        }
+      }
+    });
+
+    DemandForecast forecast;
+    for (const DemandForecast& part : partial) {
+      forecast.scenarios += part.scenarios;
+      for (int type = 0; type < WAGON_TYPE_COUNT; type++) {
+        ClassForecast& result = forecast.classes[type];
+        result.groups += part.classes[type].groups;
+        result.rejectedGroups += part.classes[type].rejectedGroups;
+        result.occupancy.merge(part.classes[type].occupancy);
+        result.rejection.merge(part.classes[type].rejection);
+      }
+    }
+    return forecast;
+  }
+
+} // namespace lab2ComplexClass
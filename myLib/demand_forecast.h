@@ -0,0 +1,134 @@
+#ifndef DEMAND_FORECAST_H
+#define DEMAND_FORECAST_H
+
+#include <array>
+#include <cstdint>
+#include "thread_pool.h"
+#include "train.h"
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief Streaming distribution of a percentage: a histogram of whole percents with exact integer sums.
+   *
+   * Memory is fixed however many values are added, and since the state is integer counts, merging partial
+   * distributions gives the same result in any order.
+   */
+  class PercentDistribution {
+    private:
+      std::array<int64_t, 101> counts{}; // Число значений для каждого процента 0 .. 100
+      int64_t count = 0;                 // Число значений
+      int64_t sum = 0;                   // Сумма значений
+
+    public:
+      /**
+       * @brief Add a value.
+       *
+       * @param percent The value, 0 .. 100.
+       * @throws std::out_of_range if the value is out of range.
+       */
+      void add(int percent);
+
+      /**
+       * @brief Add all values of another distribution.
+       *
+       * @param other The distribution.
+       */
+      void merge(const PercentDistribution& other);
+
+      /**
+       * @brief Get the number of values.
+       *
+       * @return The number of values.
+       */
+      int64_t getCount() const { return count; }
+
+      /**
+       * @brief Get the number of values equal to a percent.
+       *
+       * @param percent The percent, 0 .. 100.
+       * @return The number of values.
+       * @throws std::out_of_range if the percent is out of range.
+       */
+      int64_t getCountAt(int percent) const;
+
+      /**
+       * @brief Get the mean.
+       *
+       * @return The mean, 0 if there are no values.
+       */
+      double getMean() const;
+
+      /**
+       * @brief Get the population standard deviation.
+       *
+       * @return The standard deviation, 0 if there are no values.
+       */
+      double getStandardDeviation() const;
+
+      /**
+       * @brief Get the smallest percent that at least the given share of the values do not exceed.
+       *
+       * @param share The share, in [0, 1].
+       * @return The percentile, 0 if there are no values.
+       * @throws std::out_of_range if the share is out of range.
+       */
+      int getPercentile(double share) const;
+
+      bool operator==(const PercentDistribution&) const = default;
+  };
+
+  /// @brief Forecast for one wagon class of a consist.
+  struct ClassForecast {
+    int64_t groups = 0;                ///< Groups that asked for the class over all scenarios.
+    int64_t rejectedGroups = 0;        ///< Groups that found no wagon of the class with room.
+    PercentDistribution occupancy;     ///< Occupied seats of the class in percent of its seats, one value per scenario.
+    PercentDistribution rejection;     ///< Rejected groups in percent of the groups of the class, per scenario with groups.
+
+    /**
+     * @brief Get the share of rejected groups over all scenarios.
+     *
+     * @return The rejection rate, 0 if no group asked for the class.
+     */
+    double getRejectionRate() const;
+
+    bool operator==(const ClassForecast&) const = default;
+  };
+
+  /// @brief Random demand for a consist.
+  struct DemandModel {
+    std::array<double, WAGON_TYPE_COUNT> meanGroups{}; ///< Mean number of groups asking for each class in a scenario (Poisson).
+    int maxGroupSize = 4;                              ///< Groups have 1 .. maxGroupSize passengers.
+    int numScenarios = 1000;                           ///< Number of scenarios.
+    uint64_t seed = 1;                                 ///< Seed of the scenario streams.
+  };
+
+  /// @brief Aggregated result of all scenarios.
+  struct DemandForecast {
+    int64_t scenarios = 0;                                ///< Number of scenarios run.
+    std::array<ClassForecast, WAGON_TYPE_COUNT> classes;  ///< Forecast for every class; classes without seats stay empty.
+
+    bool operator==(const DemandForecast&) const = default;
+  };
+
+  /**
+   * @brief Run random demand scenarios against a consist in parallel and aggregate the outcome.
+   *
+   * Every scenario starts from the consist and boards random groups with boardPassengersToMostAvailableWagon;
+   * a group that fits in no wagon of its class is rejected. Every worker copies the consist into its own
+   * scratch train, whose storage is reused from scenario to scenario, and adds the outcome to its own
+   * fixed-size accumulators, so a run allocates nothing per scenario and its memory does not depend on the
+   * number of scenarios. Scenario k draws from stream k of the seed, so the forecast is the same for any
+   * number of threads.
+   *
+   * @param consist The consist, including the passengers already on board.
+   * @param model The demand.
+   * @param pool The pool to run on.
+   * @return The forecast.
+   * @throws std::invalid_argument if the model is invalid.
+   */
+  DemandForecast forecastDemand(const Train& consist, const DemandModel& model, ThreadPool& pool);
+
+} // namespace lab2ComplexClass
+
+#endif // DEMAND_FORECAST_H
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "fleet_index.h"
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief Check a train id.
+   *
+   * @param trainId The id of the train.
+   * @throws std::out_of_range if there is no such train.
+   */
+  void FleetAvailabilityIndex::checkTrain(int trainId) const {
+    if (trainId < 0 || trainId >= getTrainCount()) {
+      throw std::out_of_range("Invalid train id.");
+    }
+  }
+
+  /**
+   * @brief Recompute the keys of a train and move it in the ordered sets.
+   *
+   * Classes whose keys did not change are left in place.
+   *
+   * @param trainId The id of the train.
+   */
+  void FleetAvailabilityIndex::reindex(int trainId) {
+    std::array<Availability, WAGON_TYPE_COUNT> current{};
+    for (const Wagon& wagon : trains[trainId].view()) {
+      Availability& entry = current[static_cast<int>(wagon.getType())];
+      int free = wagon.getMaxCapacity() - wagon.getOccupiedSeats();
+      entry.freeSeats += free;
+      entry.largestWagonFree = std::max(entry.largestWagonFree, free);
+    }
+
+    for (int type = 0; type < WAGON_TYPE_COUNT; type++) {
+      Availability& stored = availability[trainId][type];
+      if (stored.freeSeats != current[type].freeSeats) {
+        byFreeSeats[type].erase({stored.freeSeats, trainId});
+        byFreeSeats[type].insert({current[type].freeSeats, trainId});
+      }
+      if (stored.largestWagonFree != current[type].largestWagonFree) {
+        byLargestWagon[type].erase({stored.largestWagonFree, trainId});
+        byLargestWagon[type].insert({current[type].largestWagonFree, trainId});
+      }
+      stored = current[type];
+    }
+  }
+
+  /**
+   * @brief Collect the train ids of a set with keys of at least a number of seats.
+   *
+   * @param index The set to search.
+   * @param seats The smallest number of seats.
+   * @return The train ids in increasing order of seats.
+   */
+  std::vector<int> FleetAvailabilityIndex::collectFrom(const std::set<Key>& index, int seats) {
+    std::vector<int> found;
+    for (auto it = index.lower_bound({seats, std::numeric_limits<int>::min()}); it != index.end(); ++it) {
+      found.push_back(it->second);
+    }
+    return found;
+  }
+
+  /**
+   * @brief Add a train to the fleet.
+   *
+   * @param train The train.
+   * @return The id of the train; ids are assigned from 0 in order.
+   */
+  int FleetAvailabilityIndex::addTrain(Train train) {
+    int trainId = getTrainCount();
+    trains.push_back(std::move(train));
+    availability.emplace_back();
+    for (int type = 0; type < WAGON_TYPE_COUNT; type++) {
+      byFreeSeats[type].insert({0, trainId});
+      byLargestWagon[type].insert({0, trainId});
+    }
+    reindex(trainId);
+    return trainId;
+  }
+
+  /**
+   * @brief Get the number of trains.
+   *
+   * @return The number of trains.
+   */
+  int FleetAvailabilityIndex::getTrainCount() const { return static_cast<int>(trains.size()); }
+
+  /**
+   * @brief Get a train.
+   *
+   * @param trainId The id of the train.
+   * @return A read-only reference to the train.
+   * @throws std::out_of_range if there is no such train.
+   */
+  const Train& FleetAvailabilityIndex::getTrain(int trainId) const {
+    checkTrain(trainId);
+    return trains[trainId];
+  }
+
+  /**
+   * @brief Get the free seats of a class in a train as kept in the index.
+   *
+   * @param trainId The id of the train.
+   * @param wagonType The class of wagon.
+   * @return The free seats of all wagons of the class.
+   * @throws std::out_of_range if there is no such train.
+   */
+  int FleetAvailabilityIndex::getFreeSeats(int trainId, WagonType wagonType) const {
+    checkTrain(trainId);
+    return availability[trainId][static_cast<int>(wagonType)].freeSeats;
+  }
+
+  /**
+   * @brief Get the most free seats in a single wagon of a class as kept in the index.
+   *
+   * @param trainId The id of the train.
+   * @param wagonType The class of wagon.
+   * @return The free seats of the freest wagon of the class, 0 if there is none.
+   * @throws std::out_of_range if there is no such train.
+   */
+  int FleetAvailabilityIndex::getLargestWagonFreeSeats(int trainId, WagonType wagonType) const {
+    checkTrain(trainId);
+    return availability[trainId][static_cast<int>(wagonType)].largestWagonFree;
+  }
+
+  /**
+   * @brief Find the trains with at least a number of free seats of a class.
+   *
+   * @param wagonType The class of wagon.
+   * @param seats The smallest number of free seats.
+   * @return The train ids, ordered by free seats and then by id.
+   */
+  std::vector<int> FleetAvailabilityIndex::findTrainsWithFreeSeats(WagonType wagonType, int seats) const {
+    return collectFrom(byFreeSeats[static_cast<int>(wagonType)], seats);
+  }
+
+  /**
+   * @brief Find the trains where a single wagon of a class has at least a number of free seats.
+   *
+   * These are exactly the trains where boardPassengersToMostAvailableWagon would succeed. Every train is keyed at
+   * 0 free seats even without a wagon of the class, so queries for no seats are checked against the trains.
+   *
+   * @param wagonType The class of wagon.
+   * @param seats The smallest number of free seats in one wagon.
+   * @return The train ids, ordered by free seats and then by id.
+   */
+  std::vector<int> FleetAvailabilityIndex::findTrainsWithWagonFreeSeats(WagonType wagonType, int seats) const {
+    std::vector<int> found = collectFrom(byLargestWagon[static_cast<int>(wagonType)], seats);
+    if (seats <= 0) {
+      std::erase_if(found, [&](int trainId) { return !trains[trainId].hasWagonWithRoom(seats, wagonType); });
+    }
+    return found;
+  }
+
+  /**
+   * @brief Board passengers into a train like Train::boardPassengersToMostAvailableWagon and update the index.
+   *
+   * @param trainId The id of the train.
+   * @param passengers The number of passengers to board.
+   * @param wagonType The class of wagon.
+   * @throws std::out_of_range if there is no such train.
+   * @throws std::invalid_argument if the train cannot take the passengers.
+   */
+  void FleetAvailabilityIndex::boardPassengersToMostAvailableWagon(int trainId, int passengers, WagonType wagonType) {
+    modifyTrain(trainId, [&](Train& train) { train.boardPassengersToMostAvailableWagon(passengers, wagonType); });
+  }
+
+  /**
+   * @brief Board a group like Train::boardGroupToAdjacentWagons and update the index.
+   *
+   * @param trainId The id of the train.
+   * @param passengers The number of passengers in the group.
+   * @param wagonType The class of wagon.
+   * @return The index of the first wagon and the number of wagons.
+   * @throws std::out_of_range if there is no such train.
+   * @throws std::invalid_argument if the group does not fit.
+   */
+  std::pair<int, int> FleetAvailabilityIndex::boardGroupToAdjacentWagons(int trainId, int passengers, WagonType wagonType) {
+    std::pair<int, int> run;
+    modifyTrain(trainId, [&](Train& train) { run = train.boardGroupToAdjacentWagons(passengers, wagonType); });
+    return run;
+  }
+
+} // namespace lab2ComplexClass
@@ -0,0 +1,170 @@
+#ifndef FLEET_INDEX_H
+#define FLEET_INDEX_H
+
+#include <array>
+#include <set>
+#include <utility>
+#include <vector>
+#include "train.h"
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief A fleet of trains indexed by free seats of every wagon class.
+   *
+   * For each WagonType the index keeps two ordered sets of (seats, train id): one keyed by the free seats of
+   * all wagons of the class and one keyed by the most free seats in a single wagon of the class. A query for
+   * trains with at least k free seats is a lower_bound plus a walk over the answer, O(log T + output) for T
+   * trains. Every mutation goes through the index, which re-keys the touched train in O(wagons + log T).
+   */
+  class FleetAvailabilityIndex {
+    private:
+      /// @brief Free seats of one class in one train.
+      struct Availability {
+        int freeSeats = 0;         // Свободные места во всех вагонах класса
+        int largestWagonFree = 0;  // Наибольшее число свободных мест в одном вагоне класса
+      };
+
+      using Key = std::pair<int, int>; // Свободные места и номер поезда
+
+      std::vector<Train> trains;                                              // Поезда парка по номерам
+      std::vector<std::array<Availability, WAGON_TYPE_COUNT>> availability;   // Текущие ключи каждого поезда
+      std::array<std::set<Key>, WAGON_TYPE_COUNT> byFreeSeats;                // Поезда по свободным местам класса
+      std::array<std::set<Key>, WAGON_TYPE_COUNT> byLargestWagon;             // Поезда по самому свободному вагону класса
+
+      /**
+       * @brief Check a train id.
+       *
+       * @param trainId The id of the train.
+       * @throws std::out_of_range if there is no such train.
+       */
+      void checkTrain(int trainId) const;
+
+      /**
+       * @brief Recompute the keys of a train and move it in the ordered sets.
+       *
+       * @param trainId The id of the train.
+       */
+      void reindex(int trainId);
+
+      /**
+       * @brief Collect the train ids of a set with keys of at least a number of seats.
+       *
+       * @param index The set to search.
+       * @param seats The smallest number of seats.
+       * @return The train ids in increasing order of seats.
+       */
+      static std::vector<int> collectFrom(const std::set<Key>& index, int seats);
+
+    public:
+      /**
+       * @brief Add a train to the fleet.
+       *
+       * @param train The train.
+       * @return The id of the train; ids are assigned from 0 in order.
+       */
+      int addTrain(Train train);
+
+      /**
+       * @brief Get the number of trains.
+       *
+       * @return The number of trains.
+       */
+      int getTrainCount() const;
+
+      /**
+       * @brief Get a train.
+       *
+       * @param trainId The id of the train.
+       * @return A read-only reference to the train.
+       * @throws std::out_of_range if there is no such train.
+       */
+      const Train& getTrain(int trainId) const;
+
+      /**
+       * @brief Get the free seats of a class in a train as kept in the index.
+       *
+       * @param trainId The id of the train.
+       * @param wagonType The class of wagon.
+       * @return The free seats of all wagons of the class.
+       * @throws std::out_of_range if there is no such train.
+       */
+      int getFreeSeats(int trainId, WagonType wagonType) const;
+
+      /**
+       * @brief Get the most free seats in a single wagon of a class as kept in the index.
+       *
+       * @param trainId The id of the train.
+       * @param wagonType The class of wagon.
+       * @return The free seats of the freest wagon of the class, 0 if there is none.
+       * @throws std::out_of_range if there is no such train.
+       */
+      int getLargestWagonFreeSeats(int trainId, WagonType wagonType) const;
+
+      /**
+       * @brief Find the trains with at least a number of free seats of a class.
+       *
+       * @param wagonType The class of wagon.
+       * @param seats The smallest number of free seats.
+       * @return The train ids, ordered by free seats and then by id.
+       */
+      std::vector<int> findTrainsWithFreeSeats(WagonType wagonType, int seats) const;
+
+      /**
+       * @brief Find the trains where a single wagon of a class has at least a number of free seats.
+       *
+       * These are exactly the trains where boardPassengersToMostAvailableWagon would succeed. Every train is keyed at
+       * 0 free seats even without a wagon of the class, so queries for no seats are checked against the trains.
+       *
+       * @param wagonType The class of wagon.
+       * @param seats The smallest number of free seats in one wagon.
+       * @return The train ids, ordered by free seats and then by id.
+       */
+      std::vector<int> findTrainsWithWagonFreeSeats(WagonType wagonType, int seats) const;
+
+      /**
+       * @brief Board passengers into a train like Train::boardPassengersToMostAvailableWagon and update the index.
+       *
+       * @param trainId The id of the train.
+       * @param passengers The number of passengers to board.
+       * @param wagonType The class of wagon.
+       * @throws std::out_of_range if there is no such train.
+       * @throws std::invalid_argument if the train cannot take the passengers.
+       */
+      void boardPassengersToMostAvailableWagon(int trainId, int passengers, WagonType wagonType);
+
+      /**
+       * @brief Board a group like Train::boardGroupToAdjacentWagons and update the index.
+       *
+       * @param trainId The id of the train.
+       * @param passengers The number of passengers in the group.
+       * @param wagonType The class of wagon.
+       * @return The index of the first wagon and the number of wagons.
+       * @throws std::out_of_range if there is no such train.
+       * @throws std::invalid_argument if the group does not fit.
+       */
+      std::pair<int, int> boardGroupToAdjacentWagons(int trainId, int passengers, WagonType wagonType);
+
+      /**
+       * @brief Apply any change to a train and update the index, also when the change throws.
+       *
+       * @param trainId The id of the train.
+       * @param change A callable taking Train&.
+       * @throws std::out_of_range if there is no such train.
+       */
+      template <typename Change>
+      void modifyTrain(int trainId, Change&& change) {
+        checkTrain(trainId);
+        try {
+          change(trains[trainId]);
+        } catch (...) {
+          reindex(trainId);
+          throw;
+        }
+        reindex(trainId);
+      }
+  };
+
+} // namespace lab2ComplexClass
+
+#endif // FLEET_INDEX_H
@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <vector>
+#include "fleet_operations.h"
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief Apply one operation to a train.
+   *
+   * @param train The train to change.
+   * @param operation The operation.
+   */
+  void applyFleetOperation(Train& train, FleetOperation operation) {
+    switch (operation) {
+      case FleetOperation::REDISTRIBUTE_PASSENGERS:
+        train.redistributePassengers();
+        break;
+      case FleetOperation::OPTIMIZE_TRAIN:
+        train.optimizeTrain();
+        break;
+      case FleetOperation::OPTIMIZE_RESTAURANT_PLACEMENT:
+        train.optimizeRestaurantPlacement();
+        break;
+    }
+  }
+
+  /**
+   * @brief Apply a sequence of operations to every train of a fleet in parallel.
+   *
+   * @param fleet The trains to change.
+   * @param operations The operations to apply to each train, in order.
+   * @param pool The pool to run on.
+   */
+  void runFleetOperations(std::span<Train> fleet, std::span<const FleetOperation> operations, ThreadPool& pool) {
+    // Большие поезда ставятся в очередь первыми, чтобы в конце оставались только короткие задачи
+    std::vector<int> order(fleet.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return fleet[a].getNumWagons() > fleet[b].getNumWagons(); });
+
+    std::exception_ptr firstError;
+    int firstErrorTrain = static_cast<int>(fleet.size());
+    std::mutex errorMutex;
+    pool.parallelFor(static_cast<int>(order.size()), [&](int task) {
+      int trainIndex = order[task];
+      try {
+        for (FleetOperation operation : operations) {
+          applyFleetOperation(fleet[trainIndex], operation);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (trainIndex < firstErrorTrain) {
+          firstError = std::current_exception();
+          firstErrorTrain = trainIndex;
+        }
+      }
+    });
+    if (firstError) {
+      std::rethrow_exception(firstError);
+    }
+  }
+
+} // namespace lab2ComplexClass
@@ -0,0 +1,38 @@
+#ifndef FLEET_OPERATIONS_H
+#define FLEET_OPERATIONS_H
+
+#include <span>
+#include "thread_pool.h"
+#include "train.h"
+
+namespace lab2ComplexClass {
+
+  /// @brief Whole-train operations that can be run over a fleet.
+  enum class FleetOperation { REDISTRIBUTE_PASSENGERS, OPTIMIZE_TRAIN, OPTIMIZE_RESTAURANT_PLACEMENT };
+
+  /**
+   * @brief Apply a sequence of operations to every train of a fleet in parallel.
+   *
+   * Each train is one task that applies all operations in order, so trains never share state and the
+   * result is the same as the sequential loop for any number of threads. The tasks are queued from the
+   * largest train to the smallest, and work stealing spreads the tail of small trains over idle workers.
+   * If operations throw, every train is still processed and the exception of the lowest-indexed failing
+   * train is rethrown.
+   *
+   * @param fleet The trains to change.
+   * @param operations The operations to apply to each train, in order.
+   * @param pool The pool to run on.
+   */
+  void runFleetOperations(std::span<Train> fleet, std::span<const FleetOperation> operations, ThreadPool& pool);
+
+  /**
+   * @brief Apply one operation to a train.
+   *
+   * @param train The train to change.
+   * @param operation The operation.
+   */
+  void applyFleetOperation(Train& train, FleetOperation operation);
+
+} // namespace lab2ComplexClass
+
+#endif // FLEET_OPERATIONS_H
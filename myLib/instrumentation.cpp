@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "instrumentation.h"
+
+namespace lab2Instrumentation {
+
+  namespace {
+
+    /**
+     * @brief Statistics owned by one thread.
+     *
+     * The owning thread is the only writer, so updates are plain relaxed load/store pairs without
+     * read-modify-write instructions; the atomics only make concurrent snapshots well-defined.
+     */
+    struct ThreadStats {
+      std::atomic<uint64_t> counters[COUNTER_COUNT] = {};
+      std::atomic<uint64_t> calls[OP_COUNT] = {};
+      std::atomic<uint64_t> totalNanoseconds[OP_COUNT] = {};
+      std::atomic<uint64_t> histogram[OP_COUNT][LatencyBuckets::COUNT] = {};
+    };
+
+    /// @brief Add to a single-writer counter.
+    inline void bump(std::atomic<uint64_t>& value, uint64_t amount) {
+      value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    /// @brief Registry of the statistics of all live threads plus the totals of finished threads.
+    struct Registry {
+      std::mutex mutex;
+      std::vector<ThreadStats*> live;
+      Snapshot retired;
+    };
+
+    Registry& registry() {
+      static Registry instance;
+      return instance;
+    }
+
+    /// @brief Add the statistics of one thread to a snapshot.
+    void accumulate(Snapshot& into, const ThreadStats& stats) {
+      for (int c = 0; c < COUNTER_COUNT; c++) {
+        into.counters[c] += stats.counters[c].load(std::memory_order_relaxed);
+      }
+      for (int op = 0; op < OP_COUNT; op++) {
+        into.ops[op].calls += stats.calls[op].load(std::memory_order_relaxed);
+        into.ops[op].totalNanoseconds += stats.totalNanoseconds[op].load(std::memory_order_relaxed);
+        for (int b = 0; b < LatencyBuckets::COUNT; b++) {
+          into.ops[op].histogram[b] += stats.histogram[op][b].load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    /**
+     * @brief Per-thread owner of the statistics: registers them on first use and folds them
+     * into the retired totals when the thread exits.
+     */
+    struct ThreadSlot {
+      std::unique_ptr<ThreadStats> stats = std::make_unique<ThreadStats>();
+
+      ThreadSlot() {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.live.push_back(stats.get());
+      }
+
+      ~ThreadSlot() {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        accumulate(reg.retired, *stats);
+        std::erase(reg.live, stats.get());
+      }
+    };
+
+    ThreadStats& threadStats() {
+      thread_local ThreadSlot slot;
+      return *slot.stats;
+    }
+
+  } // namespace
+
+  /**
+   * @brief Get the bucket of a latency.
+   *
+   * @param nanoseconds The latency.
+   * @return The bucket index in [0, COUNT).
+   */
+  int LatencyBuckets::indexOf(uint64_t nanoseconds) {
+    if (nanoseconds < static_cast<uint64_t>(SUB_BUCKETS)) {
+      return static_cast<int>(nanoseconds);
+    }
+    if (nanoseconds >= (uint64_t(1) << MAX_EXPONENT)) {
+      return COUNT - 1;
+    }
+    int exponent = std::bit_width(nanoseconds) - 1;
+    int sub = static_cast<int>(nanoseconds >> (exponent - SUB_BUCKET_BITS)) - SUB_BUCKETS;
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+  }
+
+  /**
+   * @brief Get the largest latency that falls into a bucket.
+   *
+   * @param index The bucket index.
+   * @return The upper bound of the bucket in nanoseconds.
+   */
+  uint64_t LatencyBuckets::upperBound(int index) {
+    if (index < SUB_BUCKETS) {
+      return static_cast<uint64_t>(index);
+    }
+    int exponent = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    int sub = index % SUB_BUCKETS;
+    uint64_t width = uint64_t(1) << (exponent - SUB_BUCKET_BITS);
+    return (static_cast<uint64_t>(SUB_BUCKETS + sub) << (exponent - SUB_BUCKET_BITS)) + width - 1;
+  }
+
+  /**
+   * @brief Get the zero-based index of a percentile among sorted samples (nearest-rank method).
+   *
+   * The rank is ceil(fraction * count), counting from 1, so the median of two samples is the smaller one and p99
+   * of fewer than 100 samples is not always the maximum.
+   *
+   * @param fraction The percentile as a fraction in [0, 1].
+   * @param count The number of samples, positive.
+   * @return The index of the sample of that rank, clamped to [0, count).
+   */
+  uint64_t nearestRankIndex(double fraction, uint64_t count) {
+    // The tolerance keeps products like 0.999 * 1000 from rounding up to the next rank
+    double rank = std::ceil(fraction * static_cast<double>(count) - 1e-9);
+    uint64_t index = rank <= 1 ? 0 : static_cast<uint64_t>(rank) - 1;
+    return std::min(index, count - 1);
+  }
+
+  /**
+   * @brief Estimate a latency percentile from the histogram.
+   *
+   * @param fraction The percentile as a fraction in [0, 1].
+   * @return The upper bound of the bucket containing the percentile, or 0 if there were no calls.
+   */
+  uint64_t OpStats::percentile(double fraction) const {
+    if (calls == 0) {
+      return 0;
+    }
+    uint64_t rank = nearestRankIndex(fraction, calls);
+    uint64_t seen = 0;
+    for (int b = 0; b < LatencyBuckets::COUNT; b++) {
+      seen += histogram[b];
+      if (seen > rank) {
+        return LatencyBuckets::upperBound(b);
+      }
+    }
+    return LatencyBuckets::upperBound(LatencyBuckets::COUNT - 1);
+  }
+
+  /**
+   * @brief Get the name of an operation as used in exports.
+   *
+   * @param op The operation.
+   * @return The name.
+   */
+  const char* opName(Op op) {
+    switch (op) {
+      case Op::WAGON_BOARD: return "Wagon::boardPassengers";
+      case Op::WAGON_DISEMBARK: return "Wagon::disembarkPassengers";
+      case Op::WAGON_TRANSFER: return "Wagon::transferPassengers";
+      case Op::WAGON_SET_MAX_CAPACITY: return "Wagon::setMaxCapacity";
+      case Op::WAGON_SET_OCCUPIED_SEATS: return "Wagon::setOccupiedSeats";
+      case Op::WAGON_SET_TYPE: return "Wagon::setType";
+      case Op::WAGON_READ: return "Wagon::operator>>";
+      case Op::WAGON_WRITE: return "Wagon::operator<<";
+      case Op::TRAIN_COPY: return "Train::Train(const Train&)";
+      case Op::TRAIN_COPY_ASSIGN: return "Train::operator=";
+      case Op::TRAIN_SET_NUM_WAGONS: return "Train::setNumWagons";
+      case Op::TRAIN_SET_WAGONS: return "Train::setWagons";
+      case Op::TRAIN_SET_CAPACITY: return "Train::setCapacity";
+      case Op::TRAIN_ADD_WAGON: return "Train::addWagon";
+      case Op::TRAIN_ADD_WAGON_AT_INDEX: return "Train::addWagonAtIndex";
+      case Op::TRAIN_APPEND: return "Train::append";
+      case Op::TRAIN_REMOVE_WAGON: return "Train::removeWagonByIndex";
+      case Op::TRAIN_BOARD_MOST_AVAILABLE: return "Train::boardPassengersToMostAvailableWagon";
+      case Op::TRAIN_BOARD_GROUP: return "Train::boardGroupToAdjacentWagons";
+      case Op::TRAIN_PASSENGER_COUNT_BY_TYPE: return "Train::getPassengerCountByType";
+      case Op::TRAIN_REDISTRIBUTE: return "Train::redistributePassengers";
+      case Op::TRAIN_OPTIMIZE: return "Train::optimizeTrain";
+      case Op::TRAIN_RESTAURANT_PLACEMENT: return "Train::optimizeRestaurantPlacement";
+      case Op::TRAIN_READ: return "Train::operator>>";
+      case Op::TRAIN_WRITE: return "Train::operator<<";
+      case Op::COUNT: break;
+    }
+    return "unknown";
+  }
+
+  /**
+   * @brief Get the name of a counter as used in exports.
+   *
+   * @param counter The counter.
+   * @return The name.
+   */
+  const char* counterName(Counter counter) {
+    switch (counter) {
+      case Counter::TRAIN_REALLOCATIONS: return "trainReallocations";
+      case Counter::WAGONS_SCANNED_FOR_BOARDING: return "wagonsScannedForBoarding";
+      case Counter::WAGONS_REMOVED_BY_OPTIMIZE: return "wagonsRemovedByOptimize";
+      case Counter::COUNT: break;
+    }
+    return "unknown";
+  }
+
+  /**
+   * @brief Record one call of an operation in the statistics of the calling thread.
+   *
+   * @param op The operation.
+   * @param nanoseconds The latency of the call.
+   */
+  void recordLatency(Op op, uint64_t nanoseconds) {
+    ThreadStats& stats = threadStats();
+    int index = static_cast<int>(op);
+    bump(stats.calls[index], 1);
+    bump(stats.totalNanoseconds[index], nanoseconds);
+    bump(stats.histogram[index][LatencyBuckets::indexOf(nanoseconds)], 1);
+  }
+
+  /**
+   * @brief Add to an event counter of the calling thread.
+   *
+   * @param counter The counter.
+   * @param amount The amount to add.
+   */
+  void addCounter(Counter counter, uint64_t amount) {
+    bump(threadStats().counters[static_cast<int>(counter)], amount);
+  }
+
+  /**
+   * @brief Aggregate the statistics of all live and finished threads.
+   *
+   * @return The aggregated snapshot.
+   */
+  Snapshot snapshot() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    Snapshot result = reg.retired;
+    for (const ThreadStats* stats : reg.live) {
+      accumulate(result, *stats);
+    }
+    return result;
+  }
+
+  /**
+   * @brief Reset the statistics of all threads to zero.
+   */
+  void reset() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.retired = Snapshot();
+    for (ThreadStats* stats : reg.live) {
+      for (auto& counter : stats->counters) {
+        counter.store(0, std::memory_order_relaxed);
+      }
+      for (int op = 0; op < OP_COUNT; op++) {
+        stats->calls[op].store(0, std::memory_order_relaxed);
+        stats->totalNanoseconds[op].store(0, std::memory_order_relaxed);
+        for (auto& bucket : stats->histogram[op]) {
+          bucket.store(0, std::memory_order_relaxed);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Write a snapshot as JSON.
+   *
+   * @param os The output stream.
+   * @param snapshot The snapshot to write.
+   * @return The output stream.
+   */
+  std::ostream& writeJson(std::ostream& os, const Snapshot& snapshot) {
+    os << "{\"counters\":{";
+    for (int c = 0; c < COUNTER_COUNT; c++) {
+      os << (c == 0 ? "" : ",") << '"' << counterName(static_cast<Counter>(c)) << "\":" << snapshot.counters[c];
+    }
+    os << "},\"operations\":{";
+    bool first = true;
+    for (int op = 0; op < OP_COUNT; op++) {
+      const OpStats& stats = snapshot.ops[op];
+      if (stats.calls == 0) {
+        continue;
+      }
+      os << (first ? "" : ",") << '"' << opName(static_cast<Op>(op)) << "\":{"
+         << "\"calls\":" << stats.calls
+         << ",\"meanNs\":" << stats.totalNanoseconds / stats.calls
+         << ",\"p50Ns\":" << stats.percentile(0.50)
+         << ",\"p99Ns\":" << stats.percentile(0.99)
+         << ",\"p999Ns\":" << stats.percentile(0.999) << '}';
+      first = false;
+    }
+    os << "}}";
+    return os;
+  }
+
+} // namespace lab2Instrumentation
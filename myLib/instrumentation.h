@@ -0,0 +1,180 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+
+namespace lab2Instrumentation {
+
+  /// @brief Enumeration for the instrumented public Train and Wagon operations.
+  enum class Op {
+    WAGON_BOARD, WAGON_DISEMBARK, WAGON_TRANSFER, WAGON_SET_MAX_CAPACITY, WAGON_SET_OCCUPIED_SEATS, WAGON_SET_TYPE,
+    WAGON_READ, WAGON_WRITE,
+    TRAIN_COPY, TRAIN_COPY_ASSIGN, TRAIN_SET_NUM_WAGONS, TRAIN_SET_WAGONS, TRAIN_SET_CAPACITY,
+    TRAIN_ADD_WAGON, TRAIN_ADD_WAGON_AT_INDEX, TRAIN_APPEND, TRAIN_REMOVE_WAGON, TRAIN_BOARD_MOST_AVAILABLE, TRAIN_BOARD_GROUP,
+    TRAIN_PASSENGER_COUNT_BY_TYPE, TRAIN_REDISTRIBUTE, TRAIN_OPTIMIZE, TRAIN_RESTAURANT_PLACEMENT,
+    TRAIN_READ, TRAIN_WRITE,
+    COUNT
+  };
+
+  /// @brief Enumeration for the event counters that are not tied to a single call.
+  enum class Counter {
+    TRAIN_REALLOCATIONS,        ///< Reallocations of a wagon array on any growth path.
+    WAGONS_SCANNED_FOR_BOARDING, ///< Wagons inspected by boardPassengersToMostAvailableWagon and boardGroupToAdjacentWagons.
+    WAGONS_REMOVED_BY_OPTIMIZE, ///< Wagons removed by optimizeTrain.
+    COUNT
+  };
+
+  /// @brief Number of instrumented operations.
+  constexpr int OP_COUNT = static_cast<int>(Op::COUNT);
+
+  /// @brief Number of event counters.
+  constexpr int COUNTER_COUNT = static_cast<int>(Counter::COUNT);
+
+  /**
+   * @brief Log-linear (HDR-style) latency bucketing.
+   *
+   * Values below 2^SUB_BUCKET_BITS nanoseconds get one bucket each; every following power of two is split
+   * into 2^SUB_BUCKET_BITS equal buckets, which bounds the relative error of a bucket to 1/2^SUB_BUCKET_BITS.
+   * Values at or above 2^MAX_EXPONENT nanoseconds fall into the last bucket.
+   */
+  struct LatencyBuckets {
+    static constexpr int SUB_BUCKET_BITS = 3;                         ///< 8 buckets per power of two (12.5% precision).
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;          ///< Buckets per power of two.
+    static constexpr int MAX_EXPONENT = 40;                           ///< Largest tracked latency is about 18 minutes.
+    static constexpr int COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS; ///< Total number of buckets.
+
+    /// @brief Get the bucket of a latency.
+    /// @param nanoseconds The latency.
+    /// @return The bucket index in [0, COUNT).
+    static int indexOf(uint64_t nanoseconds);
+
+    /// @brief Get the largest latency that falls into a bucket.
+    /// @param index The bucket index.
+    /// @return The upper bound of the bucket in nanoseconds.
+    static uint64_t upperBound(int index);
+  };
+
+  /// @brief Get the zero-based index of a percentile among sorted samples (nearest-rank method).
+  /// @param fraction The percentile as a fraction in [0, 1].
+  /// @param count The number of samples, positive.
+  /// @return The index of the sample of rank ceil(fraction * count), clamped to [0, count).
+  uint64_t nearestRankIndex(double fraction, uint64_t count);
+
+  /// @brief Aggregated statistics of one operation.
+  struct OpStats {
+    uint64_t calls = 0;                              ///< Number of calls.
+    uint64_t totalNanoseconds = 0;                   ///< Sum of all latencies.
+    uint64_t histogram[LatencyBuckets::COUNT] = {};  ///< Latency histogram.
+
+    /// @brief Estimate a latency percentile from the histogram.
+    /// @param fraction The percentile as a fraction in [0, 1].
+    /// @return The upper bound of the bucket containing the percentile, or 0 if there were no calls.
+    uint64_t percentile(double fraction) const;
+  };
+
+  /// @brief Statistics of all threads aggregated at one point in time.
+  struct Snapshot {
+    uint64_t counters[COUNTER_COUNT] = {};  ///< Event counters indexed by Counter.
+    OpStats ops[OP_COUNT];                  ///< Operation statistics indexed by Op.
+  };
+
+  /// @brief Get the name of an operation as used in exports.
+  /// @param op The operation.
+  /// @return The name.
+  const char* opName(Op op);
+
+  /// @brief Get the name of a counter as used in exports.
+  /// @param counter The counter.
+  /// @return The name.
+  const char* counterName(Counter counter);
+
+  /**
+   * @brief Record one call of an operation in the statistics of the calling thread.
+   *
+   * Only the calling thread writes its statistics, so recording takes no lock.
+   *
+   * @param op The operation.
+   * @param nanoseconds The latency of the call.
+   */
+  void recordLatency(Op op, uint64_t nanoseconds);
+
+  /**
+   * @brief Add to an event counter of the calling thread.
+   *
+   * @param counter The counter.
+   * @param amount The amount to add.
+   */
+  void addCounter(Counter counter, uint64_t amount);
+
+  /**
+   * @brief Aggregate the statistics of all live and finished threads.
+   *
+   * @return The aggregated snapshot.
+   */
+  Snapshot snapshot();
+
+  /**
+   * @brief Reset the statistics of all threads to zero.
+   *
+   * Calls recorded concurrently with the reset may be lost; intended for tests and between measurement windows.
+   */
+  void reset();
+
+  /**
+   * @brief Write a snapshot as JSON (counters, and per operation: calls, mean, p50, p99, p999).
+   *
+   * Operations that were never called are omitted.
+   *
+   * @param os The output stream.
+   * @param snapshot The snapshot to write.
+   * @return The output stream.
+   */
+  std::ostream& writeJson(std::ostream& os, const Snapshot& snapshot);
+
+  /**
+   * @brief RAII timer recording the latency of the enclosing scope as one call of an operation.
+   *
+   * The timer is a literal type and does nothing during constant evaluation, so instrumented operations
+   * stay usable in constexpr contexts.
+   */
+  class ScopedOpTimer {
+    private:
+      Op op;                                            // Измеряемая операция
+      std::chrono::steady_clock::time_point start{};    // Момент начала вызова
+
+    public:
+      /// @brief Start timing an operation.
+      /// @param op The operation.
+      constexpr explicit ScopedOpTimer(Op op) : op(op) {
+        if (!std::is_constant_evaluated()) {
+          start = std::chrono::steady_clock::now();
+        }
+      }
+
+      /// @brief Record the elapsed time.
+      constexpr ~ScopedOpTimer() {
+        if (!std::is_constant_evaluated()) {
+          recordLatency(op, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start).count()));
+        }
+      }
+
+      ScopedOpTimer(const ScopedOpTimer&) = delete;
+      ScopedOpTimer& operator=(const ScopedOpTimer&) = delete;
+  };
+
+} // namespace lab2Instrumentation
+
+// Хуки инструментирования: при сборке без TRAIN_INSTRUMENTATION полностью исчезают из кода
+#ifdef TRAIN_INSTRUMENTATION
+#define TRAIN_INSTR_OP(op) ::lab2Instrumentation::ScopedOpTimer trainInstrTimer(::lab2Instrumentation::Op::op)
+#define TRAIN_INSTR_COUNT(counter, amount) ::lab2Instrumentation::addCounter(::lab2Instrumentation::Counter::counter, static_cast<uint64_t>(amount))
+#else
+#define TRAIN_INSTR_OP(op) ((void)0)
+#define TRAIN_INSTR_COUNT(counter, amount) ((void)0)
+#endif
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,65 @@
+#include <iostream>
+#include "memory_report.h"
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief Get the share of the owned memory that is slack.
+   *
+   * @return The wasted fraction in [0, 1], or 0 if the fleet owns no memory.
+   */
+  double FleetMemoryReport::getWastedFraction() const {
+    if (bytesUsed == 0) {
+      return 0.0;
+    }
+    return static_cast<double>(slackBytes) / static_cast<double>(bytesUsed);
+  }
+
+  /**
+   * @brief Collect the memory accounting of every train of a fleet.
+   *
+   * @param trains An array of trains.
+   * @param numTrains The number of trains in the array.
+   * @return The fleet memory report.
+   * @throws std::invalid_argument if numTrains is negative.
+   */
+  FleetMemoryReport reportFleetMemory(const Train trains[], int numTrains) {
+    if (numTrains < 0) {
+      throw std::invalid_argument("Number of trains cannot be negative.");
+    }
+
+    FleetMemoryReport report;
+    report.numTrains = numTrains;
+    for (int i = 0; i < numTrains; i++) {
+      const Train& train = trains[i];
+      report.numWagons += train.getNumWagons();
+      report.capacity += train.getCapacity();
+      report.bytesUsed += train.bytesUsed();
+      report.slackBytes += train.slack();
+      if (report.mostWastefulTrain < 0 || train.slack() > report.mostWastefulSlack) {
+        report.mostWastefulTrain = i;
+        report.mostWastefulSlack = train.slack();
+      }
+    }
+    return report;
+  }
+
+  /**
+   * @brief Overloaded output operator for writing a fleet memory report.
+   *
+   * @param os The output stream.
+   * @param report The report to write.
+   * @return The output stream.
+   */
+  std::ostream& operator<<(std::ostream& os, const FleetMemoryReport& report) {
+    os << "trains: " << report.numTrains << std::endl;
+    os << "wagons: " << report.numWagons << " of capacity " << report.capacity << std::endl;
+    os << "bytes used: " << report.bytesUsed << std::endl;
+    os << "slack bytes: " << report.slackBytes << " (" << report.getWastedFraction() * 100.0 << "%)" << std::endl;
+    if (report.mostWastefulTrain >= 0) {
+      os << "most wasteful train: " << report.mostWastefulTrain << " (" << report.mostWastefulSlack << " bytes)" << std::endl;
+    }
+    return os;
+  }
+
+} // namespace lab2ComplexClass
@@ -0,0 +1,46 @@
+#ifndef MEMORY_REPORT_H
+#define MEMORY_REPORT_H
+
+#include <cstddef>
+#include <iostream>
+#include "train.h"
+
+namespace lab2ComplexClass {
+
+  /// @brief Memory usage of a fleet of trains, with the wasted (reserved but unused) capacity.
+  struct FleetMemoryReport {
+    int numTrains = 0;              ///< Number of trains in the fleet.
+    long long numWagons = 0;        ///< Total number of wagons.
+    long long capacity = 0;         ///< Total capacity of the wagon arrays.
+    size_t bytesUsed = 0;           ///< Total heap memory owned by the trains.
+    size_t slackBytes = 0;          ///< Total memory reserved for wagons that are not in any train.
+    int mostWastefulTrain = -1;     ///< Index of the train with the largest slack, or -1 for an empty fleet.
+    size_t mostWastefulSlack = 0;   ///< Slack of that train in bytes.
+
+    /// @brief Get the share of the owned memory that is slack.
+    /// @return The wasted fraction in [0, 1].
+    double getWastedFraction() const;
+  };
+
+  /**
+   * @brief Collect the memory accounting of every train of a fleet.
+   *
+   * @param trains An array of trains.
+   * @param numTrains The number of trains in the array.
+   * @return The fleet memory report.
+   * @throws std::invalid_argument if numTrains is negative.
+   */
+  FleetMemoryReport reportFleetMemory(const Train trains[], int numTrains);
+
+  /**
+   * @brief Overloaded output operator for writing a fleet memory report.
+   *
+   * @param os The output stream.
+   * @param report The report to write.
+   * @return The output stream.
+   */
+  std::ostream& operator<<(std::ostream& os, const FleetMemoryReport& report);
+
+} // namespace lab2ComplexClass
+
+#endif // MEMORY_REPORT_H
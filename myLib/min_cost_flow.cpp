@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include "min_cost_flow.h"
+
+namespace lab2ComplexClass {
+
+  namespace {
+
+    /**
+     * @brief Breakpoints of one branch of a convex piecewise linear function, all moved by a common offset.
+     *
+     * @tparam Compare std::less keeps the largest breakpoint on top (left branch), std::greater the smallest.
+     */
+    template <typename Compare>
+    class Breakpoints {
+      private:
+        using Entry = std::pair<int64_t, int64_t>;
+        std::priority_queue<Entry, std::vector<Entry>, Compare> heap; // Точки излома и изменения наклона в них
+        int64_t offset = 0;                                           // Общий сдвиг точек излома
+
+      public:
+        void shift(int64_t delta) { offset += delta; }
+        void add(int64_t position, int64_t slope) { heap.push({position - offset, slope}); }
+        int64_t top() const { return heap.top().first + offset; }
+
+        /// @brief Remove one unit of slope from the top breakpoint and return its position.
+        int64_t takeTop() {
+          auto [position, slope] = heap.top();
+          heap.pop();
+          if (slope > 1) {
+            heap.push({position, slope - 1});
+          }
+          return position + offset;
+        }
+    };
+
+  } // namespace
+
+  /**
+   * @brief Send all supply to nodes with capacity along a path at minimum cost.
+   *
+   * g_i(f) is the least cost of nodes 0 .. i when f units leave node i to the right:
+   * g_i(f) = |f| + min over a in [0, capacity_i] of g_(i-1)(f - supply_i + a), with g_(-1) finite at 0 only.
+   * The minimum over a moves the left branch by -capacity_i, the supply moves both branches by supply_i and
+   * |f| adds one unit of slope on each side of 0. The walls of g_(-1) are a slope steeper than any path
+   * cost, which never pays off while the capacity covers the supply.
+   *
+   * @param supply Units every node has to send.
+   * @param capacity Units every node can take in.
+   * @return The flow.
+   * @throws std::invalid_argument if the sizes differ, a value is negative or the capacity is less than the supply.
+   */
+  PathFlow solvePathFlow(std::span<const int64_t> supply, std::span<const int64_t> capacity) {
+    if (supply.size() != capacity.size()) {
+      throw std::invalid_argument("Supply and capacity must have the same size.");
+    }
+    auto negative = [](int64_t units) { return units < 0; };
+    if (std::any_of(supply.begin(), supply.end(), negative) || std::any_of(capacity.begin(), capacity.end(), negative)) {
+      throw std::invalid_argument("Supply and capacity cannot be negative.");
+    }
+    if (std::accumulate(capacity.begin(), capacity.end(), int64_t{0}) < std::accumulate(supply.begin(), supply.end(), int64_t{0})) {
+      throw std::invalid_argument("Not enough capacity for the supply.");
+    }
+
+    size_t numNodes = supply.size();
+    PathFlow flow;
+    flow.absorbed.assign(numNodes, 0);
+    if (numNodes == 0) {
+      return flow;
+    }
+
+    Breakpoints<std::less<>> left;
+    Breakpoints<std::greater<>> right;
+    int64_t wall = static_cast<int64_t>(numNodes) + 1;
+    left.add(0, wall);
+    right.add(0, wall);
+    std::vector<int64_t> minimizer(numNodes); // Точка минимума g_i
+    for (size_t i = 0; i < numNodes; i++) {
+      left.shift(supply[i] - capacity[i]);
+      right.shift(supply[i]);
+      // Прибавление max(0, f), затем max(0, -f)
+      left.add(0, 1);
+      right.add(left.takeTop(), 1);
+      right.add(0, 1);
+      left.add(right.takeTop(), 1);
+      minimizer[i] = left.top();
+    }
+
+    // Из последней вершины вправо ничего не уходит; выше по пути берётся ближайшая к минимуму допустимая точка
+    std::vector<int64_t> outgoing(numNodes, 0);
+    for (size_t i = numNodes - 1; i > 0; i--) {
+      int64_t lowest = outgoing[i] - supply[i];
+      outgoing[i - 1] = std::clamp(minimizer[i - 1], lowest, lowest + capacity[i]);
+    }
+    int64_t incoming = 0;
+    for (size_t i = 0; i < numNodes; i++) {
+      flow.absorbed[i] = incoming + supply[i] - outgoing[i];
+      flow.cost += std::abs(outgoing[i]);
+      incoming = outgoing[i];
+    }
+    outgoing.pop_back();
+    flow.edgeFlow = std::move(outgoing);
+    return flow;
+  }
+
+} // namespace lab2ComplexClass
@@ -0,0 +1,35 @@
+#ifndef MIN_COST_FLOW_H
+#define MIN_COST_FLOW_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace lab2ComplexClass {
+
+  /// @brief A minimum-cost flow on a path network.
+  struct PathFlow {
+    std::vector<int64_t> edgeFlow;  ///< Flow on edge (i, i + 1); positive to the right, negative to the left.
+    std::vector<int64_t> absorbed;  ///< Units taken in by every node.
+    int64_t cost = 0;               ///< Sum of |edgeFlow|, i.e. units times the number of edges they cross.
+  };
+
+  /**
+   * @brief Send all supply to nodes with capacity along a path at minimum cost.
+   *
+   * Nodes 0 .. n - 1 lie on a line and moving a unit across an edge costs 1, so a unit from i to j costs
+   * |i - j|. Successive shortest paths would need a phase per distinct path length, which on a long line is
+   * O(n) phases of O(n) work each; here the least cost as a function of the flow on the last edge is convex
+   * and piecewise linear, so it is carried from node to node as two heaps of breakpoints (slope trick) in
+   * O(n log n), and the edge flows are recovered backwards from the minimizers.
+   *
+   * @param supply Units every node has to send.
+   * @param capacity Units every node can take in.
+   * @return The flow.
+   * @throws std::invalid_argument if the sizes differ, a value is negative or the capacity is less than the supply.
+   */
+  PathFlow solvePathFlow(std::span<const int64_t> supply, std::span<const int64_t> capacity);
+
+} // namespace lab2ComplexClass
+
+#endif // MIN_COST_FLOW_H
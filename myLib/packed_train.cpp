@@ -0,0 +1,8 @@
+#include "packed_train.h"
+
+namespace lab2ComplexClass {
+
+  // Единственная инстанциация PackedTrain, остальные единицы трансляции используют ее через extern template
+  template class BasicTrain<PackedWagon, HeapStorage>;
+
+} // namespace lab2ComplexClass
@@ -0,0 +1,23 @@
+#ifndef PACKED_TRAIN_H
+#define PACKED_TRAIN_H
+
+#include "packed_wagon.h"
+#include "train.h"
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief A train of packed 32-bit wagons for memory-bound fleet scans.
+   *
+   * The same BasicTrain algorithms run over PackedWagon, so counting and boarding give the same results as on
+   * a Train. Build one from a train with PackedTrain(train.view()), which is checked: every wagon must fit into
+   * the packed representation. Train(packed.view()) converts back.
+   */
+  using PackedTrain = BasicTrain<PackedWagon, HeapStorage>;
+
+  // Инстанциация в packed_train.cpp
+  extern template class BasicTrain<PackedWagon, HeapStorage>;
+
+} // namespace lab2ComplexClass
+
+#endif // PACKED_TRAIN_H
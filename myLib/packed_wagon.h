@@ -0,0 +1,133 @@
+#ifndef PACKED_WAGON_H
+#define PACKED_WAGON_H
+
+#include <cstdint>
+#include <stdexcept>
+#include "wagon.h"
+
+namespace lab2SimpleClass {
+
+  /**
+   * @brief A wagon packed into 32 bits: 15 bits of capacity, 15 bits of occupancy and 2 bits of type.
+   *
+   * A Wagon takes 12 bytes; the packed form takes 4, so scans over many wagons touch a third of the memory.
+   * Capacities and occupancies up to MAX_SEATS are representable; conversion from a larger Wagon is rejected.
+   */
+  class PackedWagon {
+  private:
+    uint32_t bits;  ///< Capacity in bits 0-14, occupancy in bits 15-29, type in bits 30-31.
+
+    static constexpr int SEAT_BITS = 15;                       ///< Width of the capacity and occupancy fields.
+    static constexpr uint32_t SEAT_MASK = (1u << SEAT_BITS) - 1; ///< Mask of one seat field.
+    static constexpr int OCCUPIED_SHIFT = SEAT_BITS;           ///< Offset of the occupancy field.
+    static constexpr int TYPE_SHIFT = 2 * SEAT_BITS;           ///< Offset of the type field.
+
+    /// @brief Build the bit pattern of a wagon; the values must already be validated.
+    static constexpr uint32_t pack(int maxCapacity, int occupiedSeats, WagonType type) {
+      return static_cast<uint32_t>(maxCapacity) | (static_cast<uint32_t>(occupiedSeats) << OCCUPIED_SHIFT) |
+             (static_cast<uint32_t>(type) << TYPE_SHIFT);
+    }
+
+  public:
+    /// @brief The largest capacity (and occupancy) a packed wagon can hold.
+    static constexpr int MAX_SEATS = static_cast<int>(SEAT_MASK);
+
+    /// @brief Default constructor, an empty restaurant wagon like Wagon().
+    constexpr PackedWagon() : bits(pack(0, 0, WagonType::RESTAURANT)) {}
+
+    /// @brief Checked conversion from a wagon.
+    /// @param wagon The wagon to pack.
+    /// @throws std::out_of_range if the capacity exceeds MAX_SEATS.
+    explicit constexpr PackedWagon(const Wagon& wagon) : bits(0) {
+      if (wagon.getMaxCapacity() > MAX_SEATS) {
+        throw std::out_of_range("Wagon capacity does not fit into a packed wagon.");
+      }
+      bits = pack(wagon.getMaxCapacity(), wagon.getOccupiedSeats(), wagon.getType());
+    }
+
+    /// @brief Equality operator.
+    /// @param other The other packed wagon.
+    /// @return True if capacity, occupancy and type are equal.
+    constexpr bool operator==(const PackedWagon& other) const { return bits == other.bits; }
+
+    /// @brief Convert back to a wagon; always succeeds.
+    /// @return The unpacked wagon.
+    constexpr Wagon toWagon() const { return Wagon(getMaxCapacity(), getOccupiedSeats(), getType()); }
+
+    /// @brief Explicit conversion to a wagon, so that a range of packed wagons can build a Train.
+    /// @return The unpacked wagon.
+    explicit constexpr operator Wagon() const { return toWagon(); }
+
+    /// @brief Get the maximum capacity.
+    /// @return Maximum capacity.
+    constexpr int getMaxCapacity() const { return static_cast<int>(bits & SEAT_MASK); }
+
+    /// @brief Get the number of occupied seats.
+    /// @return Number of occupied seats.
+    constexpr int getOccupiedSeats() const { return static_cast<int>((bits >> OCCUPIED_SHIFT) & SEAT_MASK); }
+
+    /// @brief Get the number of free seats.
+    /// @return Capacity minus occupancy.
+    constexpr int getFreeSeats() const { return getMaxCapacity() - getOccupiedSeats(); }
+
+    /// @brief Get the type.
+    /// @return Type of the wagon.
+    constexpr WagonType getType() const { return static_cast<WagonType>(bits >> TYPE_SHIFT); }
+
+    /// @brief Board passengers with the same checks as Wagon::boardPassengers.
+    /// @param passengers Number of passengers to board.
+    /// @throws std::invalid_argument if the wagon is a restaurant or cannot take the passengers.
+    constexpr void boardPassengers(int passengers) {
+      Wagon wagon = toWagon();
+      wagon.boardPassengers(passengers);
+      bits = pack(wagon.getMaxCapacity(), wagon.getOccupiedSeats(), wagon.getType());
+    }
+
+    /// @brief Set the number of occupied seats with the same checks as Wagon::setOccupiedSeats.
+    /// @param occupiedSeats The new number of occupied seats.
+    /// @throws std::invalid_argument if the wagon is a restaurant or the value is out of range.
+    constexpr void setOccupiedSeats(int occupiedSeats) {
+      Wagon wagon = toWagon();
+      wagon.setOccupiedSeats(occupiedSeats);
+      bits = pack(wagon.getMaxCapacity(), wagon.getOccupiedSeats(), wagon.getType());
+    }
+
+    /// @brief Disembark passengers with the same checks as Wagon::disembarkPassengers.
+    /// @param passengers Number of passengers to disembark.
+    /// @throws std::invalid_argument if the wagon is a restaurant or has fewer passengers.
+    constexpr void disembarkPassengers(int passengers) {
+      Wagon wagon = toWagon();
+      wagon.disembarkPassengers(passengers);
+      bits = pack(wagon.getMaxCapacity(), wagon.getOccupiedSeats(), wagon.getType());
+    }
+  };
+
+  /// @brief Write a packed wagon in the Wagon stream format.
+  /// @param os The output stream.
+  /// @param wagon The wagon to write.
+  /// @return The output stream.
+  inline std::ostream& operator<<(std::ostream& os, const PackedWagon& wagon) { return os << wagon.toWagon(); }
+
+  /// @brief Read a packed wagon written in the Wagon stream format.
+  /// @param is The input stream.
+  /// @param wagon The wagon to read into.
+  /// @return The input stream; failbit is set if the wagon is malformed or does not fit into a packed wagon.
+  inline std::istream& operator>>(std::istream& is, PackedWagon& wagon) {
+    Wagon unpacked;
+    if (is >> unpacked) {
+      if (unpacked.getMaxCapacity() > PackedWagon::MAX_SEATS) {
+        is.setstate(std::ios::failbit);
+      } else {
+        wagon = PackedWagon(unpacked);
+      }
+    }
+    return is;
+  }
+
+  static_assert(WAGON_TYPE_COUNT <= 4, "PackedWagon stores the wagon type in 2 bits");
+  static_assert(sizeof(PackedWagon) == 4, "PackedWagon must stay 32 bits wide");
+  static_assert(std::is_trivially_copyable_v<PackedWagon>, "PackedWagon must stay trivially copyable");
+
+} // namespace lab2SimpleClass
+
+#endif // PACKED_WAGON_H
@@ -0,0 +1,431 @@
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+#include "persistent_train.h"
+
+namespace lab2ComplexClass {
+
+  /// @brief An immutable tree node; children are shared between versions.
+  struct PersistentTrain::Node {
+    Wagon wagon;                        // Вагон в этой позиции
+    std::shared_ptr<const Node> left;   // Вагоны перед ним
+    std::shared_ptr<const Node> right;  // Вагоны после него
+    int size;                           // Количество вагонов в поддереве
+    int height;                         // Высота поддерева
+    int occupiedSeats;                  // Занятые места в поддереве
+  };
+
+  namespace {
+
+    using Node = PersistentTrain::Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    int sizeOf(const NodePtr& node) { return node ? node->size : 0; }
+    int heightOf(const NodePtr& node) { return node ? node->height : 0; }
+    int occupiedOf(const NodePtr& node) { return node ? node->occupiedSeats : 0; }
+
+    /// @brief Create a node and compute its subtree summaries.
+    NodePtr makeNode(const Wagon& wagon, NodePtr left, NodePtr right) {
+      int size = sizeOf(left) + sizeOf(right) + 1;
+      int height = std::max(heightOf(left), heightOf(right)) + 1;
+      int occupied = occupiedOf(left) + occupiedOf(right) + wagon.getOccupiedSeats();
+      return std::make_shared<const Node>(Node{wagon, std::move(left), std::move(right), size, height, occupied});
+    }
+
+    /// @brief Create a node whose children differ in height by at most 2, rotating to restore the AVL property.
+    NodePtr balance(const Wagon& wagon, NodePtr left, NodePtr right) {
+      if (heightOf(left) > heightOf(right) + 1) {
+        if (heightOf(left->left) >= heightOf(left->right)) {
+          return makeNode(left->wagon, left->left, makeNode(wagon, left->right, std::move(right)));
+        }
+        const NodePtr& middle = left->right;
+        return makeNode(middle->wagon, makeNode(left->wagon, left->left, middle->left),
+                        makeNode(wagon, middle->right, std::move(right)));
+      }
+      if (heightOf(right) > heightOf(left) + 1) {
+        if (heightOf(right->right) >= heightOf(right->left)) {
+          return makeNode(right->wagon, makeNode(wagon, std::move(left), right->left), right->right);
+        }
+        const NodePtr& middle = right->left;
+        return makeNode(middle->wagon, makeNode(wagon, std::move(left), middle->left),
+                        makeNode(right->wagon, middle->right, right->right));
+      }
+      return makeNode(wagon, std::move(left), std::move(right));
+    }
+
+    /// @brief Build a perfectly balanced tree from a sequence.
+    NodePtr build(std::span<const Wagon> wagons) {
+      if (wagons.empty()) {
+        return nullptr;
+      }
+      size_t middle = wagons.size() / 2;
+      return makeNode(wagons[middle], build(wagons.first(middle)), build(wagons.subspan(middle + 1)));
+    }
+
+    /// @brief Copy the path to a position and insert a wagon there.
+    NodePtr insertAt(const NodePtr& node, int index, const Wagon& wagon) {
+      if (!node) {
+        return makeNode(wagon, nullptr, nullptr);
+      }
+      int leftSize = sizeOf(node->left);
+      if (index <= leftSize) {
+        return balance(node->wagon, insertAt(node->left, index, wagon), node->right);
+      }
+      return balance(node->wagon, node->left, insertAt(node->right, index - leftSize - 1, wagon));
+    }
+
+    /// @brief Copy the path to the first wagon and remove it.
+    NodePtr removeFirst(const NodePtr& node, Wagon& removed) {
+      if (!node->left) {
+        removed = node->wagon;
+        return node->right;
+      }
+      return balance(node->wagon, removeFirst(node->left, removed), node->right);
+    }
+
+    /// @brief Copy the path to a position and remove the wagon there.
+    NodePtr removeAt(const NodePtr& node, int index) {
+      int leftSize = sizeOf(node->left);
+      if (index < leftSize) {
+        return balance(node->wagon, removeAt(node->left, index), node->right);
+      }
+      if (index > leftSize) {
+        return balance(node->wagon, node->left, removeAt(node->right, index - leftSize - 1));
+      }
+      if (!node->left) {
+        return node->right;
+      }
+      if (!node->right) {
+        return node->left;
+      }
+      Wagon successor;
+      NodePtr right = removeFirst(node->right, successor);
+      return balance(successor, node->left, std::move(right));
+    }
+
+    /// @brief Copy the path to a position and replace the wagon there; the shape does not change.
+    NodePtr replaceAt(const NodePtr& node, int index, const Wagon& wagon) {
+      int leftSize = sizeOf(node->left);
+      if (index < leftSize) {
+        return makeNode(node->wagon, replaceAt(node->left, index, wagon), node->right);
+      }
+      if (index > leftSize) {
+        return makeNode(node->wagon, node->left, replaceAt(node->right, index - leftSize - 1, wagon));
+      }
+      return makeNode(wagon, node->left, node->right);
+    }
+
+    /// @brief Append the wagons of a subtree to a train in order.
+    void appendInOrder(const NodePtr& node, Train& train) {
+      if (!node) {
+        return;
+      }
+      appendInOrder(node->left, train);
+      train.addWagon(node->wagon);
+      appendInOrder(node->right, train);
+    }
+
+    /// @brief Find the wagon the boarding rule of Train would choose in a subtree, scanning in order.
+    void findMostAvailable(const NodePtr& node, int passengers, WagonType wagonType, int& index, int& best, int& bestOccupancy) {
+      if (!node) {
+        return;
+      }
+      findMostAvailable(node->left, passengers, wagonType, index, best, bestOccupancy);
+      const Wagon& wagon = node->wagon;
+      if (wagon.getType() == wagonType && wagon.getMaxCapacity() - wagon.getOccupiedSeats() >= passengers &&
+          (best < 0 || wagon.getOccupiedSeats() > bestOccupancy)) {
+        best = index;
+        bestOccupancy = wagon.getOccupiedSeats();
+      }
+      index++;
+      findMostAvailable(node->right, passengers, wagonType, index, best, bestOccupancy);
+    }
+
+    /// @brief Collect the nodes of a subtree, skipping subtrees already seen.
+    void collectNodes(const NodePtr& node, std::unordered_set<const Node*>& seen) {
+      if (!node || !seen.insert(node.get()).second) {
+        return;
+      }
+      collectNodes(node->left, seen);
+      collectNodes(node->right, seen);
+    }
+
+  } // namespace
+
+  PersistentTrain::PersistentTrain(std::shared_ptr<const Node> root) : root(std::move(root)) {}
+
+  /**
+   * @brief Default constructor, creates an empty train.
+   */
+  PersistentTrain::PersistentTrain() = default;
+
+  /**
+   * @brief Constructor that builds a balanced tree from a sequence of wagons in O(n).
+   *
+   * @param wagons The wagons in order.
+   */
+  PersistentTrain::PersistentTrain(std::span<const Wagon> wagons) : root(build(wagons)) {}
+
+  /**
+   * @brief Constructor that builds a balanced tree from the wagons of a train in O(n).
+   *
+   * @param train The train.
+   */
+  PersistentTrain::PersistentTrain(const Train& train) : PersistentTrain(train.view()) {}
+
+  /**
+   * @brief Convert to a train.
+   *
+   * @return A train with the same wagons.
+   */
+  Train PersistentTrain::toTrain() const {
+    Train train;
+    train.reserve(getNumWagons());
+    appendInOrder(root, train);
+    return train;
+  }
+
+  /**
+   * @brief Get the number of wagons in the train.
+   *
+   * @return The number of wagons.
+   */
+  int PersistentTrain::getNumWagons() const { return sizeOf(root); }
+
+  /**
+   * @brief Get the total number of occupied seats in O(1).
+   *
+   * @return The number of passengers in the train.
+   */
+  int PersistentTrain::getTotalOccupiedSeats() const { return occupiedOf(root); }
+
+  /**
+   * @brief Get a wagon by its index in O(log n).
+   *
+   * @param index The index of the wagon.
+   * @return A const reference to the wagon.
+   * @throws std::out_of_range if the index is invalid.
+   */
+  const Wagon& PersistentTrain::getWagonByIndex(int index) const {
+    if (index < 0 || index >= getNumWagons()) {
+      throw std::out_of_range("Invalid wagon index.");
+    }
+    const Node* node = root.get();
+    while (true) {
+      int leftSize = sizeOf(node->left);
+      if (index < leftSize) {
+        node = node->left.get();
+      } else if (index > leftSize) {
+        index -= leftSize + 1;
+        node = node->right.get();
+      } else {
+        return node->wagon;
+      }
+    }
+  }
+
+  /**
+   * @brief Overloaded subscript operator for reading wagons.
+   *
+   * @param index The index of the wagon.
+   * @return A const reference to the wagon.
+   * @throws std::out_of_range if the index is invalid.
+   */
+  const Wagon& PersistentTrain::operator[](int index) const { return getWagonByIndex(index); }
+
+  /**
+   * @brief Get a version with a wagon added to the end.
+   *
+   * @param wagon The wagon to add.
+   * @return The new version.
+   */
+  PersistentTrain PersistentTrain::addWagon(const Wagon& wagon) const {
+    return PersistentTrain(insertAt(root, getNumWagons(), wagon));
+  }
+
+  /**
+   * @brief Get a version with a wagon inserted at the specified index.
+   *
+   * @param newWagon The wagon to insert.
+   * @param index The index at which to insert the wagon.
+   * @return The new version.
+   * @throws std::invalid_argument if the index is out of bounds.
+   */
+  PersistentTrain PersistentTrain::addWagonAtIndex(const Wagon& newWagon, int index) const {
+    if (index < 0 || index > getNumWagons()) {
+      throw std::invalid_argument("Invalid index for adding a wagon.");
+    }
+    return PersistentTrain(insertAt(root, index, newWagon));
+  }
+
+  /**
+   * @brief Get a version without the wagon at the specified index.
+   *
+   * @param index The index of the wagon to remove.
+   * @return The new version.
+   * @throws std::out_of_range if the index is invalid.
+   */
+  PersistentTrain PersistentTrain::removeWagonByIndex(int index) const {
+    if (index < 0 || index >= getNumWagons()) {
+      throw std::out_of_range("Invalid wagon index.");
+    }
+    return PersistentTrain(removeAt(root, index));
+  }
+
+  /**
+   * @brief Get a version with the wagon at the specified index replaced.
+   *
+   * @param index The index of the wagon.
+   * @param wagon The new wagon.
+   * @return The new version.
+   * @throws std::out_of_range if the index is invalid.
+   */
+  PersistentTrain PersistentTrain::setWagon(int index, const Wagon& wagon) const {
+    if (index < 0 || index >= getNumWagons()) {
+      throw std::out_of_range("Invalid wagon index.");
+    }
+    return PersistentTrain(replaceAt(root, index, wagon));
+  }
+
+  /**
+   * @brief Get a version with passengers boarded into a wagon.
+   *
+   * @param index The index of the wagon.
+   * @param passengers The number of passengers to board.
+   * @return The new version.
+   * @throws std::out_of_range if the index is invalid.
+   * @throws std::invalid_argument if the wagon cannot take the passengers.
+   */
+  PersistentTrain PersistentTrain::boardPassengers(int index, int passengers) const {
+    Wagon wagon = getWagonByIndex(index);
+    wagon.boardPassengers(passengers);
+    return PersistentTrain(replaceAt(root, index, wagon));
+  }
+
+  /**
+   * @brief Get a version with passengers disembarked from a wagon.
+   *
+   * @param index The index of the wagon.
+   * @param passengers The number of passengers to disembark.
+   * @return The new version.
+   * @throws std::out_of_range if the index is invalid.
+   * @throws std::invalid_argument if the wagon has fewer passengers.
+   */
+  PersistentTrain PersistentTrain::disembarkPassengers(int index, int passengers) const {
+    Wagon wagon = getWagonByIndex(index);
+    wagon.disembarkPassengers(passengers);
+    return PersistentTrain(replaceAt(root, index, wagon));
+  }
+
+  /**
+   * @brief Get a version with passengers boarded into the wagon Train::boardPassengersToMostAvailableWagon would choose.
+   *
+   * The choice needs a scan of all wagons; the new version still copies only one path.
+   *
+   * @param passengers The number of passengers to board.
+   * @param wagonType The class of wagon to board passengers into.
+   * @return The new version.
+   * @throws std::invalid_argument if no wagon of the class can take the passengers.
+   */
+  PersistentTrain PersistentTrain::boardPassengersToMostAvailableWagon(int passengers, WagonType wagonType) const {
+    int index = 0;
+    int best = -1;
+    int bestOccupancy = 0;
+    findMostAvailable(root, passengers, wagonType, index, best, bestOccupancy);
+    if (best < 0) {
+      throw std::invalid_argument("No available wagons of the specified type can accommodate the specified number of passengers.");
+    }
+    return boardPassengers(best, passengers);
+  }
+
+  /**
+   * @brief Check whether two versions are the same tree.
+   *
+   * @param other The other version.
+   * @return True if both versions share the root.
+   */
+  bool PersistentTrain::isSameVersion(const PersistentTrain& other) const { return root == other.root; }
+
+  /**
+   * @brief Get the height of the tree.
+   *
+   * @return The height; 0 for an empty train.
+   */
+  int PersistentTrain::getHeight() const { return heightOf(root); }
+
+  /**
+   * @brief Constructor, starts the history with an initial version.
+   *
+   * @param initial Version 0.
+   */
+  TrainHistory::TrainHistory(PersistentTrain initial) { versions.push_back(std::move(initial)); }
+
+  /**
+   * @brief Append a version.
+   *
+   * @param version The new current version.
+   * @return The number of the version.
+   */
+  int TrainHistory::commit(PersistentTrain version) {
+    versions.push_back(std::move(version));
+    return static_cast<int>(versions.size()) - 1;
+  }
+
+  /**
+   * @brief Get the current (latest) version.
+   *
+   * @return The current version.
+   */
+  const PersistentTrain& TrainHistory::current() const { return versions.back(); }
+
+  /**
+   * @brief Get a version by its number.
+   *
+   * @param version The number of the version.
+   * @return The version.
+   * @throws std::out_of_range if there is no such version.
+   */
+  const PersistentTrain& TrainHistory::at(int version) const {
+    if (version < 0 || version >= getVersionCount()) {
+      throw std::out_of_range("Invalid train version.");
+    }
+    return versions[version];
+  }
+
+  /**
+   * @brief Get the number of versions.
+   *
+   * @return The number of versions.
+   */
+  int TrainHistory::getVersionCount() const { return static_cast<int>(versions.size()); }
+
+  /**
+   * @brief Make an earlier version current again and discard the versions after it.
+   *
+   * Nodes referenced only by the discarded versions are released.
+   *
+   * @param version The number of the version to return to.
+   * @throws std::out_of_range if there is no such version.
+   */
+  void TrainHistory::rollbackTo(int version) {
+    if (version < 0 || version >= getVersionCount()) {
+      throw std::out_of_range("Invalid train version.");
+    }
+    versions.resize(version + 1);
+  }
+
+  /**
+   * @brief Count the distinct tree nodes of all versions.
+   *
+   * @return The number of distinct nodes.
+   */
+  size_t TrainHistory::countDistinctNodes() const {
+    std::unordered_set<const Node*> seen;
+    for (const PersistentTrain& version : versions) {
+      collectNodes(version.root, seen);
+    }
+    return seen.size();
+  }
+
+} // namespace lab2ComplexClass
@@ -0,0 +1,243 @@
+#ifndef PERSISTENT_TRAIN_H
+#define PERSISTENT_TRAIN_H
+
+#include <memory>
+#include <span>
+#include <vector>
+#include "train.h"
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief An immutable train version that shares structure with the versions it was derived from.
+   *
+   * The wagons are kept in a persistent AVL tree ordered by position. Every modifying operation leaves this
+   * version untouched and returns a new one that copies only the O(log n) nodes on the path to the change,
+   * so keeping every version costs memory proportional to the number of changes. Reading a wagon of any
+   * version takes O(log n); the total number of occupied seats is kept in the nodes and read in O(1).
+   *
+   * Versions are cheap to copy and safe to read from several threads.
+   */
+  class PersistentTrain {
+    public:
+      struct Node; ///< Tree node, defined in the source file.
+
+    private:
+      std::shared_ptr<const Node> root; // Корень дерева вагонов; nullptr у пустого поезда
+
+      explicit PersistentTrain(std::shared_ptr<const Node> root);
+
+      friend class TrainHistory;
+
+    public:
+      /**
+       * @brief Default constructor, creates an empty train.
+       */
+      PersistentTrain();
+
+      /**
+       * @brief Constructor that builds a balanced tree from a sequence of wagons in O(n).
+       *
+       * @param wagons The wagons in order.
+       */
+      explicit PersistentTrain(std::span<const Wagon> wagons);
+
+      /**
+       * @brief Constructor that builds a balanced tree from the wagons of a train in O(n).
+       *
+       * @param train The train.
+       */
+      explicit PersistentTrain(const Train& train);
+
+      /**
+       * @brief Convert to a train.
+       *
+       * @return A train with the same wagons.
+       */
+      Train toTrain() const;
+
+      /**
+       * @brief Get the number of wagons in the train.
+       *
+       * @return The number of wagons.
+       */
+      int getNumWagons() const;
+
+      /**
+       * @brief Get the total number of occupied seats in O(1).
+       *
+       * @return The number of passengers in the train.
+       */
+      int getTotalOccupiedSeats() const;
+
+      /**
+       * @brief Get a wagon by its index in O(log n).
+       *
+       * @param index The index of the wagon.
+       * @return A const reference to the wagon, valid as long as a version containing it exists.
+       * @throws std::out_of_range if the index is invalid.
+       */
+      const Wagon& getWagonByIndex(int index) const;
+
+      /**
+       * @brief Overloaded subscript operator for reading wagons.
+       *
+       * @param index The index of the wagon.
+       * @return A const reference to the wagon.
+       * @throws std::out_of_range if the index is invalid.
+       */
+      const Wagon& operator[](int index) const;
+
+      /**
+       * @brief Get a version with a wagon added to the end.
+       *
+       * @param wagon The wagon to add.
+       * @return The new version.
+       */
+      [[nodiscard]] PersistentTrain addWagon(const Wagon& wagon) const;
+
+      /**
+       * @brief Get a version with a wagon inserted at the specified index.
+       *
+       * @param newWagon The wagon to insert.
+       * @param index The index at which to insert the wagon.
+       * @return The new version.
+       * @throws std::invalid_argument if the index is out of bounds.
+       */
+      [[nodiscard]] PersistentTrain addWagonAtIndex(const Wagon& newWagon, int index) const;
+
+      /**
+       * @brief Get a version without the wagon at the specified index.
+       *
+       * @param index The index of the wagon to remove.
+       * @return The new version.
+       * @throws std::out_of_range if the index is invalid.
+       */
+      [[nodiscard]] PersistentTrain removeWagonByIndex(int index) const;
+
+      /**
+       * @brief Get a version with the wagon at the specified index replaced.
+       *
+       * @param index The index of the wagon.
+       * @param wagon The new wagon.
+       * @return The new version.
+       * @throws std::out_of_range if the index is invalid.
+       */
+      [[nodiscard]] PersistentTrain setWagon(int index, const Wagon& wagon) const;
+
+      /**
+       * @brief Get a version with passengers boarded into a wagon.
+       *
+       * @param index The index of the wagon.
+       * @param passengers The number of passengers to board.
+       * @return The new version.
+       * @throws std::out_of_range if the index is invalid.
+       * @throws std::invalid_argument if the wagon cannot take the passengers.
+       */
+      [[nodiscard]] PersistentTrain boardPassengers(int index, int passengers) const;
+
+      /**
+       * @brief Get a version with passengers disembarked from a wagon.
+       *
+       * @param index The index of the wagon.
+       * @param passengers The number of passengers to disembark.
+       * @return The new version.
+       * @throws std::out_of_range if the index is invalid.
+       * @throws std::invalid_argument if the wagon has fewer passengers.
+       */
+      [[nodiscard]] PersistentTrain disembarkPassengers(int index, int passengers) const;
+
+      /**
+       * @brief Get a version with passengers boarded into the wagon Train::boardPassengersToMostAvailableWagon would choose.
+       *
+       * @param passengers The number of passengers to board.
+       * @param wagonType The class of wagon to board passengers into.
+       * @return The new version.
+       * @throws std::invalid_argument if no wagon of the class can take the passengers.
+       */
+      [[nodiscard]] PersistentTrain boardPassengersToMostAvailableWagon(int passengers, WagonType wagonType) const;
+
+      /**
+       * @brief Check whether two versions are the same tree (not just equal wagons).
+       *
+       * @param other The other version.
+       * @return True if both versions share the root.
+       */
+      bool isSameVersion(const PersistentTrain& other) const;
+
+      /**
+       * @brief Get the height of the tree, at most about 1.44 log2(n + 2).
+       *
+       * @return The height; 0 for an empty train.
+       */
+      int getHeight() const;
+  };
+
+  /**
+   * @brief Audit trail of train versions with rollback.
+   *
+   * Versions are numbered from 0 in the order they were committed. Because consecutive versions share
+   * structure, the history of k operations on a train of n wagons takes O(n + k log n) memory.
+   */
+  class TrainHistory {
+    private:
+      std::vector<PersistentTrain> versions; // Версии поезда в порядке фиксации
+
+    public:
+      /**
+       * @brief Constructor, starts the history with an initial version.
+       *
+       * @param initial Version 0.
+       */
+      explicit TrainHistory(PersistentTrain initial = PersistentTrain());
+
+      /**
+       * @brief Append a version.
+       *
+       * @param version The new current version.
+       * @return The number of the version.
+       */
+      int commit(PersistentTrain version);
+
+      /**
+       * @brief Get the current (latest) version.
+       *
+       * @return The current version.
+       */
+      const PersistentTrain& current() const;
+
+      /**
+       * @brief Get a version by its number.
+       *
+       * @param version The number of the version.
+       * @return The version.
+       * @throws std::out_of_range if there is no such version.
+       */
+      const PersistentTrain& at(int version) const;
+
+      /**
+       * @brief Get the number of versions.
+       *
+       * @return The number of versions.
+       */
+      int getVersionCount() const;
+
+      /**
+       * @brief Make an earlier version current again and discard the versions after it.
+       *
+       * @param version The number of the version to return to.
+       * @throws std::out_of_range if there is no such version.
+       */
+      void rollbackTo(int version);
+
+      /**
+       * @brief Count the distinct tree nodes of all versions, i.e. the wagons actually stored.
+       *
+       * @return The number of distinct nodes.
+       */
+      size_t countDistinctNodes() const;
+  };
+
+} // namespace lab2ComplexClass
+
+#endif // PERSISTENT_TRAIN_H
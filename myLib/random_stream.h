@@ -0,0 +1,65 @@
+#ifndef RANDOM_STREAM_H
+#define RANDOM_STREAM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief A small random stream (SplitMix64) for runs that need one independent stream per train or scenario.
+   *
+   * The state is one word, so creating or reseeding a stream costs nothing, and stream k of a seed does not
+   * depend on any other stream, which keeps parallel runs identical for any number of threads. Satisfies
+   * UniformRandomBitGenerator, so it works with the standard distributions.
+   */
+  class RandomStream {
+    private:
+      static constexpr uint64_t GAMMA = 0x9E3779B97F4A7C15ULL; // Шаг состояния SplitMix64
+
+      uint64_t state; // Состояние генератора
+
+      /// @brief The SplitMix64 output function: a bijective mix of the 64 bits.
+      static constexpr uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+      }
+
+    public:
+      using result_type = uint64_t;
+
+      /**
+       * @brief Constructor.
+       *
+       * The starting state is a hash of the seed and the stream. A state that is a plain function of both, like
+       * seed ^ (stream * GAMMA), puts streams a few steps of GAMMA apart, so they replay each other's outputs.
+       *
+       * @param seed The seed of the run.
+       * @param stream The index of the stream within the run.
+       */
+      RandomStream(uint64_t seed, uint64_t stream) : state(mix(seed ^ mix(stream + GAMMA))) {}
+
+      static constexpr result_type min() { return 0; }
+      static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+      /// @brief Get the next 64 random bits.
+      result_type operator()() { return mix(state += GAMMA); }
+
+      /// @brief Get a uniform number in [0, 1).
+      double uniform() { return static_cast<double>((*this)() >> 11) * 0x1.0p-53; }
+
+      /// @brief Get a uniform integer in [0, bound).
+      int below(int bound) { return static_cast<int>((*this)() % static_cast<uint64_t>(bound)); }
+
+      /// @brief Get an exponentially distributed time with the given mean, at least 1.
+      int64_t exponential(int64_t mean) {
+        return std::max<int64_t>(static_cast<int64_t>(-std::log1p(-uniform()) * static_cast<double>(mean)), 1);
+      }
+  };
+
+} // namespace lab2ComplexClass
+
+#endif // RANDOM_STREAM_H
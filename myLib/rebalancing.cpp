@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <deque>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include "min_cost_flow.h"
+#include "rebalancing.h"
+
+namespace lab2ComplexClass {
+
+  namespace {
+
+    /// @brief Occupied seats and capacity of one class in every train.
+    struct ClassLoad {
+      std::vector<int64_t> occupied;  // Занятые места класса в каждом поезде
+      std::vector<int64_t> capacity;  // Места класса в каждом поезде
+      int64_t totalOccupied = 0;      // Занятые места класса во всех поездах
+      int64_t totalCapacity = 0;      // Места класса во всех поездах
+    };
+
+    /// @brief Sum up the seats of every class in every train.
+    std::array<ClassLoad, WAGON_TYPE_COUNT> measureLoads(std::span<const Train> trains) {
+      std::array<ClassLoad, WAGON_TYPE_COUNT> loads;
+      for (ClassLoad& load : loads) {
+        load.occupied.assign(trains.size(), 0);
+        load.capacity.assign(trains.size(), 0);
+      }
+      for (size_t i = 0; i < trains.size(); i++) {
+        for (const Wagon& wagon : trains[i].view()) {
+          ClassLoad& load = loads[static_cast<int>(wagon.getType())];
+          load.occupied[i] += wagon.getOccupiedSeats();
+          load.capacity[i] += wagon.getMaxCapacity();
+          load.totalOccupied += wagon.getOccupiedSeats();
+          load.totalCapacity += wagon.getMaxCapacity();
+        }
+      }
+      return loads;
+    }
+
+    /// @brief Split the passengers of a class in proportion to capacity; remainders go to the largest fractions.
+    std::vector<int64_t> balancedTargets(const ClassLoad& load) {
+      size_t numTrains = load.capacity.size();
+      std::vector<int64_t> targets(numTrains, 0);
+      if (load.totalCapacity == 0) {
+        return targets;
+      }
+      std::vector<int64_t> fraction(numTrains);
+      int64_t assigned = 0;
+      for (size_t i = 0; i < numTrains; i++) {
+        targets[i] = load.totalOccupied * load.capacity[i] / load.totalCapacity;
+        fraction[i] = load.totalOccupied * load.capacity[i] % load.totalCapacity;
+        assigned += targets[i];
+      }
+      std::vector<size_t> order(numTrains);
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return fraction[a] > fraction[b]; });
+      for (int64_t i = 0; i < load.totalOccupied - assigned; i++) {
+        targets[order[i]]++;
+      }
+      return targets;
+    }
+
+    /**
+     * @brief Carry units along one direction of a path flow and record where they leave the stream.
+     *
+     * @param order The nodes in the direction of travel.
+     * @param joining Units every node puts into the stream.
+     * @param passing Units in the stream after every node.
+     * @param moved Units moved from one node to another.
+     */
+    void followStream(const std::vector<int>& order, const std::vector<int64_t>& joining, const std::vector<int64_t>& passing,
+                      std::map<std::pair<int, int>, int64_t>& moved) {
+      std::deque<std::pair<int, int64_t>> stream;
+      int64_t carried = 0;
+      for (int node : order) {
+        if (joining[node] > 0) {
+          stream.push_back({node, joining[node]});
+          carried += joining[node];
+        }
+        // Первыми выходят пришедшие раньше; любой порядок даёт ту же стоимость
+        while (carried > passing[node]) {
+          auto& [origin, units] = stream.front();
+          int64_t leaving = std::min(units, carried - passing[node]);
+          moved[{origin, node}] += leaving;
+          units -= leaving;
+          carried -= leaving;
+          if (units == 0) {
+            stream.pop_front();
+          }
+        }
+      }
+    }
+
+    /// @brief Move surplus passengers of one class to trains with room at minimum cost and add the transfers to a plan.
+    void planClass(WagonType wagonType, const std::vector<int64_t>& supply, const std::vector<int64_t>& demand, TransferPlan& plan) {
+      int numTrains = static_cast<int>(supply.size());
+      PathFlow flow = solvePathFlow(supply, demand);
+
+      // Разложение потока на два встречных потока: вправо по рёбрам с f > 0 и влево по рёбрам с f < 0
+      std::vector<int64_t> toRight(numTrains, 0);
+      std::vector<int64_t> toLeft(numTrains, 0);
+      for (int i = 0; i + 1 < numTrains; i++) {
+        toRight[i] = std::max<int64_t>(flow.edgeFlow[i], 0);
+        toLeft[i + 1] = std::max<int64_t>(-flow.edgeFlow[i], 0);
+      }
+      std::vector<int64_t> joinRight(numTrains);
+      std::vector<int64_t> joinLeft(numTrains);
+      for (int i = 0; i < numTrains; i++) {
+        joinRight[i] = std::min(supply[i], toRight[i]);
+        joinLeft[i] = std::min(supply[i] - joinRight[i], toLeft[i]);
+      }
+      std::vector<int> order(numTrains);
+      std::iota(order.begin(), order.end(), 0);
+      std::map<std::pair<int, int>, int64_t> moved;
+      followStream(order, joinRight, toRight, moved);
+      std::reverse(order.begin(), order.end());
+      followStream(order, joinLeft, toLeft, moved);
+
+      for (const auto& [trains, passengers] : moved) {
+        plan.transfers.push_back({trains.first, trains.second, wagonType, static_cast<int>(passengers)});
+        plan.totalCost += passengers * std::abs(trains.first - trains.second);
+        plan.passengersMoved += passengers;
+      }
+    }
+
+  } // namespace
+
+  /**
+   * @brief Plan transfers between the trains of a corridor at minimum total movement.
+   *
+   * @param trains The trains of the corridor, in corridor order.
+   * @param goal What to achieve.
+   * @return The plan; trains are not changed.
+   */
+  TransferPlan planRebalancing(std::span<const Train> trains, RebalanceGoal goal) {
+    TransferPlan plan;
+    std::array<ClassLoad, WAGON_TYPE_COUNT> loads = measureLoads(trains);
+    int numTrains = static_cast<int>(trains.size());
+
+    std::vector<bool> freed(numTrains, false);
+    if (goal == RebalanceGoal::CONSOLIDATE) {
+      std::vector<int64_t> passengers(numTrains, 0);
+      for (const ClassLoad& load : loads) {
+        for (int i = 0; i < numTrains; i++) {
+          passengers[i] += load.occupied[i];
+        }
+      }
+      std::vector<int> order(numTrains);
+      std::iota(order.begin(), order.end(), 0);
+      std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return passengers[a] < passengers[b]; });
+
+      std::array<int64_t, WAGON_TYPE_COUNT> keptCapacity;
+      for (int type = 0; type < WAGON_TYPE_COUNT; type++) {
+        keptCapacity[type] = loads[type].totalCapacity;
+      }
+      for (int candidate : order) {
+        bool fits = true;
+        for (int type = 0; type < WAGON_TYPE_COUNT; type++) {
+          fits = fits && keptCapacity[type] - loads[type].capacity[candidate] >= loads[type].totalOccupied;
+        }
+        if (fits) {
+          freed[candidate] = true;
+          for (int type = 0; type < WAGON_TYPE_COUNT; type++) {
+            keptCapacity[type] -= loads[type].capacity[candidate];
+          }
+          plan.freedTrains.push_back(candidate);
+        }
+      }
+      std::sort(plan.freedTrains.begin(), plan.freedTrains.end());
+    }
+
+    for (int type = 0; type < WAGON_TYPE_COUNT; type++) {
+      const ClassLoad& load = loads[type];
+      if (!wagonTypeTraits(static_cast<WagonType>(type)).canBoard || load.totalOccupied == 0) {
+        continue;
+      }
+      std::vector<int64_t> supply(numTrains, 0);
+      std::vector<int64_t> demand(numTrains, 0);
+      if (goal == RebalanceGoal::BALANCE) {
+        std::vector<int64_t> targets = balancedTargets(load);
+        for (int i = 0; i < numTrains; i++) {
+          supply[i] = std::max<int64_t>(load.occupied[i] - targets[i], 0);
+          demand[i] = std::max<int64_t>(targets[i] - load.occupied[i], 0);
+        }
+      } else {
+        for (int i = 0; i < numTrains; i++) {
+          if (freed[i]) {
+            supply[i] = load.occupied[i];
+          } else {
+            demand[i] = load.capacity[i] - load.occupied[i];
+          }
+        }
+      }
+      planClass(static_cast<WagonType>(type), supply, demand, plan);
+    }
+    return plan;
+  }
+
+  /**
+   * @brief Carry out a transfer plan.
+   *
+   * @param trains The trains the plan was made for.
+   * @param plan The plan.
+   * @throws std::out_of_range if a transfer refers to a train that does not exist.
+   * @throws std::invalid_argument if a transfer moves more passengers than a train has or can take.
+   */
+  void applyTransferPlan(std::span<Train> trains, const TransferPlan& plan) {
+    std::array<ClassLoad, WAGON_TYPE_COUNT> loads = measureLoads(trains);
+    int numTrains = static_cast<int>(trains.size());
+    for (const PassengerTransfer& transfer : plan.transfers) {
+      if (transfer.fromTrain < 0 || transfer.fromTrain >= numTrains || transfer.toTrain < 0 || transfer.toTrain >= numTrains) {
+        throw std::out_of_range("Invalid train index in transfer plan.");
+      }
+      ClassLoad& load = loads[static_cast<int>(transfer.wagonType)];
+      if (transfer.passengers < 0 || load.occupied[transfer.fromTrain] < transfer.passengers ||
+          load.capacity[transfer.toTrain] - load.occupied[transfer.toTrain] < transfer.passengers) {
+        throw std::invalid_argument("Transfer plan does not fit the trains.");
+      }
+      load.occupied[transfer.fromTrain] -= transfer.passengers;
+      load.occupied[transfer.toTrain] += transfer.passengers;
+    }
+
+    for (const PassengerTransfer& transfer : plan.transfers) {
+      Train& from = trains[transfer.fromTrain];
+      int leaving = transfer.passengers;
+      for (int i = 0; i < from.getNumWagons() && leaving > 0; i++) {
+        const Wagon& wagon = from.view()[i];
+        if (wagon.getType() == transfer.wagonType && wagon.getOccupiedSeats() > 0) {
+          int moving = std::min(leaving, wagon.getOccupiedSeats());
+          from[i].setOccupiedSeats(wagon.getOccupiedSeats() - moving);
+          leaving -= moving;
+        }
+      }
+      Train& to = trains[transfer.toTrain];
+      int joining = transfer.passengers;
+      for (int i = 0; i < to.getNumWagons() && joining > 0; i++) {
+        const Wagon& wagon = to.view()[i];
+        int free = wagon.getMaxCapacity() - wagon.getOccupiedSeats();
+        if (wagon.getType() == transfer.wagonType && free > 0) {
+          int moving = std::min(joining, free);
+          to[i].setOccupiedSeats(wagon.getOccupiedSeats() + moving);
+          joining -= moving;
+        }
+      }
+    }
+  }
+
+} // namespace lab2ComplexClass
@@ -0,0 +1,65 @@
+#ifndef REBALANCING_H
+#define REBALANCING_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "train.h"
+
+namespace lab2ComplexClass {
+
+  /// @brief What a cross-train rebalancing should achieve.
+  enum class RebalanceGoal {
+    BALANCE,     ///< Give every train a share of the passengers of each class proportional to its seats of the class.
+    CONSOLIDATE  ///< Empty as many trains as the remaining trains can absorb, starting with the least occupied.
+  };
+
+  /// @brief Passengers of one class moved from one train to another.
+  struct PassengerTransfer {
+    int fromTrain;         ///< Index of the train the passengers leave.
+    int toTrain;           ///< Index of the train the passengers join.
+    WagonType wagonType;   ///< Class of the seats on both trains.
+    int passengers;        ///< Number of passengers moved.
+
+    bool operator==(const PassengerTransfer&) const = default;
+  };
+
+  /// @brief A set of transfers between the trains of a corridor.
+  struct TransferPlan {
+    std::vector<PassengerTransfer> transfers;  ///< Transfers ordered by class, then by source and destination train.
+    int64_t totalCost = 0;                     ///< Sum of passengers times |fromTrain - toTrain|.
+    int64_t passengersMoved = 0;               ///< Sum of the passengers of all transfers.
+    std::vector<int> freedTrains;              ///< Trains left without passengers (CONSOLIDATE only), in increasing order.
+  };
+
+  /**
+   * @brief Plan transfers between the trains of a corridor at minimum total movement.
+   *
+   * The trains are taken in corridor order (e.g. by departure time) and moving a passenger from train i to
+   * train j costs |i - j|. For every class that carries passengers the trains with a surplus feed the trains
+   * with room through a min-cost flow on the path of the trains (solvePathFlow), O(n log n) per class, so
+   * a few thousand trains are planned in milliseconds.
+   *
+   * @param trains The trains of the corridor, in corridor order.
+   * @param goal What to achieve.
+   * @return The plan; trains are not changed.
+   */
+  TransferPlan planRebalancing(std::span<const Train> trains, RebalanceGoal goal);
+
+  /**
+   * @brief Carry out a transfer plan.
+   *
+   * Passengers leave the wagons of the class in the source train in wagon order and fill the free seats of
+   * the class in the destination train in wagon order. The whole plan is checked first; if it does not fit
+   * the trains, nothing is changed.
+   *
+   * @param trains The trains the plan was made for.
+   * @param plan The plan.
+   * @throws std::out_of_range if a transfer refers to a train that does not exist.
+   * @throws std::invalid_argument if a transfer moves more passengers than a train has or can take.
+   */
+  void applyTransferPlan(std::span<Train> trains, const TransferPlan& plan);
+
+} // namespace lab2ComplexClass
+
+#endif // REBALANCING_H
@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "replay.h"
+
+namespace lab2ComplexClass {
+
+  namespace {
+
+    /**
+     * @brief Apply a single operation to the train.
+     *
+     * @param op The operation.
+     * @param train The train.
+     */
+    void applyOp(const TraceOp& op, Train& train) {
+      switch (op.type) {
+        case TraceOpType::BOARD:
+          train.boardPassengersToMostAvailableWagon(op.passengers, op.wagonType);
+          break;
+        case TraceOpType::DISEMBARK:
+          train[op.index].disembarkPassengers(op.passengers);
+          break;
+        case TraceOpType::ADD_WAGON:
+          train.addWagon(op.wagon);
+          break;
+        case TraceOpType::INSERT_WAGON:
+          train.addWagonAtIndex(op.wagon, op.index);
+          break;
+        case TraceOpType::REMOVE_WAGON:
+          train.removeWagonByIndex(op.index);
+          break;
+        case TraceOpType::REDISTRIBUTE:
+          train.redistributePassengers();
+          break;
+        case TraceOpType::OPTIMIZE:
+          train.optimizeTrain();
+          break;
+        case TraceOpType::RESTAURANT_PLACEMENT:
+          train.optimizeRestaurantPlacement();
+          break;
+      }
+    }
+
+  } // namespace
+
+  /**
+   * @brief Get a percentile from a sorted vector of samples (nearest-rank method).
+   *
+   * The result is the sample of rank ceil(fraction * n), counting from 1, so the median of two samples is the
+   * smaller one and p99 of fewer than 100 samples is not always the maximum.
+   *
+   * @param sorted The sorted samples.
+   * @param fraction The percentile as a fraction in [0, 1].
+   * @return The sample at the percentile, or 0 if there are no samples.
+   */
+  int64_t nearestRankPercentile(const std::vector<int64_t>& sorted, double fraction) {
+    if (sorted.empty()) {
+      return 0;
+    }
+    return sorted[lab2Instrumentation::nearestRankIndex(fraction, sorted.size())];
+  }
+
+  /**
+   * @brief Get the replay throughput.
+   *
+   * @return Operations per second, or 0 if nothing was replayed.
+   */
+  double ReplayReport::getThroughput() const {
+    if (totalNanoseconds == 0) {
+      return 0.0;
+    }
+    return static_cast<double>(totalOps) * 1e9 / static_cast<double>(totalNanoseconds);
+  }
+
+  /**
+   * @brief Get the trace mnemonic of an operation kind.
+   *
+   * @param type The operation kind.
+   * @return The human-readable name of the operation kind.
+   */
+  const char* traceOpName(TraceOpType type) {
+    switch (type) {
+      case TraceOpType::BOARD:
+        return "board";
+      case TraceOpType::DISEMBARK:
+        return "disembark";
+      case TraceOpType::ADD_WAGON:
+        return "addWagon";
+      case TraceOpType::INSERT_WAGON:
+        return "addWagonAtIndex";
+      case TraceOpType::REMOVE_WAGON:
+        return "removeWagonByIndex";
+      case TraceOpType::REDISTRIBUTE:
+        return "redistribute";
+      case TraceOpType::OPTIMIZE:
+        return "optimizeTrain";
+      case TraceOpType::RESTAURANT_PLACEMENT:
+        return "restaurantPlacement";
+    }
+    return "unknown";
+  }
+
+  /**
+   * @brief Replay a trace against a train and measure the latency of every operation.
+   *
+   * Every operation is timed individually with a steady clock. Latency samples are kept per operation
+   * kind and reduced to percentiles once the replay is finished.
+   *
+   * @param trace The trace to replay.
+   * @param train The train to replay into; holds the final state afterwards.
+   * @return The latency report.
+   */
+  ReplayReport replayTrace(const Trace& trace, Train& train) {
+    using Clock = std::chrono::steady_clock;
+
+    ReplayReport report;
+    std::vector<int64_t> samples[TRACE_OP_TYPES];
+
+    train = trace.initial;
+
+    for (const TraceOp& op : trace.ops) {
+      int kind = static_cast<int>(op.type);
+      Clock::time_point start = Clock::now();
+      try {
+        applyOp(op, train);
+      } catch (const std::exception&) {
+        report.ops[kind].failures++;
+      }
+      int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+      samples[kind].push_back(elapsed);
+      report.totalNanoseconds += elapsed;
+    }
+
+    for (int kind = 0; kind < TRACE_OP_TYPES; kind++) {
+      std::vector<int64_t>& sorted = samples[kind];
+      std::sort(sorted.begin(), sorted.end());
+      OpLatency& latency = report.ops[kind];
+      latency.count = static_cast<int64_t>(sorted.size());
+      latency.p50 = nearestRankPercentile(sorted, 0.50);
+      latency.p99 = nearestRankPercentile(sorted, 0.99);
+      latency.p999 = nearestRankPercentile(sorted, 0.999);
+      latency.max = sorted.empty() ? 0 : sorted.back();
+      report.totalOps += latency.count;
+    }
+
+    return report;
+  }
+
+  /**
+   * @brief Compare two trains wagon by wagon.
+   *
+   * @param actual The train produced by the replay.
+   * @param reference The train produced by the reference run.
+   * @return -1 if the trains are identical, otherwise the index of the first differing wagon.
+   */
+  int findFirstDifference(const Train& actual, const Train& reference) {
+    auto [actualIt, referenceIt] = std::ranges::mismatch(actual, reference);
+    if (actualIt == actual.end() && referenceIt == reference.end()) {
+      return -1;
+    }
+    return static_cast<int>(actualIt - actual.begin());
+  }
+
+  /**
+   * @brief Overloaded input operator for reading a trace.
+   *
+   * The initial train is read first, followed by operations until the end of the stream.
+   *
+   * @param is The input stream from which the trace is read.
+   * @param trace The trace to store the read data.
+   * @return The input stream; failbit is set on an unknown or malformed operation.
+   */
+  std::istream& operator>>(std::istream& is, Trace& trace) {
+    Trace tempTrace;
+
+    is >> tempTrace.initial;
+    if (is.fail()) {
+      return is;
+    }
+
+    char code;
+    while (is >> code) {
+      TraceOp op;
+      int typeInt = 0;
+      switch (code) {
+        case 'B':
+          op.type = TraceOpType::BOARD;
+          is >> typeInt >> op.passengers;
+          if (!wagonTypeFromSerialCode(typeInt, op.wagonType)) {
+            is.setstate(std::ios::failbit);
+          }
+          break;
+        case 'D':
+          op.type = TraceOpType::DISEMBARK;
+          is >> op.index >> op.passengers;
+          break;
+        case 'A':
+          op.type = TraceOpType::ADD_WAGON;
+          readWagonRecord(is, op.wagon);
+          break;
+        case 'I':
+          op.type = TraceOpType::INSERT_WAGON;
+          is >> op.index;
+          readWagonRecord(is, op.wagon);
+          break;
+        case 'R':
+          op.type = TraceOpType::REMOVE_WAGON;
+          is >> op.index;
+          break;
+        case 'S':
+          op.type = TraceOpType::REDISTRIBUTE;
+          break;
+        case 'O':
+          op.type = TraceOpType::OPTIMIZE;
+          break;
+        case 'P':
+          op.type = TraceOpType::RESTAURANT_PLACEMENT;
+          break;
+        default:
+          is.setstate(std::ios::failbit);
+          break;
+      }
+
+      if (is.fail()) {
+        return is;
+      }
+      tempTrace.ops.push_back(op);
+    }
+
+    // Reaching the end of the stream after the last operation is the normal way to finish
+    if (is.eof() && !is.bad()) {
+      is.clear(std::ios::eofbit);
+      trace = std::move(tempTrace);
+    }
+    return is;
+  }
+
+  /**
+   * @brief Overloaded output operator for writing a replay report as a table.
+   *
+   * One row is written per operation kind that occurred in the trace, followed by the throughput.
+   *
+   * @param os The output stream.
+   * @param report The report to write.
+   * @return The output stream.
+   */
+  std::ostream& operator<<(std::ostream& os, const ReplayReport& report) {
+    os << std::left << std::setw(22) << "operation" << std::right
+       << std::setw(10) << "count" << std::setw(10) << "failed"
+       << std::setw(12) << "p50 ns" << std::setw(12) << "p99 ns"
+       << std::setw(12) << "p999 ns" << std::setw(12) << "max ns" << std::endl;
+    for (int kind = 0; kind < TRACE_OP_TYPES; kind++) {
+      const OpLatency& latency = report.ops[kind];
+      if (latency.count == 0) {
+        continue;
+      }
+      os << std::left << std::setw(22) << traceOpName(static_cast<TraceOpType>(kind)) << std::right
+         << std::setw(10) << latency.count << std::setw(10) << latency.failures
+         << std::setw(12) << latency.p50 << std::setw(12) << latency.p99
+         << std::setw(12) << latency.p999 << std::setw(12) << latency.max << std::endl;
+    }
+    os << "total: " << report.totalOps << " ops, " << std::fixed << std::setprecision(0)
+       << report.getThroughput() << " ops/s" << std::endl;
+    return os;
+  }
+
+} // namespace lab2ComplexClass
@@ -0,0 +1,128 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "train.h"
+
+namespace lab2ComplexClass {
+
+  /// @brief Enumeration for the operation kinds recorded in a production trace.
+  enum class TraceOpType { BOARD, DISEMBARK, ADD_WAGON, INSERT_WAGON, REMOVE_WAGON, REDISTRIBUTE, OPTIMIZE, RESTAURANT_PLACEMENT };
+
+  /// @brief Number of operation kinds in TraceOpType.
+  constexpr int TRACE_OP_TYPES = 8;
+
+  /**
+   * @brief A single recorded operation on a train.
+   *
+   * Only the fields relevant for the operation kind are meaningful.
+   */
+  struct TraceOp {
+    TraceOpType type = TraceOpType::BOARD; ///< Operation kind.
+    int index = 0;                         ///< Wagon index (DISEMBARK, INSERT_WAGON, REMOVE_WAGON).
+    int passengers = 0;                    ///< Number of passengers (BOARD, DISEMBARK).
+    WagonType wagonType = WagonType::SITTING; ///< Wagon class to board into (BOARD).
+    Wagon wagon;                           ///< Wagon to add (ADD_WAGON, INSERT_WAGON).
+  };
+
+  /**
+   * @brief A recorded operation stream together with the train it starts from.
+   *
+   * Text format: the initial train as accepted by the train input operator, followed by one operation per line:
+   * - "B type passengers"            board passengers to the most available wagon of the type;
+   * - "D index passengers"           disembark passengers from a wagon;
+   * - "A type capacity occupied"     add a wagon to the end of the train;
+   * - "I index type capacity occupied" insert a wagon at the index;
+   * - "R index"                      remove a wagon;
+   * - "S"                            redistribute passengers;
+   * - "O"                            optimize the train;
+   * - "P"                            optimize the restaurant placement.
+   */
+  struct Trace {
+    Train initial;              ///< Train state before the first operation.
+    std::vector<TraceOp> ops;   ///< Recorded operations in order.
+  };
+
+  /// @brief Latency statistics of one operation kind, in nanoseconds.
+  struct OpLatency {
+    int64_t count = 0;     ///< Number of replayed operations.
+    int64_t failures = 0;  ///< Number of operations rejected by the train (exceptions).
+    int64_t p50 = 0;       ///< Median latency.
+    int64_t p99 = 0;       ///< 99th percentile latency.
+    int64_t p999 = 0;      ///< 99.9th percentile latency.
+    int64_t max = 0;       ///< Maximum latency.
+  };
+
+  /// @brief Result of replaying a trace.
+  struct ReplayReport {
+    OpLatency ops[TRACE_OP_TYPES];  ///< Statistics indexed by TraceOpType.
+    int64_t totalOps = 0;           ///< Number of replayed operations.
+    int64_t totalNanoseconds = 0;   ///< Wall time spent inside the operations.
+
+    /// @brief Get the replay throughput.
+    /// @return Operations per second, or 0 if nothing was replayed.
+    double getThroughput() const;
+  };
+
+  /**
+   * @brief Get the trace mnemonic of an operation kind.
+   *
+   * @param type The operation kind.
+   * @return The human-readable name of the operation kind.
+   */
+  const char* traceOpName(TraceOpType type);
+
+  /**
+   * @brief Get a percentile from a sorted vector of samples (nearest-rank method).
+   *
+   * @param sorted The sorted samples.
+   * @param fraction The percentile as a fraction in [0, 1].
+   * @return The sample at the percentile, or 0 if there are no samples.
+   */
+  int64_t nearestRankPercentile(const std::vector<int64_t>& sorted, double fraction);
+
+  /**
+   * @brief Replay a trace against a train and measure the latency of every operation.
+   *
+   * The train is reset to the initial state of the trace before replaying. Operations rejected by the
+   * train (any std::exception) are counted as failures and the replay continues.
+   *
+   * @param trace The trace to replay.
+   * @param train The train to replay into; holds the final state afterwards.
+   * @return The latency report.
+   */
+  ReplayReport replayTrace(const Trace& trace, Train& train);
+
+  /**
+   * @brief Compare two trains wagon by wagon.
+   *
+   * @param actual The train produced by the replay.
+   * @param reference The train produced by the reference run.
+   * @return -1 if the trains are identical, otherwise the index of the first differing wagon
+   * (or the length of the shorter train if one is a prefix of the other).
+   */
+  int findFirstDifference(const Train& actual, const Train& reference);
+
+  /**
+   * @brief Overloaded input operator for reading a trace.
+   *
+   * @param is The input stream from which the trace is read.
+   * @param trace The trace to store the read data.
+   * @return The input stream; failbit is set on an unknown or malformed operation.
+   */
+  std::istream& operator>>(std::istream& is, Trace& trace);
+
+  /**
+   * @brief Overloaded output operator for writing a replay report as a table.
+   *
+   * @param os The output stream.
+   * @param report The report to write.
+   * @return The output stream.
+   */
+  std::ostream& operator<<(std::ostream& os, const ReplayReport& report);
+
+} // namespace lab2ComplexClass
+
+#endif // REPLAY_H
@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <stdexcept>
+#include "route_reservations.h"
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief Constructor, creates an empty route.
+   *
+   * @param numStops The number of stops, at least 2.
+   * @param initialOccupancy Passengers travelling the whole route.
+   * @throws std::invalid_argument if there are fewer than 2 stops.
+   */
+  SegmentOccupancy::SegmentOccupancy(int numStops, int initialOccupancy) : numStops(numStops) {
+    if (numStops < 2) {
+      throw std::invalid_argument("A route needs at least two stops.");
+    }
+    int numSegments = numStops - 1;
+    // Halving [0, numSegments) keeps the node indices below twice the next power of two
+    size_t numNodes = 2 * std::bit_ceil(static_cast<size_t>(numSegments));
+    maxTree.assign(numNodes, 0);
+    minTree.assign(numNodes, 0);
+    pending.assign(numNodes, 0);
+    add(1, 0, numSegments, 0, numSegments, initialOccupancy);
+  }
+
+  /**
+   * @brief Add a count to the segments [from, to) within a node covering [left, right).
+   *
+   * A fully covered node keeps the count in pending instead of pushing it down; its summaries include it.
+   */
+  void SegmentOccupancy::add(int node, int left, int right, int from, int to, int delta) {
+    if (to <= left || right <= from) {
+      return;
+    }
+    if (from <= left && right <= to) {
+      maxTree[node] += delta;
+      minTree[node] += delta;
+      pending[node] += delta;
+      return;
+    }
+    int middle = (left + right) / 2;
+    add(2 * node, left, middle, from, to, delta);
+    add(2 * node + 1, middle, right, from, to, delta);
+    maxTree[node] = std::max(maxTree[2 * node], maxTree[2 * node + 1]) + pending[node];
+    minTree[node] = std::min(minTree[2 * node], minTree[2 * node + 1]) + pending[node];
+  }
+
+  /**
+   * @brief Get the maximum over the segments [from, to) within a node covering [left, right).
+   */
+  int SegmentOccupancy::queryMax(int node, int left, int right, int from, int to) const {
+    if (to <= left || right <= from) {
+      return std::numeric_limits<int>::min();
+    }
+    if (from <= left && right <= to) {
+      return maxTree[node];
+    }
+    int middle = (left + right) / 2;
+    return std::max(queryMax(2 * node, left, middle, from, to), queryMax(2 * node + 1, middle, right, from, to)) +
+           pending[node];
+  }
+
+  /**
+   * @brief Get the minimum over the segments [from, to) within a node covering [left, right).
+   */
+  int SegmentOccupancy::queryMin(int node, int left, int right, int from, int to) const {
+    if (to <= left || right <= from) {
+      return std::numeric_limits<int>::max();
+    }
+    if (from <= left && right <= to) {
+      return minTree[node];
+    }
+    int middle = (left + right) / 2;
+    return std::min(queryMin(2 * node, left, middle, from, to), queryMin(2 * node + 1, middle, right, from, to)) +
+           pending[node];
+  }
+
+  /**
+   * @brief Check a stop interval.
+   *
+   * @param from The stop where the interval starts.
+   * @param to The stop where the interval ends.
+   * @throws std::out_of_range unless 0 <= from < to < number of stops.
+   */
+  void SegmentOccupancy::checkInterval(int from, int to) const {
+    if (from < 0 || from >= to || to >= numStops) {
+      throw std::out_of_range("Invalid stop interval.");
+    }
+  }
+
+  /**
+   * @brief Get the number of stops.
+   *
+   * @return The number of stops.
+   */
+  int SegmentOccupancy::getNumStops() const { return numStops; }
+
+  /**
+   * @brief Add passengers travelling between two stops; a negative count removes them.
+   *
+   * @param from The stop where they board.
+   * @param to The stop where they leave.
+   * @param passengers The number of passengers.
+   * @throws std::out_of_range if the interval is invalid.
+   */
+  void SegmentOccupancy::addPassengers(int from, int to, int passengers) {
+    checkInterval(from, to);
+    add(1, 0, numStops - 1, from, to, passengers);
+  }
+
+  /**
+   * @brief Get the largest occupancy of a segment between two stops.
+   *
+   * @param from The first stop.
+   * @param to The last stop.
+   * @return The maximum occupancy over segments from .. to - 1.
+   * @throws std::out_of_range if the interval is invalid.
+   */
+  int SegmentOccupancy::maxOccupancy(int from, int to) const {
+    checkInterval(from, to);
+    return queryMax(1, 0, numStops - 1, from, to);
+  }
+
+  /**
+   * @brief Get the smallest occupancy of a segment between two stops.
+   *
+   * @param from The first stop.
+   * @param to The last stop.
+   * @return The minimum occupancy over segments from .. to - 1.
+   * @throws std::out_of_range if the interval is invalid.
+   */
+  int SegmentOccupancy::minOccupancy(int from, int to) const {
+    checkInterval(from, to);
+    return queryMin(1, 0, numStops - 1, from, to);
+  }
+
+  /**
+   * @brief Constructor.
+   *
+   * @param train The train; its occupied seats are taken for the whole route.
+   * @param numStops The number of stops, at least 2.
+   * @throws std::invalid_argument if there are fewer than 2 stops.
+   */
+  RouteReservations::RouteReservations(const Train& train, int numStops) : train(train), numStops(numStops) {
+    if (numStops < 2) {
+      throw std::invalid_argument("A route needs at least two stops.");
+    }
+    occupancies.reserve(train.getNumWagons());
+    for (const Wagon& wagon : train.view()) {
+      occupancies.emplace_back(numStops, wagon.getOccupiedSeats());
+    }
+  }
+
+  /**
+   * @brief Check a wagon index.
+   *
+   * @param wagonIndex The index of the wagon.
+   * @throws std::out_of_range if the index is invalid.
+   */
+  void RouteReservations::checkWagon(int wagonIndex) const {
+    if (wagonIndex < 0 || wagonIndex >= train.getNumWagons()) {
+      throw std::out_of_range("Invalid wagon index.");
+    }
+  }
+
+  /**
+   * @brief Check a stop interval.
+   *
+   * @param from The stop where the interval starts.
+   * @param to The stop where the interval ends.
+   * @throws std::out_of_range unless 0 <= from < to < number of stops.
+   */
+  void RouteReservations::checkInterval(int from, int to) const {
+    if (from < 0 || from >= to || to >= numStops) {
+      throw std::out_of_range("Invalid stop interval.");
+    }
+  }
+
+  /**
+   * @brief Get the train.
+   *
+   * @return The train the bookings are made on.
+   */
+  const Train& RouteReservations::getTrain() const { return train; }
+
+  /**
+   * @brief Get the number of stops.
+   *
+   * @return The number of stops.
+   */
+  int RouteReservations::getNumStops() const { return numStops; }
+
+  /**
+   * @brief Get the number of seats of a wagon free on every segment between two stops.
+   *
+   * @param wagonIndex The index of the wagon.
+   * @param from The first stop.
+   * @param to The last stop.
+   * @return The number of free seats.
+   * @throws std::out_of_range if the wagon index or the interval is invalid.
+   */
+  int RouteReservations::getFreeSeats(int wagonIndex, int from, int to) const {
+    checkWagon(wagonIndex);
+    return train.view()[wagonIndex].getMaxCapacity() - occupancies[wagonIndex].maxOccupancy(from, to);
+  }
+
+  /**
+   * @brief Find the wagon Train::boardPassengersToMostAvailableWagon would choose, judged over an interval.
+   *
+   * @param passengers The number of passengers.
+   * @param wagonType The class of wagon.
+   * @param from The stop where they board.
+   * @param to The stop where they leave.
+   * @return The index of the wagon, or -1 if there is none.
+   * @throws std::out_of_range if the interval is invalid.
+   */
+  int RouteReservations::findMostAvailableWagon(int passengers, WagonType wagonType, int from, int to) const {
+    checkInterval(from, to);
+    int best = -1;
+    int bestOccupancy = 0;
+    std::span<const Wagon> wagons = train.view();
+    for (int i = 0; i < static_cast<int>(wagons.size()); i++) {
+      if (wagons[i].getType() != wagonType) {
+        continue;
+      }
+      int peak = occupancies[i].maxOccupancy(from, to);
+      if (wagons[i].getMaxCapacity() - peak >= passengers && (best < 0 || peak > bestOccupancy)) {
+        best = i;
+        bestOccupancy = peak;
+      }
+    }
+    return best;
+  }
+
+  /**
+   * @brief Book passengers into the wagon findMostAvailableWagon chooses.
+   *
+   * @param passengers The number of passengers.
+   * @param wagonType The class of wagon.
+   * @param from The stop where they board.
+   * @param to The stop where they leave.
+   * @return The index of the wagon.
+   * @throws std::invalid_argument if the count is negative or no wagon can take them.
+   * @throws std::out_of_range if the interval is invalid.
+   */
+  int RouteReservations::bookToMostAvailableWagon(int passengers, WagonType wagonType, int from, int to) {
+    if (passengers < 0) {
+      throw std::invalid_argument("Cannot board negative number of passengers");
+    }
+    int best = findMostAvailableWagon(passengers, wagonType, from, to);
+    if (best < 0 || !wagonTypeTraits(wagonType).canBoard) {
+      throw std::invalid_argument("No available wagons of the specified type can accommodate the specified number of passengers.");
+    }
+    occupancies[best].addPassengers(from, to, passengers);
+    return best;
+  }
+
+  /**
+   * @brief Book passengers into a particular wagon.
+   *
+   * @param wagonIndex The index of the wagon.
+   * @param passengers The number of passengers.
+   * @param from The stop where they board.
+   * @param to The stop where they leave.
+   * @throws std::invalid_argument if the count is negative or the wagon cannot take them on some segment.
+   * @throws std::out_of_range if the wagon index or the interval is invalid.
+   */
+  void RouteReservations::book(int wagonIndex, int passengers, int from, int to) {
+    if (passengers < 0) {
+      throw std::invalid_argument("Cannot board negative number of passengers");
+    }
+    if (getFreeSeats(wagonIndex, from, to) < passengers || !wagonTypeTraits(train.view()[wagonIndex].getType()).canBoard) {
+      throw std::invalid_argument("Wagon is full. Cannot board more passengers.");
+    }
+    occupancies[wagonIndex].addPassengers(from, to, passengers);
+  }
+
+  /**
+   * @brief Cancel a booking.
+   *
+   * @param wagonIndex The index of the wagon.
+   * @param passengers The number of passengers.
+   * @param from The stop where they board.
+   * @param to The stop where they leave.
+   * @throws std::invalid_argument if the count is negative or some segment has fewer passengers.
+   * @throws std::out_of_range if the wagon index or the interval is invalid.
+   */
+  void RouteReservations::cancel(int wagonIndex, int passengers, int from, int to) {
+    checkWagon(wagonIndex);
+    if (passengers < 0) {
+      throw std::invalid_argument("Cannot disembark negative number of passengers");
+    }
+    if (occupancies[wagonIndex].minOccupancy(from, to) < passengers) {
+      throw std::invalid_argument("There are not enough people in the Wagon to disembark.");
+    }
+    occupancies[wagonIndex].addPassengers(from, to, -passengers);
+  }
+
+} // namespace lab2ComplexClass
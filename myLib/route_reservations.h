@@ -0,0 +1,208 @@
+#ifndef ROUTE_RESERVATIONS_H
+#define ROUTE_RESERVATIONS_H
+
+#include <vector>
+#include "train.h"
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief Occupancy of one wagon along a route, per segment between consecutive stops.
+   *
+   * A booking from stop `from` to stop `to` occupies segments from .. to - 1. The counts are kept in a segment
+   * tree with lazy range increments, so adding a booking and querying the maximum or minimum occupancy over a
+   * stop interval both take O(log S) for S stops.
+   */
+  class SegmentOccupancy {
+    private:
+      int numStops;              // Количество остановок маршрута
+      std::vector<int> maxTree;  // Максимум занятости в поддереве, включая отложенные прибавки
+      std::vector<int> minTree;  // Минимум занятости в поддереве, включая отложенные прибавки
+      std::vector<int> pending;  // Прибавка, относящаяся ко всему поддереву и ещё не переданная детям
+
+      /// @brief Add a count to the segments [from, to) within a node covering [left, right).
+      void add(int node, int left, int right, int from, int to, int delta);
+
+      /// @brief Get the maximum over the segments [from, to) within a node covering [left, right).
+      int queryMax(int node, int left, int right, int from, int to) const;
+
+      /// @brief Get the minimum over the segments [from, to) within a node covering [left, right).
+      int queryMin(int node, int left, int right, int from, int to) const;
+
+      /**
+       * @brief Check a stop interval.
+       *
+       * @param from The stop where the interval starts.
+       * @param to The stop where the interval ends.
+       * @throws std::out_of_range unless 0 <= from < to < number of stops.
+       */
+      void checkInterval(int from, int to) const;
+
+    public:
+      /**
+       * @brief Constructor, creates an empty route.
+       *
+       * @param numStops The number of stops, at least 2.
+       * @param initialOccupancy Passengers travelling the whole route.
+       * @throws std::invalid_argument if there are fewer than 2 stops.
+       */
+      explicit SegmentOccupancy(int numStops, int initialOccupancy = 0);
+
+      /**
+       * @brief Get the number of stops.
+       *
+       * @return The number of stops.
+       */
+      int getNumStops() const;
+
+      /**
+       * @brief Add passengers travelling between two stops; a negative count removes them.
+       *
+       * @param from The stop where they board.
+       * @param to The stop where they leave.
+       * @param passengers The number of passengers.
+       * @throws std::out_of_range if the interval is invalid.
+       */
+      void addPassengers(int from, int to, int passengers);
+
+      /**
+       * @brief Get the largest occupancy of a segment between two stops.
+       *
+       * @param from The first stop.
+       * @param to The last stop.
+       * @return The maximum occupancy over segments from .. to - 1.
+       * @throws std::out_of_range if the interval is invalid.
+       */
+      int maxOccupancy(int from, int to) const;
+
+      /**
+       * @brief Get the smallest occupancy of a segment between two stops.
+       *
+       * @param from The first stop.
+       * @param to The last stop.
+       * @return The minimum occupancy over segments from .. to - 1.
+       * @throws std::out_of_range if the interval is invalid.
+       */
+      int minOccupancy(int from, int to) const;
+  };
+
+  /**
+   * @brief Origin-destination bookings on the wagons of a train.
+   *
+   * Each wagon gets a SegmentOccupancy; the passengers already in a wagon travel the whole route. Searching
+   * the train for a wagon that can take a group over [from, to) costs O(n log S) instead of O(n S).
+   */
+  class RouteReservations {
+    private:
+      Train train;                                // Поезд; его вагоны задают тип и вместимость
+      int numStops;                               // Количество остановок маршрута
+      std::vector<SegmentOccupancy> occupancies;  // Занятость каждого вагона по участкам маршрута
+
+      /**
+       * @brief Check a wagon index.
+       *
+       * @param wagonIndex The index of the wagon.
+       * @throws std::out_of_range if the index is invalid.
+       */
+      void checkWagon(int wagonIndex) const;
+
+      /**
+       * @brief Check a stop interval.
+       *
+       * @param from The stop where the interval starts.
+       * @param to The stop where the interval ends.
+       * @throws std::out_of_range unless 0 <= from < to < number of stops.
+       */
+      void checkInterval(int from, int to) const;
+
+    public:
+      /**
+       * @brief Constructor.
+       *
+       * @param train The train; its occupied seats are taken for the whole route.
+       * @param numStops The number of stops, at least 2.
+       * @throws std::invalid_argument if there are fewer than 2 stops.
+       */
+      RouteReservations(const Train& train, int numStops);
+
+      /**
+       * @brief Get the train.
+       *
+       * @return The train the bookings are made on.
+       */
+      const Train& getTrain() const;
+
+      /**
+       * @brief Get the number of stops.
+       *
+       * @return The number of stops.
+       */
+      int getNumStops() const;
+
+      /**
+       * @brief Get the number of seats of a wagon free on every segment between two stops.
+       *
+       * @param wagonIndex The index of the wagon.
+       * @param from The first stop.
+       * @param to The last stop.
+       * @return The number of free seats.
+       * @throws std::out_of_range if the wagon index or the interval is invalid.
+       */
+      int getFreeSeats(int wagonIndex, int from, int to) const;
+
+      /**
+       * @brief Find the wagon Train::boardPassengersToMostAvailableWagon would choose, judged over an interval.
+       *
+       * Among wagons of the class that have enough seats free on every segment, the one with the highest
+       * peak occupancy wins; ties go to the first.
+       *
+       * @param passengers The number of passengers.
+       * @param wagonType The class of wagon.
+       * @param from The stop where they board.
+       * @param to The stop where they leave.
+       * @return The index of the wagon, or -1 if there is none.
+       * @throws std::out_of_range if the interval is invalid.
+       */
+      int findMostAvailableWagon(int passengers, WagonType wagonType, int from, int to) const;
+
+      /**
+       * @brief Book passengers into the wagon findMostAvailableWagon chooses.
+       *
+       * @param passengers The number of passengers.
+       * @param wagonType The class of wagon.
+       * @param from The stop where they board.
+       * @param to The stop where they leave.
+       * @return The index of the wagon.
+       * @throws std::invalid_argument if the count is negative or no wagon can take them.
+       * @throws std::out_of_range if the interval is invalid.
+       */
+      int bookToMostAvailableWagon(int passengers, WagonType wagonType, int from, int to);
+
+      /**
+       * @brief Book passengers into a particular wagon.
+       *
+       * @param wagonIndex The index of the wagon.
+       * @param passengers The number of passengers.
+       * @param from The stop where they board.
+       * @param to The stop where they leave.
+       * @throws std::invalid_argument if the count is negative or the wagon cannot take them on some segment.
+       * @throws std::out_of_range if the wagon index or the interval is invalid.
+       */
+      void book(int wagonIndex, int passengers, int from, int to);
+
+      /**
+       * @brief Cancel a booking.
+       *
+       * @param wagonIndex The index of the wagon.
+       * @param passengers The number of passengers.
+       * @param from The stop where they board.
+       * @param to The stop where they leave.
+       * @throws std::invalid_argument if the count is negative or some segment has fewer passengers.
+       * @throws std::out_of_range if the wagon index or the interval is invalid.
+       */
+      void cancel(int wagonIndex, int passengers, int from, int to);
+  };
+
+} // namespace lab2ComplexClass
+
+#endif // ROUTE_RESERVATIONS_H
@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include "seat_map.h"
+
+namespace lab2SimpleClass {
+
+  /**
+   * @brief Get the free seats of a word; seats past the end are reported as occupied.
+   *
+   * @param word The index of the word.
+   * @return A mask with a bit set for every free seat.
+   */
+  uint64_t SeatMap::freeMask(int word) const {
+    uint64_t free = ~words[word];
+    int seatsInWord = numSeats - word * WORD_BITS;
+    if (seatsInWord < WORD_BITS) {
+      free &= (uint64_t{1} << seatsInWord) - 1;
+    }
+    return free;
+  }
+
+  /**
+   * @brief Check a seat number.
+   *
+   * @param seat The seat number.
+   * @throws std::out_of_range if there is no such seat.
+   */
+  void SeatMap::checkSeat(int seat) const {
+    if (seat < 0 || seat >= numSeats) {
+      throw std::out_of_range("Invalid seat number.");
+    }
+  }
+
+  /**
+   * @brief Constructor, creates a map with every seat free.
+   *
+   * @param numSeats The number of seats.
+   * @throws std::invalid_argument if the number is negative.
+   */
+  SeatMap::SeatMap(int numSeats) : numSeats(numSeats) {
+    if (numSeats < 0) {
+      throw std::invalid_argument("Number of seats cannot be negative.");
+    }
+    words.assign((numSeats + WORD_BITS - 1) / WORD_BITS, 0);
+  }
+
+  /**
+   * @brief Get the number of seats.
+   *
+   * @return The number of seats.
+   */
+  int SeatMap::getNumSeats() const { return numSeats; }
+
+  /**
+   * @brief Count the occupied seats with popcount.
+   *
+   * @return The number of occupied seats.
+   */
+  int SeatMap::countOccupied() const {
+    int occupied = 0;
+    for (uint64_t word : words) {
+      occupied += std::popcount(word);
+    }
+    return occupied;
+  }
+
+  /**
+   * @brief Check whether a seat is occupied.
+   *
+   * @param seat The seat number.
+   * @return True if the seat is occupied.
+   * @throws std::out_of_range if there is no such seat.
+   */
+  bool SeatMap::isOccupied(int seat) const {
+    checkSeat(seat);
+    return (words[seat / WORD_BITS] >> (seat % WORD_BITS)) & 1;
+  }
+
+  /**
+   * @brief Occupy a seat.
+   *
+   * @param seat The seat number.
+   * @throws std::out_of_range if there is no such seat.
+   * @throws std::invalid_argument if the seat is already occupied.
+   */
+  void SeatMap::occupy(int seat) {
+    if (isOccupied(seat)) {
+      throw std::invalid_argument("Seat is already occupied.");
+    }
+    words[seat / WORD_BITS] |= uint64_t{1} << (seat % WORD_BITS);
+  }
+
+  /**
+   * @brief Free a seat.
+   *
+   * @param seat The seat number.
+   * @throws std::out_of_range if there is no such seat.
+   * @throws std::invalid_argument if the seat is not occupied.
+   */
+  void SeatMap::release(int seat) {
+    if (!isOccupied(seat)) {
+      throw std::invalid_argument("Seat is not occupied.");
+    }
+    words[seat / WORD_BITS] &= ~(uint64_t{1} << (seat % WORD_BITS));
+  }
+
+  /**
+   * @brief Find the first free seat at or after a seat.
+   *
+   * @param from The seat to start from.
+   * @return The seat number, or -1 if there is none.
+   */
+  int SeatMap::findFreeSeat(int from) const {
+    from = std::max(from, 0);
+    if (from >= numSeats) {
+      return -1;
+    }
+    int word = from / WORD_BITS;
+    uint64_t free = freeMask(word) & (~uint64_t{0} << (from % WORD_BITS));
+    while (free == 0) {
+      if (++word == static_cast<int>(words.size())) {
+        return -1;
+      }
+      free = freeMask(word);
+    }
+    return word * WORD_BITS + std::countr_zero(free);
+  }
+
+  /**
+   * @brief Find the first block of adjacent free seats.
+   *
+   * Walks the runs of free seats word by word: countr_zero skips occupied seats and countr_one measures a free
+   * run, which is carried into the next word when it reaches the end of the current one.
+   *
+   * @param count The number of seats in the block.
+   * @return The first seat of the block, or -1 if there is none.
+   * @throws std::invalid_argument if the count is not positive.
+   */
+  int SeatMap::findAdjacentFreeSeats(int count) const {
+    if (count <= 0) {
+      throw std::invalid_argument("Number of adjacent seats must be positive.");
+    }
+    int runStart = 0;
+    int runLength = 0;
+    for (int word = 0; word < static_cast<int>(words.size()); word++) {
+      uint64_t free = freeMask(word);
+      int bit = 0;
+      while (bit < WORD_BITS) {
+        uint64_t rest = free >> bit;
+        if (rest == 0) {
+          runLength = 0;
+          break;
+        }
+        int occupied = std::countr_zero(rest);
+        if (occupied > 0) {
+          runLength = 0;
+          bit += occupied;
+          rest >>= occupied;
+        }
+        int run = std::countr_one(rest);
+        if (runLength == 0) {
+          runStart = word * WORD_BITS + bit;
+        }
+        runLength += run;
+        if (runLength >= count) {
+          return runStart;
+        }
+        bit += run;
+      }
+    }
+    return -1;
+  }
+
+  /**
+   * @brief Occupy the lowest-numbered free seats.
+   *
+   * @param count The number of seats.
+   * @return The occupied seats in increasing order.
+   * @throws std::invalid_argument if the count is negative or there are fewer free seats; nothing is occupied then.
+   */
+  std::vector<int> SeatMap::assignSeats(int count) {
+    if (count < 0) {
+      throw std::invalid_argument("Number of seats cannot be negative.");
+    }
+    if (count > numSeats - countOccupied()) {
+      throw std::invalid_argument("Not enough free seats.");
+    }
+    std::vector<int> assigned;
+    assigned.reserve(count);
+    for (int word = 0; static_cast<int>(assigned.size()) < count; word++) {
+      uint64_t free = freeMask(word);
+      while (free != 0 && static_cast<int>(assigned.size()) < count) {
+        assigned.push_back(word * WORD_BITS + std::countr_zero(free));
+        words[word] |= free & -free;
+        free &= free - 1;
+      }
+    }
+    return assigned;
+  }
+
+  /**
+   * @brief Occupy the first block of adjacent free seats.
+   *
+   * @param count The number of seats in the block.
+   * @return The occupied seats in increasing order.
+   * @throws std::invalid_argument if the count is not positive or there is no such block.
+   */
+  std::vector<int> SeatMap::assignAdjacentSeats(int count) {
+    int first = findAdjacentFreeSeats(count);
+    if (first < 0) {
+      throw std::invalid_argument("No block of adjacent free seats is large enough.");
+    }
+    std::vector<int> assigned(count);
+    for (int i = 0; i < count; i++) {
+      assigned[i] = first + i;
+      words[(first + i) / WORD_BITS] |= uint64_t{1} << ((first + i) % WORD_BITS);
+    }
+    return assigned;
+  }
+
+  /**
+   * @brief Free the highest-numbered occupied seats.
+   *
+   * @param count The number of seats.
+   * @throws std::invalid_argument if the count is negative or fewer seats are occupied.
+   */
+  void SeatMap::releaseLastSeats(int count) {
+    if (count < 0 || count > countOccupied()) {
+      throw std::invalid_argument("Not enough occupied seats to release.");
+    }
+    for (int word = static_cast<int>(words.size()) - 1; count > 0; word--) {
+      while (words[word] != 0 && count > 0) {
+        words[word] &= ~(uint64_t{1} << (WORD_BITS - 1 - std::countl_zero(words[word])));
+        count--;
+      }
+    }
+  }
+
+  /**
+   * @brief Constructor from a wagon; its passengers take the lowest-numbered seats.
+   *
+   * @param wagon The wagon.
+   */
+  SeatedWagon::SeatedWagon(const Wagon& wagon) : wagon(wagon), seats(wagon.getMaxCapacity()) {
+    seats.assignSeats(wagon.getOccupiedSeats());
+  }
+
+  /**
+   * @brief Constructor with initialization of only the type.
+   *
+   * @param type Type of the wagon.
+   */
+  SeatedWagon::SeatedWagon(WagonType type) : SeatedWagon(Wagon(type)) {}
+
+  /**
+   * @brief Get the wagon without the seat map.
+   *
+   * @return The wagon.
+   */
+  const Wagon& SeatedWagon::getWagon() const { return wagon; }
+
+  /**
+   * @brief Get the seat map.
+   *
+   * @return The seat map.
+   */
+  const SeatMap& SeatedWagon::getSeatMap() const { return seats; }
+
+  /**
+   * @brief Get the maximum capacity of the wagon.
+   *
+   * @return Maximum capacity.
+   */
+  int SeatedWagon::getMaxCapacity() const { return wagon.getMaxCapacity(); }
+
+  /**
+   * @brief Get the number of currently occupied seats in the wagon.
+   *
+   * @return Number of occupied seats.
+   */
+  int SeatedWagon::getOccupiedSeats() const { return wagon.getOccupiedSeats(); }
+
+  /**
+   * @brief Get the type of the wagon.
+   *
+   * @return Type of the wagon.
+   */
+  WagonType SeatedWagon::getType() const { return wagon.getType(); }
+
+  /**
+   * @brief Board passengers into the lowest-numbered free seats.
+   *
+   * @param passengers Number of passengers to board.
+   * @throws std::invalid_argument in the same cases as Wagon::boardPassengers.
+   */
+  void SeatedWagon::boardPassengers(int passengers) { boardPassengersWithSeats(passengers); }
+
+  /**
+   * @brief Board passengers into the lowest-numbered free seats.
+   *
+   * The wagon checks the count first, so the seat map always has enough free seats.
+   *
+   * @param passengers Number of passengers to board.
+   * @return The assigned seats in increasing order.
+   * @throws std::invalid_argument in the same cases as Wagon::boardPassengers.
+   */
+  std::vector<int> SeatedWagon::boardPassengersWithSeats(int passengers) {
+    wagon.boardPassengers(passengers);
+    return seats.assignSeats(passengers);
+  }
+
+  /**
+   * @brief Board a group into the first block of adjacent free seats.
+   *
+   * @param passengers Number of passengers in the group.
+   * @return The assigned seats in increasing order.
+   * @throws std::invalid_argument if the wagon is a restaurant or has no such block.
+   */
+  std::vector<int> SeatedWagon::boardAdjacentPassengers(int passengers) {
+    if (seats.findAdjacentFreeSeats(passengers) < 0) {
+      throw std::invalid_argument("No block of adjacent free seats is large enough.");
+    }
+    wagon.boardPassengers(passengers);
+    return seats.assignAdjacentSeats(passengers);
+  }
+
+  /**
+   * @brief Disembark passengers from the highest-numbered occupied seats.
+   *
+   * @param passengers Number of passengers to disembark.
+   * @throws std::invalid_argument in the same cases as Wagon::disembarkPassengers.
+   */
+  void SeatedWagon::disembarkPassengers(int passengers) {
+    wagon.disembarkPassengers(passengers);
+    seats.releaseLastSeats(passengers);
+  }
+
+  /**
+   * @brief Disembark the passengers of particular seats.
+   *
+   * All seats are checked before any is freed.
+   *
+   * @param seatNumbers The seats to free.
+   * @throws std::out_of_range if a seat does not exist.
+   * @throws std::invalid_argument if a seat is not occupied or is listed twice.
+   */
+  void SeatedWagon::disembarkSeats(std::span<const int> seatNumbers) {
+    if (seatNumbers.empty()) {
+      return;
+    }
+    std::vector<int> sorted(seatNumbers.begin(), seatNumbers.end());
+    std::ranges::sort(sorted);
+    if (std::ranges::adjacent_find(sorted) != sorted.end()) {
+      throw std::invalid_argument("Seat is listed twice.");
+    }
+    for (int seat : sorted) {
+      if (!seats.isOccupied(seat)) {
+        throw std::invalid_argument("Seat is not occupied.");
+      }
+    }
+    wagon.disembarkPassengers(static_cast<int>(sorted.size()));
+    for (int seat : sorted) {
+      seats.release(seat);
+    }
+  }
+
+  /**
+   * @brief Set the number of occupied seats, boarding into the lowest free or freeing the highest occupied seats.
+   *
+   * @param occupiedSeats Number of occupied seats to set.
+   * @throws std::invalid_argument in the same cases as Wagon::setOccupiedSeats.
+   */
+  void SeatedWagon::setOccupiedSeats(int occupiedSeats) {
+    int previous = wagon.getOccupiedSeats();
+    wagon.setOccupiedSeats(occupiedSeats);
+    if (occupiedSeats > previous) {
+      seats.assignSeats(occupiedSeats - previous);
+    } else {
+      seats.releaseLastSeats(previous - occupiedSeats);
+    }
+  }
+
+  /**
+   * @brief Explicit conversion to a wagon, dropping the seat map.
+   *
+   * @return The wagon.
+   */
+  SeatedWagon::operator Wagon() const { return wagon; }
+
+} // namespace lab2SimpleClass
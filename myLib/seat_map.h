@@ -0,0 +1,189 @@
+#ifndef SEAT_MAP_H
+#define SEAT_MAP_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "wagon.h"
+
+namespace lab2SimpleClass {
+
+  /**
+   * @brief Occupancy of individual seats, one bit per seat.
+   *
+   * Seats are numbered from 0. Searches work on 64-seat words with countr_zero, countr_one and popcount,
+   * so finding free seats or a block of adjacent free seats costs O(seats / 64) plus the seats returned.
+   */
+  class SeatMap {
+  private:
+    static constexpr int WORD_BITS = 64; ///< Seats per word.
+
+    std::vector<uint64_t> words;  ///< Bit i of word w is set if seat 64 * w + i is occupied.
+    int numSeats;                 ///< Number of seats.
+
+    /// @brief Get the free seats of a word; seats past the end are reported as occupied.
+    /// @param word The index of the word.
+    /// @return A mask with a bit set for every free seat.
+    uint64_t freeMask(int word) const;
+
+    /// @brief Check a seat number.
+    /// @param seat The seat number.
+    /// @throws std::out_of_range if there is no such seat.
+    void checkSeat(int seat) const;
+
+  public:
+    /// @brief Constructor, creates a map with every seat free.
+    /// @param numSeats The number of seats.
+    /// @throws std::invalid_argument if the number is negative.
+    explicit SeatMap(int numSeats = 0);
+
+    /// @brief Equality operator.
+    /// @param other The other map.
+    /// @return True if both maps have the same seats occupied.
+    bool operator==(const SeatMap& other) const = default;
+
+    /// @brief Get the number of seats.
+    /// @return The number of seats.
+    int getNumSeats() const;
+
+    /// @brief Count the occupied seats with popcount.
+    /// @return The number of occupied seats.
+    int countOccupied() const;
+
+    /// @brief Check whether a seat is occupied.
+    /// @param seat The seat number.
+    /// @return True if the seat is occupied.
+    /// @throws std::out_of_range if there is no such seat.
+    bool isOccupied(int seat) const;
+
+    /// @brief Occupy a seat.
+    /// @param seat The seat number.
+    /// @throws std::out_of_range if there is no such seat.
+    /// @throws std::invalid_argument if the seat is already occupied.
+    void occupy(int seat);
+
+    /// @brief Free a seat.
+    /// @param seat The seat number.
+    /// @throws std::out_of_range if there is no such seat.
+    /// @throws std::invalid_argument if the seat is not occupied.
+    void release(int seat);
+
+    /// @brief Find the first free seat at or after a seat.
+    /// @param from The seat to start from.
+    /// @return The seat number, or -1 if there is none.
+    int findFreeSeat(int from = 0) const;
+
+    /// @brief Find the first block of adjacent free seats.
+    /// @param count The number of seats in the block.
+    /// @return The first seat of the block, or -1 if there is none.
+    /// @throws std::invalid_argument if the count is not positive.
+    int findAdjacentFreeSeats(int count) const;
+
+    /// @brief Occupy the lowest-numbered free seats.
+    /// @param count The number of seats.
+    /// @return The occupied seats in increasing order.
+    /// @throws std::invalid_argument if the count is negative or there are fewer free seats; nothing is occupied then.
+    std::vector<int> assignSeats(int count);
+
+    /// @brief Occupy the first block of adjacent free seats.
+    /// @param count The number of seats in the block.
+    /// @return The occupied seats in increasing order.
+    /// @throws std::invalid_argument if the count is not positive or there is no such block.
+    std::vector<int> assignAdjacentSeats(int count);
+
+    /// @brief Free the highest-numbered occupied seats.
+    /// @param count The number of seats.
+    /// @throws std::invalid_argument if the count is negative or fewer seats are occupied.
+    void releaseLastSeats(int count);
+  };
+
+  /**
+   * @brief A wagon that also knows which seats are taken.
+   *
+   * Wraps a Wagon and a SeatMap and keeps the occupied-seat count of the wagon equal to the number of occupied
+   * seats. It satisfies the TrainWagon concept, so BasicTrain<SeatedWagon> can hold it; plain Wagon and Train
+   * keep their count-only representation.
+   */
+  class SeatedWagon {
+  private:
+    Wagon wagon;    ///< Capacity, occupancy count and type.
+    SeatMap seats;  ///< Occupancy of each seat.
+
+  public:
+    /// @brief Default constructor, an empty restaurant wagon like Wagon().
+    SeatedWagon() = default;
+
+    /// @brief Constructor from a wagon; its passengers take the lowest-numbered seats.
+    /// @param wagon The wagon.
+    explicit SeatedWagon(const Wagon& wagon);
+
+    /// @brief Constructor with initialization of only the type.
+    /// @param type Type of the wagon.
+    explicit SeatedWagon(WagonType type);
+
+    /// @brief Equality operator, compares the wagon and every seat.
+    /// @param other The other wagon.
+    /// @return True if the wagons and seat maps are equal.
+    bool operator==(const SeatedWagon& other) const = default;
+
+    /// @brief Get the wagon without the seat map.
+    /// @return The wagon.
+    const Wagon& getWagon() const;
+
+    /// @brief Get the seat map.
+    /// @return The seat map.
+    const SeatMap& getSeatMap() const;
+
+    /// @brief Get the maximum capacity of the wagon.
+    /// @return Maximum capacity.
+    int getMaxCapacity() const;
+
+    /// @brief Get the number of currently occupied seats in the wagon.
+    /// @return Number of occupied seats.
+    int getOccupiedSeats() const;
+
+    /// @brief Get the type of the wagon.
+    /// @return Type of the wagon.
+    WagonType getType() const;
+
+    /// @brief Board passengers into the lowest-numbered free seats.
+    /// @param passengers Number of passengers to board.
+    /// @throws std::invalid_argument in the same cases as Wagon::boardPassengers.
+    void boardPassengers(int passengers);
+
+    /// @brief Board passengers into the lowest-numbered free seats.
+    /// @param passengers Number of passengers to board.
+    /// @return The assigned seats in increasing order.
+    /// @throws std::invalid_argument in the same cases as Wagon::boardPassengers.
+    std::vector<int> boardPassengersWithSeats(int passengers);
+
+    /// @brief Board a group into the first block of adjacent free seats.
+    /// @param passengers Number of passengers in the group.
+    /// @return The assigned seats in increasing order.
+    /// @throws std::invalid_argument if the wagon is a restaurant or has no such block.
+    std::vector<int> boardAdjacentPassengers(int passengers);
+
+    /// @brief Disembark passengers from the highest-numbered occupied seats.
+    /// @param passengers Number of passengers to disembark.
+    /// @throws std::invalid_argument in the same cases as Wagon::disembarkPassengers.
+    void disembarkPassengers(int passengers);
+
+    /// @brief Disembark the passengers of particular seats.
+    /// @param seatNumbers The seats to free; nothing is freed if one of them is invalid or free.
+    /// @throws std::out_of_range if a seat does not exist.
+    /// @throws std::invalid_argument if a seat is not occupied or is listed twice.
+    void disembarkSeats(std::span<const int> seatNumbers);
+
+    /// @brief Set the number of occupied seats, boarding into the lowest free or freeing the highest occupied seats.
+    /// @param occupiedSeats Number of occupied seats to set.
+    /// @throws std::invalid_argument in the same cases as Wagon::setOccupiedSeats.
+    void setOccupiedSeats(int occupiedSeats);
+
+    /// @brief Explicit conversion to a wagon, dropping the seat map.
+    /// @return The wagon.
+    explicit operator Wagon() const;
+  };
+
+} // namespace lab2SimpleClass
+
+#endif // SEAT_MAP_H
@@ -0,0 +1,324 @@
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include "random_stream.h"
+#include "simulation.h"
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief Constructor of an empty queue.
+   */
+  EventQueue::EventQueue() : buckets(MIN_BUCKETS) {}
+
+  /**
+   * @brief Make a day with the given time current.
+   *
+   * @param time The time.
+   */
+  void EventQueue::moveTo(int64_t time) {
+    current = bucketOf(time);
+    currentStart = time - time % width;
+  }
+
+  /**
+   * @brief Move to the day of the earliest event.
+   *
+   * Only events of the current year count in a day; if no day of the year has one, the earliest event
+   * is searched for among the heads of all days.
+   */
+  void EventQueue::advance() {
+    for (size_t scanned = 0; scanned < buckets.size(); scanned++) {
+      const std::vector<SimulationEvent>& bucket = buckets[current];
+      if (!bucket.empty() && bucket.back().time < currentStart + width) {
+        return;
+      }
+      current = (current + 1) & (buckets.size() - 1);
+      currentStart += width;
+    }
+    const SimulationEvent* earliest = nullptr;
+    for (const std::vector<SimulationEvent>& bucket : buckets) {
+      if (!bucket.empty() && (earliest == nullptr || bucket.back() < *earliest)) {
+        earliest = &bucket.back();
+      }
+    }
+    moveTo(earliest->time);
+  }
+
+  /**
+   * @brief Rebuild the ring with a new number of days and a day width fitted to the queued events.
+   *
+   * The width is twice the mean gap between the earliest 90% of the events, so the far tail (e.g. rare
+   * periodic events) does not stretch the days of the busy near future.
+   *
+   * @param numBuckets The number of days, a power of two.
+   */
+  void EventQueue::resize(size_t numBuckets) {
+    std::vector<SimulationEvent> events;
+    events.reserve(count);
+    for (std::vector<SimulationEvent>& bucket : buckets) {
+      events.insert(events.end(), bucket.begin(), bucket.end());
+    }
+    buckets.assign(numBuckets, {});
+    if (events.empty()) {
+      return;
+    }
+
+    std::vector<int64_t> times(events.size());
+    std::transform(events.begin(), events.end(), times.begin(), [](const SimulationEvent& event) { return event.time; });
+    auto earliest = std::min_element(times.begin(), times.end());
+    int64_t first = *earliest;
+    auto quantile = times.begin() + static_cast<ptrdiff_t>(times.size() * 9 / 10);
+    std::nth_element(times.begin(), quantile, times.end());
+    width = std::max<int64_t>(2 * (*quantile - first) / static_cast<int64_t>(times.size()), 1);
+
+    for (const SimulationEvent& event : events) {
+      buckets[bucketOf(event.time)].push_back(event);
+    }
+    for (std::vector<SimulationEvent>& bucket : buckets) {
+      std::sort(bucket.begin(), bucket.end(), std::greater<>());
+    }
+    moveTo(first);
+  }
+
+  /**
+   * @brief Add an event.
+   *
+   * @param event The event.
+   * @throws std::invalid_argument if the time of the event is negative.
+   */
+  void EventQueue::push(const SimulationEvent& event) {
+    if (event.time < 0) {
+      throw std::invalid_argument("Event time cannot be negative.");
+    }
+    if (count + 1 > 2 * buckets.size()) {
+      resize(2 * buckets.size());
+    }
+    std::vector<SimulationEvent>& bucket = buckets[bucketOf(event.time)];
+    bucket.insert(std::upper_bound(bucket.begin(), bucket.end(), event, std::greater<>()), event);
+    if (count == 0 || event.time < currentStart) {
+      moveTo(event.time);
+    }
+    count++;
+  }
+
+  /**
+   * @brief Get the earliest event.
+   *
+   * @return The event.
+   * @throws std::out_of_range if the queue is empty.
+   */
+  const SimulationEvent& EventQueue::top() {
+    if (count == 0) {
+      throw std::out_of_range("Event queue is empty.");
+    }
+    advance();
+    return buckets[current].back();
+  }
+
+  /**
+   * @brief Remove and return the earliest event.
+   *
+   * @return The event.
+   * @throws std::out_of_range if the queue is empty.
+   */
+  SimulationEvent EventQueue::pop() {
+    SimulationEvent event = top();
+    buckets[current].pop_back();
+    count--;
+    if (buckets.size() > MIN_BUCKETS && count < buckets.size() / 4) {
+      resize(buckets.size() / 2);
+    }
+    return event;
+  }
+
+  namespace {
+
+    /// @brief Simulation state of one train.
+    struct TrainState {
+      RandomStream random;                         // Случайный поток поезда
+      std::vector<WagonType> groupClasses;         // Классы вагонов, из которых выбирается класс группы
+      std::vector<std::vector<int>> waitingGroups; // Размеры групп, ожидающих поезд на каждой станции
+      int station = 0;                             // Текущая или следующая станция
+      int direction = 1;                           // Направление движения: 1 или -1
+      bool atStation = true;                       // Стоит ли поезд на станции
+    };
+
+    /// @brief Runs the trains of one shard and collects their totals.
+    class ShardSimulation {
+      private:
+        std::span<Train> trains;             // Поезда участка
+        int firstTrain;                      // Номер первого поезда участка в парке
+        const SimulationConfig& config;      // Параметры моделирования
+        std::vector<TrainState> states;      // Состояния поездов участка
+        EventQueue queue;                    // Очередь событий участка
+        SimulationReport report;             // Итоги участка
+
+        /// @brief Board one group, counting it as rejected if no wagon of its class has room.
+        void board(Train& train, int passengers, WagonType wagonType) {
+          if (!train.hasWagonWithRoom(passengers, wagonType)) {
+            report.rejectedGroups++;
+            return;
+          }
+          train.boardPassengersToMostAvailableWagon(passengers, wagonType);
+          report.boardedPassengers += passengers;
+        }
+
+        /// @brief A train stops: passengers leave, waiting groups board, departure is scheduled.
+        void arrive(const SimulationEvent& event, Train& train, TrainState& state) {
+          report.stationStops++;
+          state.atStation = true;
+          for (int i = 0; i < train.getNumWagons(); i++) {
+            const Wagon& wagon = train.view()[i];
+            if (wagon.getOccupiedSeats() == 0 || !wagonTypeTraits(wagon.getType()).canBoard) {
+              continue;
+            }
+            int leaving = static_cast<int>(wagon.getOccupiedSeats() * config.disembarkShare + state.random.uniform());
+            leaving = std::min(leaving, wagon.getOccupiedSeats());
+            if (leaving > 0) {
+              train[i].disembarkPassengers(leaving);
+              report.disembarkedPassengers += leaving;
+            }
+          }
+          std::vector<int>& waiting = state.waitingGroups[state.station];
+          for (size_t group = 0; group < waiting.size(); group++) {
+            board(train, waiting[group], state.groupClasses[state.random.below(static_cast<int>(state.groupClasses.size()))]);
+          }
+          waiting.clear();
+          queue.push({event.time + config.dwellTime, event.train, SimulationEventType::DEPARTURE, 0});
+        }
+
+        /// @brief A train leaves for the next station, turning at the ends of the line.
+        void depart(const SimulationEvent& event, TrainState& state) {
+          state.atStation = false;
+          if (config.numStations > 1) {
+            if (state.station + state.direction < 0 || state.station + state.direction >= config.numStations) {
+              state.direction = -state.direction;
+            }
+            state.station += state.direction;
+          }
+          queue.push({event.time + config.travelTime, event.train, SimulationEventType::STATION_ARRIVAL, 0});
+        }
+
+        /// @brief A group arrives for a train and boards at once if the train is there; the next group is scheduled.
+        void passengersArrive(const SimulationEvent& event, Train& train, TrainState& state) {
+          report.passengerGroups++;
+          int passengers = 1 + state.random.below(config.maxGroupSize);
+          if (state.atStation && state.station == event.station) {
+            board(train, passengers, state.groupClasses[state.random.below(static_cast<int>(state.groupClasses.size()))]);
+          } else {
+            state.waitingGroups[event.station].push_back(passengers);
+          }
+          queue.push({event.time + state.random.exponential(config.meanGroupInterval), event.train,
+                      SimulationEventType::PASSENGER_ARRIVAL, event.station});
+        }
+
+        /// @brief Apply the maintenance operations and schedule the next run.
+        void maintain(const SimulationEvent& event, Train& train) {
+          report.maintenanceRuns++;
+          for (FleetOperation operation : config.maintenance) {
+            applyFleetOperation(train, operation);
+          }
+          queue.push({event.time + config.maintenanceInterval, event.train, SimulationEventType::MAINTENANCE, 0});
+        }
+
+      public:
+        ShardSimulation(std::span<Train> trains, int firstTrain, const SimulationConfig& config)
+            : trains(trains), firstTrain(firstTrain), config(config) {}
+
+        /// @brief Schedule the first events of every train and run the events up to the end of the simulation.
+        SimulationReport run() {
+          states.reserve(trains.size());
+          for (size_t local = 0; local < trains.size(); local++) {
+            int train = firstTrain + static_cast<int>(local);
+            TrainState& state = states.emplace_back(TrainState{RandomStream(config.seed, static_cast<uint64_t>(train)), {}, {}});
+            state.waitingGroups.resize(config.numStations);
+            for (const Wagon& wagon : trains[local].view()) {
+              if (wagonTypeTraits(wagon.getType()).canBoard) {
+                state.groupClasses.push_back(wagon.getType());
+              }
+            }
+            int64_t departure = static_cast<int64_t>(train) * config.headway;
+            queue.push({departure, train, SimulationEventType::DEPARTURE, 0});
+            if (config.maintenanceInterval > 0) {
+              queue.push({departure + config.maintenanceInterval, train, SimulationEventType::MAINTENANCE, 0});
+            }
+            if (!state.groupClasses.empty()) {
+              for (int station = 0; station < config.numStations; station++) {
+                queue.push({state.random.exponential(config.meanGroupInterval), train, SimulationEventType::PASSENGER_ARRIVAL, station});
+              }
+            }
+          }
+
+          while (!queue.empty() && queue.top().time <= config.duration) {
+            SimulationEvent event = queue.pop();
+            report.events++;
+            Train& train = trains[event.train - firstTrain];
+            TrainState& state = states[event.train - firstTrain];
+            switch (event.type) {
+              case SimulationEventType::STATION_ARRIVAL:
+                arrive(event, train, state);
+                break;
+              case SimulationEventType::DEPARTURE:
+                depart(event, state);
+                break;
+              case SimulationEventType::PASSENGER_ARRIVAL:
+                passengersArrive(event, train, state);
+                break;
+              case SimulationEventType::MAINTENANCE:
+                maintain(event, train);
+                break;
+            }
+          }
+          for (const TrainState& state : states) {
+            for (const std::vector<int>& waiting : state.waitingGroups) {
+              report.waitingGroups += static_cast<int64_t>(waiting.size());
+            }
+          }
+          return report;
+        }
+    };
+
+  } // namespace
+
+  /**
+   * @brief Run a discrete-event simulation of trains shuttling along a line of stations.
+   *
+   * @param trains The trains to run; they are changed by the simulation.
+   * @param config The parameters.
+   * @param pool The pool to run the shards on.
+   * @return The totals.
+   * @throws std::invalid_argument if a parameter is out of range.
+   */
+  SimulationReport runSimulation(std::span<Train> trains, const SimulationConfig& config, ThreadPool& pool) {
+    if (config.numStations <= 0 || config.travelTime <= 0 || config.dwellTime < 0 || config.headway < 0 ||
+        config.meanGroupInterval <= 0 || config.maxGroupSize <= 0 || config.disembarkShare < 0 ||
+        config.disembarkShare > 1 || config.maintenanceInterval < 0) {
+      throw std::invalid_argument("Invalid simulation parameters.");
+    }
+
+    // Несколько участков на поток, чтобы кража задач выравнивала неравные участки
+    int numTrains = static_cast<int>(trains.size());
+    int numShards = std::min(numTrains, pool.getThreadCount() * 4);
+    std::vector<SimulationReport> reports(numShards);
+    pool.parallelFor(numShards, [&](int shard) {
+      int first = static_cast<int>(static_cast<int64_t>(numTrains) * shard / numShards);
+      int last = static_cast<int>(static_cast<int64_t>(numTrains) * (shard + 1) / numShards);
+      reports[shard] = ShardSimulation(trains.subspan(first, last - first), first, config).run();
+    });
+
+    SimulationReport total;
+    for (const SimulationReport& report : reports) {
+      total.events += report.events;
+      total.stationStops += report.stationStops;
+      total.passengerGroups += report.passengerGroups;
+      total.boardedPassengers += report.boardedPassengers;
+      total.rejectedGroups += report.rejectedGroups;
+      total.disembarkedPassengers += report.disembarkedPassengers;
+      total.maintenanceRuns += report.maintenanceRuns;
+      total.waitingGroups += report.waitingGroups;
+    }
+    return total;
+  }
+
+} // namespace lab2ComplexClass
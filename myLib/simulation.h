@@ -0,0 +1,157 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <compare>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "fleet_operations.h"
+#include "thread_pool.h"
+#include "train.h"
+
+namespace lab2ComplexClass {
+
+  /// @brief Kinds of simulation events; at equal times events run in this order.
+  enum class SimulationEventType { STATION_ARRIVAL, DEPARTURE, PASSENGER_ARRIVAL, MAINTENANCE };
+
+  /// @brief A scheduled event of one train.
+  struct SimulationEvent {
+    int64_t time = 0;                                          ///< Simulated time in milliseconds.
+    int train = 0;                                             ///< Index of the train.
+    SimulationEventType type = SimulationEventType::DEPARTURE; ///< What happens.
+    int station = 0;                                           ///< Station of a passenger arrival.
+
+    /// @brief Events are ordered by time, then by train, type and station, so the order never depends on insertion.
+    auto operator<=>(const SimulationEvent&) const = default;
+  };
+
+  /**
+   * @brief Min-priority queue of simulation events: a calendar queue.
+   *
+   * Events are hashed by time into a ring of buckets of equal width ("days" of a "year"), each kept sorted
+   * with the earliest event at the back. Pop scans forward from the current day and only falls back to a
+   * search over all buckets when a whole year is empty. The ring doubles or halves with the number of
+   * events and the day width is re-estimated from the spread of the queued times, so a day holds O(1)
+   * events and push and pop stay O(1) on average however many events a run processes.
+   */
+  class EventQueue {
+    private:
+      static constexpr size_t MIN_BUCKETS = 16; // Наименьшее число дней в году
+
+      std::vector<std::vector<SimulationEvent>> buckets; // Дни; события дня упорядочены по убыванию
+      int64_t width = 1;                                 // Длина дня
+      size_t current = 0;                                // Текущий день
+      int64_t currentStart = 0;                          // Начало текущего дня
+      size_t count = 0;                                  // Число событий в очереди
+
+      /// @brief Get the day of a time.
+      size_t bucketOf(int64_t time) const { return static_cast<size_t>(time / width) & (buckets.size() - 1); }
+
+      /// @brief Make a day with the given time current.
+      void moveTo(int64_t time);
+
+      /// @brief Move to the day of the earliest event.
+      void advance();
+
+      /**
+       * @brief Rebuild the ring with a new number of days and a day width fitted to the queued events.
+       *
+       * @param numBuckets The number of days, a power of two.
+       */
+      void resize(size_t numBuckets);
+
+    public:
+      /**
+       * @brief Constructor of an empty queue.
+       */
+      EventQueue();
+
+      /**
+       * @brief Add an event.
+       *
+       * @param event The event.
+       * @throws std::invalid_argument if the time of the event is negative.
+       */
+      void push(const SimulationEvent& event);
+
+      /**
+       * @brief Remove and return the earliest event.
+       *
+       * @return The event.
+       * @throws std::out_of_range if the queue is empty.
+       */
+      SimulationEvent pop();
+
+      /**
+       * @brief Get the earliest event.
+       *
+       * @return The event.
+       * @throws std::out_of_range if the queue is empty.
+       */
+      const SimulationEvent& top();
+
+      bool empty() const { return count == 0; } ///< Check whether the queue is empty.
+      size_t size() const { return count; }     ///< Get the number of events.
+
+      /**
+       * @brief Get the number of days in the ring.
+       *
+       * @return The number of buckets.
+       */
+      size_t getBucketCount() const { return buckets.size(); }
+  };
+
+  /// @brief Parameters of a station simulation; times are in milliseconds.
+  struct SimulationConfig {
+    int numStations = 10;                    ///< Stations on the line; trains shuttle from the first to the last and back.
+    int64_t travelTime = 600'000;            ///< Time between neighbouring stations.
+    int64_t dwellTime = 60'000;              ///< Time a train stands at a station.
+    int64_t headway = 300'000;               ///< Train i leaves the first station at i * headway.
+    int64_t meanGroupInterval = 120'000;     ///< Mean time between passenger groups waiting for one train at one station.
+    int maxGroupSize = 4;                    ///< Groups have 1 .. maxGroupSize passengers.
+    double disembarkShare = 0.3;             ///< Expected share of the passengers of a wagon leaving at every stop.
+    int64_t maintenanceInterval = 3'600'000; ///< Period of the maintenance operations; 0 disables them.
+    std::vector<FleetOperation> maintenance = {FleetOperation::REDISTRIBUTE_PASSENGERS, FleetOperation::OPTIMIZE_TRAIN}; ///< Operations of a maintenance run.
+    int64_t duration = 86'400'000;           ///< Events later than this are not run.
+    uint64_t seed = 1;                       ///< Seed of the random streams of all trains.
+  };
+
+  /// @brief Totals of a simulation run.
+  struct SimulationReport {
+    int64_t events = 0;                 ///< Events processed.
+    int64_t stationStops = 0;           ///< Arrivals of trains at stations.
+    int64_t passengerGroups = 0;        ///< Groups that arrived at stations.
+    int64_t boardedPassengers = 0;      ///< Passengers boarded by boardPassengersToMostAvailableWagon.
+    int64_t rejectedGroups = 0;         ///< Groups for which no wagon of their class had room.
+    int64_t disembarkedPassengers = 0;  ///< Passengers that left at stations.
+    int64_t maintenanceRuns = 0;        ///< Maintenance runs.
+    int64_t waitingGroups = 0;          ///< Groups still waiting when the simulation ended.
+
+    bool operator==(const SimulationReport&) const = default;
+  };
+
+  /**
+   * @brief Run a discrete-event simulation of trains shuttling along a line of stations.
+   *
+   * Every train leaves the first station at its timetable slot and stops at every station. Passengers arrive
+   * for a train at every station in groups (a Poisson process); a group boards with
+   * boardPassengersToMostAvailableWagon when the train is at the station, otherwise it waits for it. At every
+   * stop passengers leave their wagons with disembarkPassengers before the waiting groups board. The class of
+   * a group is the class of a random wagon of the train at the start, so classes are asked for in proportion
+   * to their wagons. Maintenance applies its operations to the train periodically.
+   *
+   * Trains never interact, so the fleet is split into shards of consecutive trains, each with its own event
+   * queue, run on the pool. Every train draws from its own random stream derived from the seed, and events
+   * are totally ordered, so the trains and the report are the same for any number of threads.
+   *
+   * @param trains The trains to run; they are changed by the simulation.
+   * @param config The parameters.
+   * @param pool The pool to run the shards on.
+   * @return The totals.
+   * @throws std::invalid_argument if a parameter is out of range.
+   */
+  SimulationReport runSimulation(std::span<Train> trains, const SimulationConfig& config, ThreadPool& pool);
+
+} // namespace lab2ComplexClass
+
+#endif // SIMULATION_H
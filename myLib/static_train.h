@@ -0,0 +1,398 @@
+#ifndef STATIC_TRAIN_H
+#define STATIC_TRAIN_H
+
+#include <array>
+#include <initializer_list>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include "wagon.h"
+
+using namespace lab2SimpleClass;
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief A train with at most N wagons stored inline, without heap allocation.
+   *
+   * StaticTrain offers the same operations as Train with the same results, but keeps its wagons in a
+   * std::array. Slots past the last wagon always hold default (empty restaurant) wagons, which contribute
+   * nothing to the per-class totals; the totals therefore loop over all N slots with a trip count known at
+   * compile time, which the compiler can fully unroll for small N.
+   *
+   * Every operation except stream output is constexpr, so consists can be built and balanced at compile time
+   * and stored as read-only data. A StaticTrain is a contiguous range of wagons, so Train(staticTrain) copies
+   * it into a heap train with a single allocation.
+   *
+   * StaticTrain keeps its own copies of the algorithms instead of being a BasicTrain with inline storage:
+   * BasicTrain manages its array through an allocator and placement construction, which cannot run in a
+   * constant expression, so only a separate std::array-based class can be built and balanced at compile time.
+   *
+   * @tparam N The maximum number of wagons.
+   */
+  template <int N>
+  class StaticTrain {
+    static_assert(N > 0, "StaticTrain must hold at least one wagon");
+
+    private:
+      std::array<Wagon, N> wagons{}; // Вагоны; слоты после последнего вагона пусты
+      int numWagons = 0;             // Текущее количество вагонов в поезде
+
+      /**
+       * @brief Make sure there is room for one more wagon.
+       *
+       * @throws std::length_error if the train is full.
+       */
+      constexpr void requireRoom() const {
+        if (numWagons == N) {
+          throw std::length_error("StaticTrain is full.");
+        }
+      }
+
+    public:
+      using value_type = Wagon; ///< Wagon representation, as in BasicTrain.
+
+      /**
+       * @brief Default constructor, creates an empty train.
+       */
+      constexpr StaticTrain() = default;
+
+      /**
+       * @brief Constructor that initializes the train with a list of wagons.
+       *
+       * @param list The wagons in order.
+       * @throws std::length_error if there are more than N wagons.
+       */
+      constexpr StaticTrain(std::initializer_list<Wagon> list) {
+        if (list.size() > static_cast<size_t>(N)) {
+          throw std::length_error("Too many wagons for StaticTrain.");
+        }
+        for (const Wagon& wagon : list) {
+          wagons[numWagons++] = wagon;
+        }
+      }
+
+      /**
+       * @brief Equality operator, compares the wagons pairwise.
+       *
+       * @param other The train to compare with.
+       * @return True if both trains have the same wagons in the same order.
+       */
+      constexpr bool operator==(const StaticTrain& other) const {
+        // Empty slots are identical in both trains, so the whole arrays can be compared
+        return numWagons == other.numWagons && wagons == other.wagons;
+      }
+
+      /**
+       * @brief Get the maximum number of wagons.
+       *
+       * @return N.
+       */
+      static constexpr int getCapacity() { return N; }
+
+      /**
+       * @brief Get the number of wagons in the train.
+       *
+       * @return The number of wagons.
+       */
+      constexpr int getNumWagons() const { return numWagons; }
+
+      /**
+       * @brief Get the wagons as a read-only contiguous view.
+       *
+       * @return The view over all wagons.
+       */
+      constexpr std::span<const Wagon> view() const { return {wagons.data(), static_cast<size_t>(numWagons)}; }
+
+      /// @brief Get an iterator to the first wagon.
+      /// @return A random-access iterator.
+      constexpr Wagon* begin() { return wagons.data(); }
+
+      /// @brief Get an iterator past the last wagon.
+      /// @return A random-access iterator.
+      constexpr Wagon* end() { return wagons.data() + numWagons; }
+
+      /// @brief Get an iterator to the first wagon.
+      /// @return A random-access iterator.
+      constexpr const Wagon* begin() const { return wagons.data(); }
+
+      /// @brief Get an iterator past the last wagon.
+      /// @return A random-access iterator.
+      constexpr const Wagon* end() const { return wagons.data() + numWagons; }
+
+      /**
+       * @brief Get a wagon by its index without bounds checking.
+       *
+       * @param index The index of the wagon, must be in [0, getNumWagons()).
+       * @return A const reference to the wagon.
+       */
+      constexpr const Wagon& getWagonUnchecked(int index) const noexcept { return wagons[index]; }
+
+      /**
+       * @brief Access a wagon by its index.
+       *
+       * @param index The index of the wagon.
+       * @return A reference to the wagon.
+       * @throws std::invalid_argument if the index is out of bounds.
+       */
+      constexpr Wagon& operator[](int index) {
+        if (index < 0 || index >= numWagons) {
+          throw std::invalid_argument("Invalid wagon index.");
+        }
+        return wagons[index];
+      }
+
+      /**
+       * @brief Access a wagon by its index (const version).
+       *
+       * @param index The index of the wagon.
+       * @return A const reference to the wagon.
+       * @throws std::out_of_range if the index is out of bounds.
+       */
+      constexpr const Wagon& operator[](int index) const {
+        if (index < 0 || index >= numWagons) {
+          throw std::out_of_range("Index out of range");
+        }
+        return wagons[index];
+      }
+
+      /**
+       * @brief Add a wagon to the end of the train.
+       *
+       * @param wagon The wagon to add.
+       * @throws std::length_error if the train is full.
+       */
+      constexpr void addWagon(const Wagon& wagon) {
+        requireRoom();
+        wagons[numWagons++] = wagon;
+      }
+
+      /**
+       * @brief Add a wagon to the end of the train.
+       *
+       * @param wagon The wagon to add.
+       * @return A reference to this train.
+       * @throws std::length_error if the train is full.
+       */
+      constexpr StaticTrain& operator+=(const Wagon& wagon) {
+        addWagon(wagon);
+        return *this;
+      }
+
+      /**
+       * @brief Add a wagon at the specified index, shifting the following wagons.
+       *
+       * @param newWagon The wagon to add.
+       * @param index The index at which to insert the wagon.
+       * @throws std::invalid_argument if the index is out of bounds.
+       * @throws std::length_error if the train is full.
+       */
+      constexpr void addWagonAtIndex(const Wagon& newWagon, int index) {
+        if (index < 0 || index > numWagons) {
+          throw std::invalid_argument("Invalid index for adding a wagon.");
+        }
+        requireRoom();
+        Wagon inserted = newWagon;
+        for (int i = numWagons; i > index; i--) {
+          wagons[i] = wagons[i - 1];
+        }
+        wagons[index] = inserted;
+        numWagons++;
+      }
+
+      /**
+       * @brief Remove a wagon by its index, shifting the following wagons.
+       *
+       * @param index The index of the wagon to remove.
+       * @throws std::out_of_range if the index is out of bounds.
+       */
+      constexpr void removeWagonByIndex(int index) {
+        if (index < 0 || index >= numWagons) {
+          throw std::out_of_range("Invalid wagon index.");
+        }
+        for (int i = index; i < numWagons - 1; i++) {
+          wagons[i] = wagons[i + 1];
+        }
+        wagons[--numWagons] = Wagon();
+      }
+
+      /**
+       * @brief Board passengers into the wagon of the class that Train considers the most available.
+       *
+       * The selection matches Train::boardPassengersToMostAvailableWagon exactly.
+       *
+       * @param passengers The number of passengers to board.
+       * @param wagonType The class of wagon to board passengers into.
+       * @throws std::invalid_argument if no wagon of the class can take the passengers.
+       */
+      constexpr void boardPassengersToMostAvailableWagon(int passengers, WagonType wagonType) {
+        int mostAvailableIndex = -1;
+        int mostAvailableSeats = 0;
+        for (int i = 0; i < numWagons; i++) {
+          const Wagon& wagon = wagons[i];
+          if (wagon.getType() == wagonType && wagon.getMaxCapacity() - wagon.getOccupiedSeats() >= passengers &&
+              (mostAvailableIndex < 0 || wagon.getOccupiedSeats() > mostAvailableSeats)) {
+            mostAvailableIndex = i;
+            mostAvailableSeats = wagon.getOccupiedSeats();
+          }
+        }
+        if (mostAvailableIndex < 0) {
+          throw std::invalid_argument("No available wagons of the specified type can accommodate the specified number of passengers.");
+        }
+        wagons[mostAvailableIndex].boardPassengers(passengers);
+      }
+
+      /**
+       * @brief Get the number of passengers and the total capacity of the wagons of a class.
+       *
+       * @param wagonType The class of wagons to consider.
+       * @param occupiedSeats The total number of occupied seats.
+       * @param maxCapacity The total capacity.
+       */
+      constexpr void getPassengerCountByType(WagonType wagonType, int& occupiedSeats, int& maxCapacity) const {
+        occupiedSeats = 0;
+        maxCapacity = 0;
+        for (int i = 0; i < N; i++) {
+          if (wagons[i].getType() == wagonType) {
+            occupiedSeats += wagons[i].getOccupiedSeats();
+            maxCapacity += wagons[i].getMaxCapacity();
+          }
+        }
+      }
+
+      /**
+       * @brief Redistribute passengers so that all wagons of a class have the same occupancy.
+       */
+      constexpr void redistributePassengers() {
+        int occupiedByType[WAGON_TYPE_COUNT] = {};
+        int capacityByType[WAGON_TYPE_COUNT] = {};
+        for (int i = 0; i < N; i++) {
+          int type = static_cast<int>(wagons[i].getType());
+          occupiedByType[type] += wagons[i].getOccupiedSeats();
+          capacityByType[type] += wagons[i].getMaxCapacity();
+        }
+
+        double occupancyByType[WAGON_TYPE_COUNT] = {};
+        for (int type = 0; type < WAGON_TYPE_COUNT; type++) {
+          // A class without capacity has no wagons to update; skipping 0/0 keeps the function constant-evaluable
+          if (capacityByType[type] != 0) {
+            occupancyByType[type] = static_cast<double>(occupiedByType[type]) / capacityByType[type];
+          }
+        }
+
+        for (int i = 0; i < numWagons; i++) {
+          int type = static_cast<int>(wagons[i].getType());
+          if (WAGON_TYPE_TRAITS[type].canBoard) {
+            wagons[i].setOccupiedSeats(static_cast<int>(wagons[i].getMaxCapacity() * occupancyByType[type]));
+          }
+        }
+      }
+
+      /**
+       * @brief Pack the passengers of each class into the first wagons of that class and remove empty wagons.
+       */
+      constexpr void optimizeTrain() {
+        int remainingByType[WAGON_TYPE_COUNT] = {};
+        for (int i = 0; i < N; i++) {
+          remainingByType[static_cast<int>(wagons[i].getType())] += wagons[i].getOccupiedSeats();
+        }
+        for (int i = 0; i < numWagons; i++) {
+          int type = static_cast<int>(wagons[i].getType());
+          if (WAGON_TYPE_TRAITS[type].canBoard) {
+            int seats = remainingByType[type] > wagons[i].getMaxCapacity() ? wagons[i].getMaxCapacity() : remainingByType[type];
+            wagons[i].setOccupiedSeats(seats);
+            remainingByType[type] -= seats;
+          }
+        }
+
+        int kept = 0;
+        for (int j = 0; j < numWagons; j++) {
+          if (wagons[j].getOccupiedSeats() != 0) {
+            wagons[kept++] = wagons[j];
+          }
+        }
+        for (int j = kept; j < numWagons; j++) {
+          wagons[j] = Wagon();
+        }
+        numWagons = kept;
+      }
+
+      /**
+       * @brief Insert a restaurant wagon where Train::optimizeRestaurantPlacement would insert it.
+       *
+       * @throws std::length_error if the train is full.
+       */
+      constexpr void optimizeRestaurantPlacement() {
+        int totalPassengers = 0;
+        for (int i = 0; i < N; i++) {
+          if (wagons[i].getType() != WagonType::LUXURY) {
+            totalPassengers += wagons[i].getOccupiedSeats();
+          }
+        }
+
+        int midPassengers = totalPassengers / 2;
+        int needPosition = 0;
+        for (int j = 0; j < numWagons; j++) {
+          if (wagons[j].getType() != WagonType::LUXURY) {
+            totalPassengers -= wagons[j].getOccupiedSeats();
+            needPosition = totalPassengers != midPassengers ? j + 1 : j;
+            break;
+          }
+        }
+
+        addWagonAtIndex(Wagon(), needPosition);
+      }
+
+      /**
+       * @brief Output operator, writes the train in the same format as Train.
+       *
+       * @param os The output stream.
+       * @param train The train to write.
+       * @return The output stream.
+       */
+      friend std::ostream& operator<<(std::ostream& os, const StaticTrain& train) {
+        os << train.numWagons << std::endl;
+        for (int i = 0; i < train.numWagons; i++) {
+          os << train.wagons[i];
+        }
+        return os;
+      }
+  };
+
+  /// @brief A run of identical default wagons in a consist template, e.g. "6 ECONOMY".
+  struct ConsistSection {
+    WagonType type;  ///< Class of the wagons.
+    int count;       ///< Number of wagons.
+  };
+
+  /**
+   * @brief Build a consist from sections of default wagons of each class.
+   *
+   * Intended for constexpr variables, so that standard consists are computed by the compiler.
+   *
+   * @tparam N The maximum number of wagons.
+   * @param sections The sections in order.
+   * @return The consist.
+   * @throws std::length_error if the sections hold more than N wagons.
+   */
+  template <int N>
+  constexpr StaticTrain<N> makeConsist(std::initializer_list<ConsistSection> sections) {
+    StaticTrain<N> consist;
+    for (const ConsistSection& section : sections) {
+      for (int i = 0; i < section.count; i++) {
+        consist.addWagon(Wagon(section.type));
+      }
+    }
+    return consist;
+  }
+
+  /// @brief Standard intercity consist: 2 LUXURY + RESTAURANT + 6 ECONOMY.
+  inline constexpr StaticTrain<9> INTERCITY_CONSIST = makeConsist<9>({
+    {WagonType::LUXURY, 2}, {WagonType::RESTAURANT, 1}, {WagonType::ECONOMY, 6}});
+
+  /// @brief Standard regional unit: 8 SITTING wagons.
+  inline constexpr StaticTrain<8> REGIONAL_CONSIST = makeConsist<8>({{WagonType::SITTING, 8}});
+
+} // namespace lab2ComplexClass
+
+#endif // STATIC_TRAIN_H
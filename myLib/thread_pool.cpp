@@ -0,0 +1,205 @@
+#include <exception>
+#include "thread_pool.h"
+
+namespace lab2ComplexClass {
+
+  namespace {
+
+    thread_local const ThreadPool* currentPool = nullptr; // Пул, которому принадлежит текущий поток
+    thread_local int currentWorker = -1;                  // Номер текущего рабочего потока в пуле
+
+  } // namespace
+
+  /**
+   * @brief Constructor, starts the workers.
+   *
+   * @param numThreads The number of workers; defaultThreadCount() if not positive.
+   */
+  ThreadPool::ThreadPool(int numThreads) {
+    if (numThreads <= 0) {
+      numThreads = defaultThreadCount();
+    }
+    for (int i = 0; i < numThreads; i++) {
+      queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    threads.reserve(numThreads);
+    for (int i = 0; i < numThreads; i++) {
+      threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+  }
+
+  /**
+   * @brief Destructor, runs the remaining tasks and joins the workers.
+   */
+  ThreadPool::~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      stopping = true;
+    }
+    wakeUp.notify_all();
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+
+  /**
+   * @brief Get the number of hardware threads, at least 1.
+   *
+   * @return The default number of workers.
+   */
+  int ThreadPool::defaultThreadCount() {
+    unsigned hardware = std::thread::hardware_concurrency();
+    return hardware == 0 ? 1 : static_cast<int>(hardware);
+  }
+
+  /**
+   * @brief Get the number of workers.
+   *
+   * @return The number of workers.
+   */
+  int ThreadPool::getThreadCount() const { return static_cast<int>(threads.size()); }
+
+  /**
+   * @brief Get the number of tasks taken from another worker's queue so far.
+   *
+   * @return The number of steals.
+   */
+  uint64_t ThreadPool::getStealCount() const { return steals.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Check whether the calling thread is a worker of this pool.
+   *
+   * @return True inside a task of this pool.
+   */
+  bool ThreadPool::isWorkerThread() const { return currentPool == this; }
+
+  /**
+   * @brief Take a task from the own queue or steal one.
+   *
+   * The own queue is read from the front, other queues from the back, so the owner and a thief meet only
+   * when one task is left.
+   *
+   * @param self The index of the worker.
+   * @param task The task taken.
+   * @return True if a task was taken.
+   */
+  bool ThreadPool::takeTask(int self, std::function<void()>& task) {
+    {
+      WorkerQueue& own = *queues[self];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.tasks.empty()) {
+        task = std::move(own.tasks.front());
+        own.tasks.pop_front();
+        return true;
+      }
+    }
+    int numQueues = static_cast<int>(queues.size());
+    for (int offset = 1; offset < numQueues; offset++) {
+      WorkerQueue& victim = *queues[(self + offset) % numQueues];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = std::move(victim.tasks.back());
+        victim.tasks.pop_back();
+        steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief The loop run by every worker until the pool is destroyed and all tasks are done.
+   *
+   * @param self The index of the worker.
+   */
+  void ThreadPool::workerLoop(int self) {
+    currentPool = this;
+    currentWorker = self;
+    while (true) {
+      std::function<void()> task;
+      if (takeTask(self, task)) {
+        queuedTasks.fetch_sub(1);
+        task();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleepMutex);
+      wakeUp.wait(lock, [this] { return stopping || queuedTasks.load() > 0; });
+      if (stopping && queuedTasks.load() <= 0) {
+        return;
+      }
+    }
+  }
+
+  /**
+   * @brief Queue a task; exceptions thrown by it terminate the program.
+   *
+   * @param task The task.
+   */
+  void ThreadPool::submit(std::function<void()> task) {
+    int target = isWorkerThread() ? currentWorker
+                                  : static_cast<int>(nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size());
+    {
+      WorkerQueue& queue = *queues[target];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      queue.tasks.push_back(std::move(task));
+    }
+    {
+      // Счетчик меняется под мьютексом ожидания, чтобы рабочий не уснул, пропустив задачу
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      queuedTasks.fetch_add(1);
+    }
+    wakeUp.notify_one();
+  }
+
+  /**
+   * @brief Run body(0) .. body(count - 1) on the workers and wait for all of them.
+   *
+   * @param count The number of indices.
+   * @param body The function to run for each index.
+   */
+  void ThreadPool::parallelFor(int count, const std::function<void(int)>& body) {
+    std::exception_ptr firstError;
+    int firstErrorIndex = count;
+
+    if (isWorkerThread()) {
+      for (int i = 0; i < count; i++) {
+        try {
+          body(i);
+        } catch (...) {
+          if (!firstError) {
+            firstError = std::current_exception();
+          }
+        }
+      }
+    } else if (count > 0) {
+      std::mutex doneMutex;
+      std::condition_variable done;
+      int remaining = count;
+      for (int i = 0; i < count; i++) {
+        submit([&, i] {
+          std::exception_ptr error;
+          try {
+            body(i);
+          } catch (...) {
+            error = std::current_exception();
+          }
+          std::lock_guard<std::mutex> lock(doneMutex);
+          if (error && i < firstErrorIndex) {
+            firstError = error;
+            firstErrorIndex = i;
+          }
+          if (--remaining == 0) {
+            done.notify_one();
+          }
+        });
+      }
+      std::unique_lock<std::mutex> lock(doneMutex);
+      done.wait(lock, [&] { return remaining == 0; });
+    }
+
+    if (firstError) {
+      std::rethrow_exception(firstError);
+    }
+  }
+
+} // namespace lab2ComplexClass
@@ -0,0 +1,122 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief A fixed-size thread pool with one task queue per worker and work stealing.
+   *
+   * Tasks submitted from outside are dealt to the queues round-robin; a task submitted by a worker goes to
+   * its own queue. A worker takes tasks from the front of its own queue, in submission order, and when that
+   * is empty steals from the back of another worker's queue, so uneven tasks even out without a central queue.
+   */
+  class ThreadPool {
+    private:
+      /// @brief The task queue of one worker.
+      struct WorkerQueue {
+        std::mutex mutex;                         // Защищает очередь
+        std::deque<std::function<void()>> tasks;  // Задачи в порядке поступления
+      };
+
+      std::vector<std::unique_ptr<WorkerQueue>> queues;  // Очереди рабочих потоков
+      std::vector<std::thread> threads;                  // Рабочие потоки
+      std::mutex sleepMutex;                             // Защищает ожидание задач и остановку
+      std::condition_variable wakeUp;                    // Будит спящих рабочих
+      std::atomic<int> queuedTasks{0};                   // Задачи, ещё не взятые на выполнение
+      std::atomic<unsigned> nextQueue{0};                // Очередь для следующей внешней задачи
+      std::atomic<uint64_t> steals{0};                   // Количество украденных задач
+      bool stopping = false;                             // Пул уничтожается
+
+      /**
+       * @brief Take a task from the own queue or steal one.
+       *
+       * @param self The index of the worker.
+       * @param task The task taken.
+       * @return True if a task was taken.
+       */
+      bool takeTask(int self, std::function<void()>& task);
+
+      /**
+       * @brief The loop run by every worker until the pool is destroyed and all tasks are done.
+       *
+       * @param self The index of the worker.
+       */
+      void workerLoop(int self);
+
+    public:
+      /**
+       * @brief Constructor, starts the workers.
+       *
+       * @param numThreads The number of workers; defaultThreadCount() if not positive.
+       */
+      explicit ThreadPool(int numThreads = 0);
+
+      /**
+       * @brief Destructor, runs the remaining tasks and joins the workers.
+       */
+      ~ThreadPool();
+
+      ThreadPool(const ThreadPool&) = delete;
+      ThreadPool& operator=(const ThreadPool&) = delete;
+
+      /**
+       * @brief Get the number of hardware threads, at least 1.
+       *
+       * @return The default number of workers.
+       */
+      static int defaultThreadCount();
+
+      /**
+       * @brief Get the number of workers.
+       *
+       * @return The number of workers.
+       */
+      int getThreadCount() const;
+
+      /**
+       * @brief Get the number of tasks taken from another worker's queue so far.
+       *
+       * @return The number of steals.
+       */
+      uint64_t getStealCount() const;
+
+      /**
+       * @brief Check whether the calling thread is a worker of this pool.
+       *
+       * @return True inside a task of this pool.
+       */
+      bool isWorkerThread() const;
+
+      /**
+       * @brief Queue a task; exceptions thrown by it terminate the program.
+       *
+       * @param task The task.
+       */
+      void submit(std::function<void()> task);
+
+      /**
+       * @brief Run body(0) .. body(count - 1) on the workers and wait for all of them.
+       *
+       * Every index runs exactly once, in any order and on any worker. If bodies throw, all indices still
+       * run and the exception of the lowest failing index is rethrown, so the outcome does not depend on the
+       * number of threads. Called from a worker of this pool, the loop runs inline on that worker.
+       *
+       * @param count The number of indices.
+       * @param body The function to run for each index.
+       */
+      void parallelFor(int count, const std::function<void(int)>& body);
+  };
+
+} // namespace lab2ComplexClass
+
+#endif // THREAD_POOL_H
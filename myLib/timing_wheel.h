@@ -0,0 +1,253 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace lab2ComplexClass {
+
+  /// @brief Handle of a scheduled timer; stays unique after the timer fires or is cancelled.
+  using TimerId = uint64_t;
+
+  /**
+   * @brief Hierarchical timing wheel: timers with an integer expiry time, O(1) schedule and cancel.
+   *
+   * There are LEVELS wheels of 64 slots; a slot of level L spans 64^L time units. A timer goes to the level of
+   * the highest base-64 digit where its expiry differs from the current time, and to the slot of that digit of
+   * the expiry, so finding its place is a few bit operations. Timers of a slot form an intrusive doubly linked
+   * list over a node pool, so cancelling unlinks in O(1) and nodes are reused without allocating. Advancing the
+   * time jumps straight to the next occupied slot through a bitmap per level: a slot of a higher level is
+   * redistributed to the lower levels when the time reaches it, and a level-0 slot expires all its timers at
+   * once. Each timer is moved at most LEVELS times, so advancing is O(1) per timer however far the time jumps.
+   *
+   * @tparam T The payload returned when a timer expires.
+   */
+  template <typename T>
+  class TimingWheel {
+    public:
+      static constexpr int LEVELS = 6;                  ///< Number of levels; expiries at least 63 * 2^30 units ahead fit.
+      static constexpr int SLOT_BITS = 6;               ///< Bits of time per level.
+      static constexpr int SLOTS = 1 << SLOT_BITS;      ///< Slots per level.
+
+    private:
+      static constexpr int32_t NONE = -1;                          // Отсутствие узла
+      static constexpr int TOP_SHIFT = SLOT_BITS * (LEVELS - 1);   // Сдвиг разряда верхнего уровня
+
+      /// @brief A timer in the node pool.
+      struct Node {
+        int64_t expiry = 0;        // Время срабатывания
+        int32_t prev = NONE;       // Предыдущий узел ячейки
+        int32_t next = NONE;       // Следующий узел ячейки или свободного списка
+        int level = -1;            // Уровень, -1 у свободного узла
+        int slot = 0;              // Ячейка уровня
+        uint32_t generation = 0;   // Поколение узла; меняется при каждом освобождении
+        T payload{};               // Данные таймера
+      };
+
+      std::vector<Node> nodes;                                 // Пул узлов
+      int32_t freeList = NONE;                                 // Первый свободный узел
+      std::array<std::array<int32_t, SLOTS>, LEVELS> heads;    // Первый узел каждой ячейки
+      std::array<uint64_t, LEVELS> occupied{};                 // Непустые ячейки каждого уровня
+      int64_t current = 0;                                     // Текущее время
+      size_t count = 0;                                        // Число запланированных таймеров
+
+      /// @brief Link a node into the slot its expiry falls into relative to the current time.
+      void link(int32_t index) {
+        Node& node = nodes[index];
+        // Старшие разряды за пределами верхнего уровня тоже попадают на него: его ячейки идут по кругу
+        int level = std::min((static_cast<int>(std::bit_width(static_cast<uint64_t>(node.expiry ^ current))) - 1) / SLOT_BITS, LEVELS - 1);
+        int slot = static_cast<int>(node.expiry >> (level * SLOT_BITS)) & (SLOTS - 1);
+        node.level = level;
+        node.slot = slot;
+        node.prev = NONE;
+        node.next = heads[level][slot];
+        if (node.next != NONE) {
+          nodes[node.next].prev = index;
+        }
+        heads[level][slot] = index;
+        occupied[level] |= uint64_t{1} << slot;
+      }
+
+      /// @brief Unlink a node from its slot.
+      void unlink(int32_t index) {
+        Node& node = nodes[index];
+        if (node.prev != NONE) {
+          nodes[node.prev].next = node.next;
+        } else {
+          heads[node.level][node.slot] = node.next;
+          if (node.next == NONE) {
+            occupied[node.level] &= ~(uint64_t{1} << node.slot);
+          }
+        }
+        if (node.next != NONE) {
+          nodes[node.next].prev = node.prev;
+        }
+      }
+
+      /// @brief Return a node to the pool; ids of the old timer stop matching it.
+      void release(int32_t index) {
+        Node& node = nodes[index];
+        node.level = -1;
+        node.generation++;
+        node.next = freeList;
+        freeList = index;
+        count--;
+      }
+
+    public:
+      /**
+       * @brief Constructor of an empty wheel.
+       *
+       * @param start The current time.
+       * @throws std::invalid_argument if the time is negative.
+       */
+      explicit TimingWheel(int64_t start = 0) : current(start) {
+        if (start < 0) {
+          throw std::invalid_argument("Time cannot be negative.");
+        }
+        for (std::array<int32_t, SLOTS>& level : heads) {
+          level.fill(NONE);
+        }
+      }
+
+      /**
+       * @brief Schedule a timer.
+       *
+       * @param expiry The time the timer fires, after the current time.
+       * @param payload The data returned when it fires.
+       * @return The id of the timer.
+       * @throws std::invalid_argument if the expiry is not after the current time or is more than 63 slots of the top
+       *         level ahead.
+       */
+      TimerId schedule(int64_t expiry, T payload) {
+        if (expiry <= current) {
+          throw std::invalid_argument("Expiry must be after the current time.");
+        }
+        if ((expiry >> TOP_SHIFT) - (current >> TOP_SHIFT) >= SLOTS) {
+          throw std::invalid_argument("Expiry is too far ahead.");
+        }
+        int32_t index = freeList;
+        if (index != NONE) {
+          freeList = nodes[index].next;
+        } else {
+          index = static_cast<int32_t>(nodes.size());
+          nodes.emplace_back();
+        }
+        nodes[index].expiry = expiry;
+        nodes[index].payload = std::move(payload);
+        link(index);
+        count++;
+        return (static_cast<TimerId>(nodes[index].generation) << 32) | static_cast<uint32_t>(index);
+      }
+
+      /**
+       * @brief Cancel a timer.
+       *
+       * @param id The id of the timer.
+       * @return False if the timer has already fired or been cancelled.
+       */
+      bool cancel(TimerId id) {
+        if (find(id) == nullptr) {
+          return false;
+        }
+        int32_t index = static_cast<int32_t>(static_cast<uint32_t>(id));
+        unlink(index);
+        release(index);
+        return true;
+      }
+
+      /**
+       * @brief Find the payload of a scheduled timer.
+       *
+       * @param id The id of the timer.
+       * @return The payload, or nullptr if the timer has already fired or been cancelled.
+       */
+      T* find(TimerId id) {
+        uint32_t index = static_cast<uint32_t>(id);
+        if (index >= nodes.size() || nodes[index].level < 0 || nodes[index].generation != static_cast<uint32_t>(id >> 32)) {
+          return nullptr;
+        }
+        return &nodes[index].payload;
+      }
+
+      /**
+       * @brief Find the payload of a scheduled timer.
+       *
+       * @param id The id of the timer.
+       * @return The payload, or nullptr if the timer has already fired or been cancelled.
+       */
+      const T* find(TimerId id) const { return const_cast<TimingWheel*>(this)->find(id); }
+
+      /**
+       * @brief Move the time forward and collect the timers that fire, earliest first.
+       *
+       * @param now The new time.
+       * @param expired Receives the payloads of the timers with expiry <= now.
+       * @return The number of timers that fired.
+       * @throws std::invalid_argument if the time goes backwards.
+       */
+      size_t advance(int64_t now, std::vector<T>& expired) {
+        if (now < current) {
+          throw std::invalid_argument("Time cannot go backwards.");
+        }
+        size_t fired = 0;
+        while (count > 0) {
+          // Все ячейки нижних уровней раньше любой ячейки верхних, а на уровне заняты только ячейки после текущей
+          int level = 0;
+          while (occupied[level] == 0) {
+            level++;
+          }
+          // Ищем первую занятую ячейку после текущей; на нижних уровнях круг не замыкается
+          int shift = level * SLOT_BITS;
+          int64_t base = current >> shift;
+          int digit = static_cast<int>(base) & (SLOTS - 1);
+          int distance = std::countr_zero(std::rotr(occupied[level], (digit + 1) & (SLOTS - 1))) + 1;
+          int slot = (digit + distance) & (SLOTS - 1);
+          int64_t slotStart = (base + distance) << shift;
+          if (slotStart > now) {
+            break;
+          }
+          current = slotStart;
+          int32_t index = heads[level][slot];
+          heads[level][slot] = NONE;
+          occupied[level] &= ~(uint64_t{1} << slot);
+          while (index != NONE) {
+            int32_t next = nodes[index].next;
+            // Таймеры, которые наступают позже начала ячейки, уходят на нижние уровни, так что порядок сохраняется
+            if (nodes[index].expiry == current) {
+              expired.push_back(std::move(nodes[index].payload));
+              release(index);
+              fired++;
+            } else {
+              link(index);
+            }
+            index = next;
+          }
+        }
+        current = now;
+        return fired;
+      }
+
+      /**
+       * @brief Get the current time.
+       *
+       * @return The time of the last advance.
+       */
+      int64_t getTime() const { return current; }
+
+      /**
+       * @brief Get the number of scheduled timers.
+       *
+       * @return The number of timers.
+       */
+      size_t size() const { return count; }
+  };
+
+} // namespace lab2ComplexClass
+
+#endif // TIMING_WHEEL_H
@@ -1,6 +1,17 @@
 #ifndef TRAIN_H
 #define TRAIN_H
 
+#include <algorithm>
+#include <concepts>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "instrumentation.h"
+#include "train_storage.h"
 #include "wagon.h"
 
 using namespace lab2SimpleClass;
@@ -8,17 +19,217 @@ using namespace lab2SimpleClass;
 namespace lab2ComplexClass {
 
   /**
-   * @brief The Train class represents a train with multiple wagons.
+   * @brief Policy that decides how the wagon array of a train grows and shrinks.
+   *
+   * The same policy is applied on every growth path (addWagon, addWagonAtIndex, setNumWagons, setWagons)
+   * and, when shrinkThreshold is set, after removals (removeWagonByIndex, optimizeTrain).
+   */
+  struct GrowthPolicy {
+    /// @brief Enumeration for the growth strategies.
+    enum class Kind { GEOMETRIC, FIXED_STEP, EXACT };
+
+    Kind kind = Kind::GEOMETRIC;  ///< Growth strategy.
+    double factor = 2.0;          ///< Capacity multiplier for GEOMETRIC.
+    int step = 8;                 ///< Capacity increment for FIXED_STEP.
+    double shrinkThreshold = 0.0; ///< Shrink when size <= shrinkThreshold * capacity; 0 disables shrinking.
+
+    /**
+     * @brief Create a policy that multiplies the capacity by a factor.
+     *
+     * @param factor The growth factor, must be greater than 1.
+     * @param shrinkThreshold The load below which the array shrinks (0 to never shrink).
+     * @return The policy.
+     * @throws std::invalid_argument if the parameters are out of range.
+     */
+    static GrowthPolicy geometric(double factor = 2.0, double shrinkThreshold = 0.0);
+
+    /**
+     * @brief Create a policy that grows the capacity by a fixed number of wagons.
+     *
+     * @param step The growth step, must be positive.
+     * @param shrinkThreshold The load below which the array shrinks (0 to never shrink).
+     * @return The policy.
+     * @throws std::invalid_argument if the parameters are out of range.
+     */
+    static GrowthPolicy fixedStep(int step, double shrinkThreshold = 0.0);
+
+    /**
+     * @brief Create a policy that always allocates exactly the required number of wagons.
+     *
+     * @param shrinkThreshold The load below which the array shrinks (0 to never shrink).
+     * @return The policy.
+     * @throws std::invalid_argument if the parameters are out of range.
+     */
+    static GrowthPolicy exact(double shrinkThreshold = 0.0);
+
+    /**
+     * @brief Compute the capacity to grow to.
+     *
+     * @param current The current capacity.
+     * @param required The minimum capacity needed.
+     * @return The new capacity (at least required).
+     */
+    int grow(int current, int required) const;
+
+    /**
+     * @brief Check whether an array should shrink after removals.
+     *
+     * @param size The number of wagons.
+     * @param capacity The current capacity.
+     * @return True if the array should shrink.
+     */
+    bool shouldShrink(int size, int capacity) const;
+
+    /**
+     * @brief Compute the capacity to shrink to, leaving the usual growth headroom.
+     *
+     * @param size The number of wagons.
+     * @return The new capacity (at least size).
+     */
+    int shrinkTarget(int size) const;
+  };
+
+  /**
+   * @brief Requirements on the wagon representation stored in a BasicTrain.
+   *
+   * Besides these operations the algorithms rely on the seat rules of Wagon (boarding and setting the
+   * occupancy of a restaurant wagon throws), which PackedWagon follows as well.
+   */
+  template <typename W>
+  concept TrainWagon = std::default_initializable<W> && std::copyable<W> && std::equality_comparable<W> &&
+    requires(W wagon, const W& constWagon, int seats) {
+      { constWagon.getType() } -> std::same_as<WagonType>;
+      { constWagon.getMaxCapacity() } -> std::convertible_to<int>;
+      { constWagon.getOccupiedSeats() } -> std::convertible_to<int>;
+      wagon.boardPassengers(seats);
+      wagon.setOccupiedSeats(seats);
+    };
+
+  /**
+   * @brief The BasicTrain class represents a train with multiple wagons.
    *
    * This class manages a train with a variable number of wagons and provides various operations
    * for manipulating the train, including adding and removing wagons, redistributing passengers,
    * and optimizing the train's configuration.
+   *
+   * The algorithms are generic over the wagon representation (Wagon, or PackedWagon for planning over
+   * many wagons) and over the storage policy of the wagon array (see train_storage.h). Train is the
+   * instantiation with Wagon and heap storage, compiled once in train.cpp.
+   *
+   * @tparam WagonT The wagon representation.
+   * @tparam Storage The storage policy of the wagon array.
    */
-  class Train {
+  template <TrainWagon WagonT = Wagon, typename Storage = HeapStorage>
+  class BasicTrain {
+    public:
+      using value_type = WagonT;                                     ///< Wagon representation.
+      using StorageType = typename Storage::template For<WagonT>;    ///< Storage of the wagon array.
+
     private:
+      StorageType storage; // Источник памяти для массива вагонов
       int numWagons; // Текущее количество вагонов в поезде
-      Wagon* wagons; // Массив вагонов
+      WagonT* wagons; // Массив вагонов
       int capacity;  // Емкость массива (количество доступных мест)
+      std::vector<bool> dirtyWagons; // Вагоны, измененные с последней контрольной точки
+      GrowthPolicy growthPolicy;     // Политика роста и сжатия массива вагонов
+
+      /**
+       * @brief Move the wagons into a newly allocated array of the given capacity.
+       *
+       * @param newCapacity The new capacity, not less than the number of wagons.
+       */
+      void reallocate(int newCapacity);
+
+      /**
+       * @brief Allocate uninitialized storage for wagons.
+       *
+       * @param capacity The number of wagons the storage must hold; updated to the number it can hold.
+       * @return The storage, or nullptr if capacity is 0.
+       */
+      WagonT* allocateWagons(int& capacity);
+
+      /**
+       * @brief Destroy the live wagons of an array and release its storage.
+       *
+       * @param wagons The storage returned by allocateWagons.
+       * @param numWagons The number of live wagons at the beginning of the storage.
+       * @param capacity The capacity of the storage.
+       */
+      void deallocateWagons(WagonT* wagons, int numWagons, int capacity);
+
+      /**
+       * @brief Move wagons into uninitialized storage and end their lifetime in the source.
+       *
+       * The source and destination may overlap.
+       *
+       * @param from The source wagons.
+       * @param numWagons The number of wagons to relocate.
+       * @param to The uninitialized destination storage.
+       */
+      static void relocateWagons(WagonT* from, int numWagons, WagonT* to);
+
+      /**
+       * @brief Grow the array according to the growth policy if it cannot hold the required number of wagons.
+       *
+       * @param required The required capacity.
+       */
+      void ensureCapacity(int required);
+
+      /**
+       * @brief Shift the wagons from the index to the right, leaving a gap of uninitialized slots.
+       *
+       * The array grows at most once, according to the growth policy. The gap counts as part of the train.
+       *
+       * @param index The position of the gap.
+       * @param count The number of slots in the gap.
+       * @return The first slot of the gap.
+       */
+      WagonT* openGap(int index, int count);
+
+      /**
+       * @brief Remove a gap of uninitialized slots left by openGap, shifting the wagons after it back.
+       *
+       * @param index The position of the gap.
+       * @param count The number of slots in the gap.
+       */
+      void closeGap(int index, int count);
+
+      /**
+       * @brief Shrink the array if the growth policy considers it too sparse.
+       */
+      void shrinkIfSparse();
+
+      /**
+       * @brief Mark a single wagon as changed since the last checkpoint.
+       *
+       * @param index The index of the changed wagon.
+       */
+      void markDirty(int index);
+
+      /**
+       * @brief Mark every wagon starting from the given index as changed since the last checkpoint.
+       *
+       * Used by structural operations that shift the tail of the wagon array.
+       *
+       * @param index The first changed index.
+       */
+      void markDirtyFrom(int index);
+
+      /**
+       * @brief Read the train in the format of operator>>.
+       *
+       * @param is The input stream.
+       * @return The input stream.
+       */
+      std::istream& read(std::istream& is);
+
+      /**
+       * @brief Write the train in the format of operator<<.
+       *
+       * @param os The output stream.
+       * @return The output stream.
+       */
+      std::ostream& write(std::ostream& os) const;
 
     public:
 
@@ -35,12 +246,19 @@ namespace lab2ComplexClass {
        * @note Two trains are considered equal if they have the same number of wagons and each pair
        * of corresponding wagons in the trains is equal.
        */
-      bool operator==(const Train& other) const;
+      bool operator==(const BasicTrain& other) const;
 
       /**
        * @brief Default constructor for the Train class.
        */
-      Train(); // Конструктор по умолчанию
+      BasicTrain(); // Конструктор по умолчанию
+
+      /**
+       * @brief Constructor of an empty train that takes its wagon arrays from the given storage.
+       *
+       * @param storage The storage, e.g. an ArenaStorage over a memory resource.
+       */
+      explicit BasicTrain(const StorageType& storage); // Конструктор пустого поезда с заданным хранилищем
 
       /**
        * @brief Constructor that initializes the train with an array of wagons.
@@ -48,28 +266,43 @@ namespace lab2ComplexClass {
        * @param wagons An array of wagons.
        * @param numWagons The number of wagons in the array.
        */
-      explicit Train(const Wagon wagons[], int numWagons); // Конструктор с инициализацией вагонов из массива
+      explicit BasicTrain(const WagonT wagons[], int numWagons); // Конструктор с инициализацией вагонов из массива
 
       /**
        * @brief Constructor that initializes the train with a single wagon.
        *
        * @param wagon The wagon to be added to the train.
        */
-      explicit Train(const Wagon &wagon); // Конструктор с инициализацией одним вагоном
+      explicit BasicTrain(const WagonT &wagon); // Конструктор с инициализацией одним вагоном
+
+      /**
+       * @brief Constructor that initializes the train from any input range of wagons.
+       *
+       * Forward ranges are copied with a single allocation. The elements may be of another wagon representation,
+       * e.g. train.view() of a Train builds a train of packed wagons.
+       *
+       * @param range The wagons in order.
+       * @param storage The storage of the new train.
+       */
+      template <std::ranges::input_range R>
+        requires std::constructible_from<WagonT, std::ranges::range_reference_t<R>> && (!std::same_as<std::remove_cvref_t<R>, BasicTrain>)
+      explicit BasicTrain(R&& range, const StorageType& storage = StorageType()) : BasicTrain(storage) { // Конструктор из произвольного диапазона вагонов
+        insert(0, std::ranges::begin(range), std::ranges::end(range));
+      }
 
       /**
        * @brief Copy constructor for the Train class.
        *
        * @param other Another Train object to be copied.
        */
-      Train(const Train& other); // Копирующий конструктор
+      BasicTrain(const BasicTrain& other); // Копирующий конструктор
 
       /**
        * @brief Move constructor for the Train class.
        *
        * @param other Another Train object to be moved.
        */
-      Train(Train&& other); // Перемещающий конструктор
+      BasicTrain(BasicTrain&& other) noexcept; // Перемещающий конструктор
 
       // Геттеры
       /**
@@ -84,7 +317,7 @@ namespace lab2ComplexClass {
        *
        * @return A pointer to the array of wagons.
        */
-      const Wagon* getWagons() const; // Геттер для вагонов
+      const WagonT* getWagons() const; // Геттер для вагонов
   
       /**
        * @brief Get the capacity of the wagon array (number of available seats).
@@ -107,7 +340,7 @@ namespace lab2ComplexClass {
        * @param wagons An array of wagons.
        * @param numWagons The number of wagons in the array.
        */
-      void setWagons(const Wagon* wagons, int numWagons); // Сеттер для вагонов
+      void setWagons(const WagonT* wagons, int numWagons); // Сеттер для вагонов
   
       /**
        * @brief Set the capacity of the wagon array (number of available seats).
@@ -116,17 +349,140 @@ namespace lab2ComplexClass {
        */
       void setCapacity(int capacity); // Сеттер для capacity 
 
+      // Учет памяти
+      /**
+       * @brief Make sure the wagon array can hold at least the given number of wagons without reallocation.
+       *
+       * @param minCapacity The minimum capacity.
+       * @throws std::invalid_argument if minCapacity is negative.
+       */
+      void reserve(int minCapacity);
+
+      /**
+       * @brief Release the unused capacity of the wagon array.
+       */
+      void shrinkToFit();
+
+      /**
+       * @brief Get the heap memory owned by the train.
+       *
+       * @return The number of bytes used by the wagon array and the dirty-wagon bitset.
+       */
+      size_t bytesUsed() const;
+
+      /**
+       * @brief Get the memory reserved for wagons that are not in the train.
+       *
+       * @return The number of unused bytes in the wagon array.
+       */
+      size_t slack() const;
+
+      /**
+       * @brief Get the growth policy of the train.
+       *
+       * @return The growth policy.
+       */
+      const GrowthPolicy& getGrowthPolicy() const;
+
+      /**
+       * @brief Set the growth policy used by all growth paths of the train.
+       *
+       * @param policy The new growth policy.
+       */
+      void setGrowthPolicy(const GrowthPolicy& policy);
+
+      /**
+       * @brief Get the storage the wagon arrays of the train come from.
+       *
+       * @return The storage.
+       */
+      const StorageType& getStorage() const { return storage; }
+
       /**
        * @brief Destructor for the Train class.
        */
-      ~Train(); // Деструктор
+      ~BasicTrain(); // Деструктор
 
       /**
        * @brief Add a wagon to the train.
        *
        * @param wagon The wagon to be added to the train.
        */
-      void addWagon(const Wagon &wagon); // Метод добавления вагона в поезд
+      void addWagon(const WagonT &wagon); // Метод добавления вагона в поезд
+
+      /**
+       * @brief Construct a wagon at the end of the train from constructor arguments.
+       *
+       * When there is spare capacity the wagon is constructed directly in the array without a temporary.
+       *
+       * @param args The arguments of a Wagon constructor.
+       * @return A reference to the new wagon.
+       * @throws std::invalid_argument if the Wagon constructor rejects the arguments.
+       */
+      template <typename... Args>
+      WagonT& emplaceWagon(Args&&... args) { // Создание вагона на месте в конце поезда
+        if (numWagons < capacity) {
+          std::construct_at(wagons + numWagons, std::forward<Args>(args)...);
+        } else {
+          // The arguments may refer to a wagon of this train, which moves during growth
+          WagonT added(std::forward<Args>(args)...);
+          ensureCapacity(numWagons + 1);
+          std::construct_at(wagons + numWagons, added);
+        }
+        numWagons++;
+        markDirty(numWagons - 1);
+        return wagons[numWagons - 1];
+      }
+
+      /**
+       * @brief Insert a range of wagons at the specified index.
+       *
+       * For forward iterators the range is measured first, so the array grows at most once and the insertion
+       * is all-or-nothing. Single-pass iterators are appended one by one and rotated into place. As with
+       * std::vector, the range must not refer to wagons of this train.
+       *
+       * @param index The index at which to insert the wagons.
+       * @param first The beginning of the range.
+       * @param last The end of the range.
+       * @throws std::invalid_argument if the index is out of bounds.
+       */
+      template <std::input_iterator It, std::sentinel_for<It> S>
+        requires std::constructible_from<WagonT, std::iter_reference_t<It>>
+      void insert(int index, It first, S last) { // Вставка диапазона вагонов по индексу
+        if (index < 0 || index > numWagons) {
+          throw std::invalid_argument("Invalid index for inserting wagons.");
+        }
+        if constexpr (std::forward_iterator<It>) {
+          int count = static_cast<int>(std::ranges::distance(first, last));
+          WagonT* gap = openGap(index, count);
+          int constructed = 0;
+          try {
+            for (; first != last; ++first, ++constructed) {
+              std::construct_at(gap + constructed, *first);
+            }
+          } catch (...) {
+            std::destroy_n(gap, constructed);
+            closeGap(index, count);
+            throw;
+          }
+        } else {
+          int oldNumWagons = numWagons;
+          for (; first != last; ++first) {
+            emplaceWagon(*first);
+          }
+          std::rotate(wagons + index, wagons + oldNumWagons, wagons + numWagons);
+        }
+        markDirtyFrom(index);
+      }
+
+      /**
+       * @brief Append a contiguous sequence of wagons to the end of the train.
+       *
+       * The array grows at most once. The wagons may belong to this train.
+       *
+       * @param wagons The wagons to append.
+       */
+      void append(std::span<const WagonT> wagons); // Добавление последовательности вагонов в конец поезда
 
       /**
        * @brief Get a wagon from the train by its index.
@@ -134,7 +490,7 @@ namespace lab2ComplexClass {
        * @param index The index of the wagon to be retrieved.
        * @return The wagon object.
        */
-      const Wagon& getWagonByIndex(int index) const; // Метод получения вагона по его номеру (возврат по ссылке)
+      const WagonT& getWagonByIndex(int index) const; // Метод получения вагона по его номеру (возврат по ссылке)
 
       /**
        * @brief Remove a wagon from the train by its index.
@@ -150,8 +506,45 @@ namespace lab2ComplexClass {
        *
        * @param passengers The number of passengers to board.
        * @param wagonType The class of wagon to target.
+       * @return The index of the wagon the passengers boarded.
+       */
+      int boardPassengersToMostAvailableWagon(int passengers, WagonType wagonType); // Посадить пассажиров в наиболее свободный вагон
+
+      /**
+       * @brief Check whether a wagon of the given class has room for a group.
+       *
+       * Lets callers that board many groups skip the ones that cannot fit without paying for an exception.
+       *
+       * @param passengers The number of passengers.
+       * @param wagonType The class of wagon.
+       * @return True if boardPassengersToMostAvailableWagon would succeed.
+       */
+      bool hasWagonWithRoom(int passengers, WagonType wagonType) const; // Есть ли вагон класса со свободными местами
+
+      /**
+       * @brief Find the shortest run of adjacent wagons of a class whose free seats together fit a group.
+       *
+       * A sliding window over the prefix sums of free seats inside each run of same-class wagons finds the
+       * answer in O(n); among runs of the same length the first one wins.
+       *
+       * @param passengers The number of passengers in the group.
+       * @param wagonType The class of wagon.
+       * @return The index of the first wagon and the number of wagons; {-1, 0} if the group does not fit.
+       * @throws std::invalid_argument if the group is empty.
+       */
+      std::pair<int, int> findAdjacentWagonsForGroup(int passengers, WagonType wagonType) const; // Найти кратчайшую группу соседних вагонов
+
+      /**
+       * @brief Board a group into the run of wagons findAdjacentWagonsForGroup chooses, filling them in order.
+       *
+       * Either the whole group boards or the train is left unchanged.
+       *
+       * @param passengers The number of passengers in the group.
+       * @param wagonType The class of wagon.
+       * @return The index of the first wagon and the number of wagons.
+       * @throws std::invalid_argument if the group is empty or does not fit into any run of adjacent wagons.
        */
-      void boardPassengersToMostAvailableWagon(int passengers, WagonType wagonType); // Посадить пассажиров в наиболее свободный вагон
+      std::pair<int, int> boardGroupToAdjacentWagons(int passengers, WagonType wagonType); // Посадить группу в соседние вагоны
 
       /**
        * @brief Get the count of passengers in the train by wagon type and the maximum capacity for that type.
@@ -162,7 +555,7 @@ namespace lab2ComplexClass {
        * @param occupiedSeats The count of currently occupied seats for the specified class.
        * @param maxCapacity The maximum capacity for the specified class of wagons.
        */
-      void getPassengerCountByType(lab2SimpleClass::WagonType wagonType, int& occupiedSeats, int& maxCapacity); // Счетчик пассажиров в однотипных вагонах
+      void getPassengerCountByType(lab2SimpleClass::WagonType wagonType, int& occupiedSeats, int& maxCapacity) const; // Счетчик пассажиров в однотипных вагонах
 
       /**
        * @brief Redistribute passengers between wagons to maximize occupancy balance.
@@ -186,7 +579,7 @@ namespace lab2ComplexClass {
        * @param newWagon The new wagon to be added.
        * @param index The index at which to insert the new wagon.
        */
-      void addWagonAtIndex(const Wagon& newWagon, int index); // Добавить вагон по индексу
+      void addWagonAtIndex(const WagonT& newWagon, int index); // Добавить вагон по индексу
 
       /**
        * @brief Optimize the placement of restaurant wagons in the train for balanced occupancy.
@@ -201,7 +594,7 @@ namespace lab2ComplexClass {
        * @param wagon The wagon to be added to the train.
        * @return A reference to the modified train.
        */
-      Train& operator+=(const Wagon& wagon); // Добавление нового вагона в поезд
+      BasicTrain& operator+=(const WagonT& wagon); // Добавление нового вагона в поезд
 
       /**
        * @brief Overloaded subscript operator for accessing wagons by index.
@@ -209,7 +602,7 @@ namespace lab2ComplexClass {
        * @param index The index of the wagon to be accessed.
        * @return A reference to the wagon object.
        */
-      Wagon& operator[](int index); // Получение вагона по его номеру (возврат по ссылке)
+      WagonT& operator[](int index); // Получение вагона по его номеру (возврат по ссылке)
   
       /**
        * @brief Overloaded const subscript operator for accessing wagons by index.
@@ -217,7 +610,80 @@ namespace lab2ComplexClass {
        * @param index The index of the wagon to be accessed.
        * @return A const reference to the wagon object.
        */
-      const Wagon& operator[](int index) const;
+      const WagonT& operator[](int index) const;
+
+      // Обход и ленивые представления
+      /**
+       * @brief Get an iterator to the first wagon.
+       *
+       * Iteration is read-only, also on a non-const train, so range-for loops and std::ranges algorithms leave
+       * the checkpoint state alone; use mutableWagons() to modify the wagons in place.
+       *
+       * @return A random-access iterator to the first wagon.
+       */
+      const WagonT* begin() const;
+
+      /**
+       * @brief Get an iterator past the last wagon.
+       *
+       * @return A random-access iterator past the last wagon.
+       */
+      const WagonT* end() const;
+
+      /**
+       * @brief Get a wagon by its index without bounds checking.
+       *
+       * @param index The index of the wagon, must be in [0, getNumWagons()).
+       * @return A const reference to the wagon.
+       */
+      const WagonT& getWagonUnchecked(int index) const noexcept { return wagons[index]; } // Доступ к вагону без проверки индекса
+
+      /**
+       * @brief Get the wagons as a read-only contiguous view.
+       *
+       * @return The view over all wagons.
+       */
+      std::span<const WagonT> view() const noexcept { return {wagons, static_cast<size_t>(numWagons)}; } // Представление вагонов
+
+      /**
+       * @brief Get the wagons as a modifiable contiguous view.
+       *
+       * The wagons can be modified through the view, so every wagon is marked as changed since the last checkpoint.
+       *
+       * @return The view over all wagons.
+       */
+      std::span<WagonT> mutableWagons();
+
+      /**
+       * @brief Get a lazy view of the wagons of a class.
+       *
+       * @param wagonType The class of wagons to select.
+       * @return A bidirectional view over the matching wagons.
+       */
+      auto wagonsOfType(WagonType wagonType) const { // Вагоны заданного класса
+        return view() | std::views::filter([wagonType](const WagonT& wagon) { return wagon.getType() == wagonType; });
+      }
+
+      /**
+       * @brief Get a lazy view of the wagons that can take at least the given number of passengers.
+       *
+       * @param seats The minimum number of free seats.
+       * @return A bidirectional view over the matching wagons.
+       */
+      auto wagonsWithFreeSeats(int seats) const { // Вагоны с не менее чем seats свободными местами
+        return view() | std::views::filter([seats](const WagonT& wagon) {
+          return wagon.getMaxCapacity() - wagon.getOccupiedSeats() >= seats;
+        });
+      }
+
+      /**
+       * @brief Get a lazy column of the occupied seats of every wagon.
+       *
+       * @return A random-access sized view of the occupied seats.
+       */
+      auto occupancyColumn() const { // Столбец занятых мест
+        return view() | std::views::transform(&WagonT::getOccupiedSeats);
+      }
 
       /**
        * @brief Overloaded assignment operator for copying another train.
@@ -225,7 +691,7 @@ namespace lab2ComplexClass {
        * @param other Another Train object to be copied.
        * @return A reference to the modified train.
        */
-      Train& operator=(const Train& other); // Перегрузка оператора "=" для копирования экземпляра класса
+      BasicTrain& operator=(const BasicTrain& other); // Перегрузка оператора "=" для копирования экземпляра класса
 
       /**
        * @brief Overloaded move assignment operator for moving another train.
@@ -233,7 +699,7 @@ namespace lab2ComplexClass {
        * @param other Another Train object to be moved.
        * @return A reference to the modified train.
        */
-      Train& operator=(Train&& other); // Перемещающий оператор присваивания
+      BasicTrain& operator=(BasicTrain&& other) noexcept(StorageType::NOTHROW_TRANSFER); // Перемещающий оператор присваивания
 
       /**
        * @brief Overloaded input operator for reading a Train object from an input stream.
@@ -244,7 +710,7 @@ namespace lab2ComplexClass {
        * @param train The Train object to store the read data.
        * @return The input stream after reading the train data.
        */
-      friend std::istream& operator>>(std::istream& is, Train& train); // Перегрузка оператора >> для ввода экземпляра поезда
+      friend std::istream& operator>>(std::istream& is, BasicTrain& train) { return train.read(is); } // Перегрузка оператора >> для ввода экземпляра поезда
 
       /**
        * @brief Overloaded output operator for writing a Train object to an output stream.
@@ -255,9 +721,51 @@ namespace lab2ComplexClass {
        * @param train The Train object to be written to the output stream.
        * @return The output stream after writing the train data.
        */
-      friend std::ostream& operator<<(std::ostream& os, const Train& train); // Перегрузка оператора "<<" для вывода поезда в выходной поток
+      friend std::ostream& operator<<(std::ostream& os, const BasicTrain& train) { return train.write(os); } // Перегрузка оператора "<<" для вывода поезда в выходной поток
+
+      // Отслеживание изменений для контрольных точек
+      /**
+       * @brief Check whether a wagon was changed since the last checkpoint.
+       *
+       * A wagon is considered changed after any mutation through the non-const operator[], the setters,
+       * the boarding methods or a structural change that shifted it.
+       *
+       * @param index The index of the wagon.
+       * @return True if the wagon is dirty, false otherwise.
+       * @throws std::out_of_range if the index is invalid.
+       */
+      bool isWagonDirty(int index) const;
+
+      /**
+       * @brief Get the number of wagons changed since the last checkpoint.
+       *
+       * @return The number of dirty wagons.
+       */
+      int getDirtyCount() const;
+
+      /**
+       * @brief Forget all recorded changes, typically after a checkpoint has been written.
+       */
+      void clearDirty();
+
+      /**
+       * @brief Mark every wagon as changed, forcing it into the next checkpoint.
+       */
+      void markAllDirty();
   };
 
 } // namespace lab2ComplexClass
 
+#include "train.tpp"
+
+namespace lab2ComplexClass {
+
+  /// @brief The train used throughout the library: full wagons in a heap array.
+  using Train = BasicTrain<Wagon, HeapStorage>;
+
+  // Train компилируется один раз в train.cpp
+  extern template class BasicTrain<Wagon, HeapStorage>;
+
+} // namespace lab2ComplexClass
+
 #endif // TRAIN_H
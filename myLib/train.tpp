@@ -0,0 +1,1263 @@
+// Определения шаблона BasicTrain, подключаются из train.h
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief Equality operator for comparing two Train objects.
+   *
+   * This operator checks if two Train objects are equal by comparing the number of wagons
+   * and the types of wagons they contain. Two trains are considered equal if they have the same
+   * number of wagons and each pair of corresponding wagons in the trains is equal.
+   *
+   * @param other The Train object to compare with.
+   * @return True if the two trains are equal, false otherwise.
+   *
+   * @note Two trains are considered equal if they have the same number of wagons and each pair
+   * of corresponding wagons in the trains is equal.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  bool BasicTrain<WagonT, Storage>::operator==(const BasicTrain& other) const {
+    if (numWagons != other.numWagons) {
+      return false; 
+    }
+
+    for (int i = 0; i < numWagons; i++) {
+      if (wagons[i] == other.wagons[i]) {
+        return true; 
+      } else {
+        return false;
+      }
+    }
+
+    return true; 
+  }
+  
+  /**
+   * @brief Default constructor for the Train class.
+   *
+   * This constructor initializes a Train object with default values, resulting in an empty train.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  BasicTrain<WagonT, Storage>::BasicTrain() : numWagons(0), wagons(nullptr), capacity(0) {}
+
+  /**
+   * @brief Constructor of an empty train with the given storage.
+   *
+   * Nothing is allocated until the first wagon is added.
+   *
+   * @param storage The storage the wagon arrays of the train come from.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  BasicTrain<WagonT, Storage>::BasicTrain(const StorageType& storage) : storage(storage), numWagons(0), wagons(nullptr), capacity(0) {}
+
+  /**
+   * @brief Constructor for the Train class with initialization from an array of wagons.
+   *
+   * This constructor initializes a Train object with an array of wagons provided as an argument.
+   *
+   * @param wagons An array of Wagon objects to initialize the train with.
+   * @param numWagons The number of wagons in the array.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  BasicTrain<WagonT, Storage>::BasicTrain(const WagonT wagons[], int numWagons) : numWagons(numWagons), wagons(nullptr), capacity(numWagons) {
+    this->wagons = allocateWagons(capacity);
+    std::uninitialized_copy_n(wagons, numWagons, this->wagons);
+    markAllDirty();
+  }
+
+  /**
+   * @brief Constructor for the Train class with initialization from a single wagon.
+   *
+   * This constructor initializes a Train object with a single wagon provided as an argument.
+   *
+   * @param wagon A single Wagon object to initialize the train with.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  BasicTrain<WagonT, Storage>::BasicTrain(const WagonT& wagon) : numWagons(1), wagons(nullptr), capacity(1) {
+      wagons = allocateWagons(capacity);
+      std::construct_at(wagons, wagon);
+      markAllDirty();
+  }
+
+  /**
+   * @brief Copy constructor for the Train class.
+   *
+   * This constructor creates a new Train object as a copy of another Train object.
+   *
+   * @param other The Train object to be copied.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  BasicTrain<WagonT, Storage>::BasicTrain(const BasicTrain& other) : storage(other.storage), numWagons(other.numWagons), wagons(nullptr), capacity(other.capacity), growthPolicy(other.growthPolicy) {
+    TRAIN_INSTR_OP(TRAIN_COPY);
+    wagons = allocateWagons(capacity);
+    std::uninitialized_copy_n(other.wagons, numWagons, wagons);
+    markAllDirty();
+  }
+
+  /**
+   * @brief Move constructor for the Train class.
+   *
+   * This constructor moves the content of another Train object to create a new Train object.
+   * A heap or arena array is taken over; wagons in an inline buffer are relocated into the inline
+   * buffer of the new train, which always has room for them.
+   *
+   * @param other The Train object whose content is being moved.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  BasicTrain<WagonT, Storage>::BasicTrain(BasicTrain&& other) noexcept : storage(other.storage), numWagons(other.numWagons), wagons(other.wagons), capacity(other.capacity), dirtyWagons(std::move(other.dirtyWagons)), growthPolicy(other.growthPolicy) {
+      if (other.storage.isInline(other.wagons)) {
+        wagons = allocateWagons(capacity);
+        relocateWagons(other.wagons, numWagons, wagons);
+      }
+      other.dirtyWagons.clear();
+      other.numWagons = 0;
+      other.wagons = nullptr;
+      other.capacity = 0;
+  }
+
+  /**
+   * @brief Get the number of wagons in the train.
+   *
+   * This method returns the current number of wagons in the train.
+   *
+   * @return The number of wagons in the train.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  int BasicTrain<WagonT, Storage>::getNumWagons() const { return numWagons; }
+
+  /**
+   * @brief Get a pointer to the array of wagons in the train.
+   *
+   * This method returns a pointer to the array of wagons in the train. The wagons can be accessed using this pointer.
+   *
+   * @return A pointer to the array of wagons in the train.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  const WagonT* BasicTrain<WagonT, Storage>::getWagons() const { return wagons; }
+
+  /**
+   * @brief Get the capacity of the train's wagon array.
+   *
+   * This method returns the capacity (the number of available slots) of the train's wagon array.
+   *
+   * @return The capacity of the train's wagon array.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  int BasicTrain<WagonT, Storage>::getCapacity() const { return capacity; }
+
+  /**
+   * @brief Set the number of wagons in the train.
+   *
+   * This method sets the number of wagons in the train. New wagons are default-constructed; the array grows
+   * according to the growth policy when the current capacity is not enough.
+   *
+   * @param numWagons The new number of wagons for the train.
+   *
+   * @throws std::invalid_argument if numWagons is negative.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::setNumWagons(int numWagon) {
+    TRAIN_INSTR_OP(TRAIN_SET_NUM_WAGONS);
+    if (numWagon < getNumWagons()) {
+      throw std::invalid_argument("Number of wagons cannot be less than previous numWagons.");
+    }
+    if (numWagon < 0) {
+      throw std::invalid_argument("Number of wagons cannot be negative.");
+    }
+
+    if (numWagon != this->numWagons) {
+      // Grow the array according to the growth policy
+      ensureCapacity(numWagon);
+
+      // New wagons are default-constructed
+      std::uninitialized_default_construct(wagons + this->numWagons, wagons + numWagon);
+
+      // Update the object's data
+      int oldNumWagons = this->numWagons;
+      this->numWagons = numWagon;
+      markDirtyFrom(oldNumWagons);
+    }
+  }
+
+  /**
+   * @brief Set the wagons for the train.
+   *
+   * This method sets the wagons for the train based on an array of wagons and the number of wagons.
+   * The existing array is reused when its capacity is sufficient, otherwise it grows according to the growth policy.
+   *
+   * @param wagons An array of wagons to set for the train.
+   * @param numWagons The number of wagons in the array.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::setWagons(const WagonT* wagons, int numWagons) {
+    TRAIN_INSTR_OP(TRAIN_SET_WAGONS);
+    if (numWagons < 0) {
+      throw std::invalid_argument("Number of wagons cannot be negative.");
+    }
+
+    if (wagons == nullptr) {
+      throw std::invalid_argument("Invalid input: wagons pointer is null.");
+    }
+
+    if (numWagons > capacity) {
+      // The old contents are overwritten, so there is nothing to relocate into the new array
+      int newCapacity = growthPolicy.grow(capacity, numWagons);
+      WagonT* newWagons = allocateWagons(newCapacity);
+      TRAIN_INSTR_COUNT(TRAIN_REALLOCATIONS, 1);
+      std::uninitialized_copy_n(wagons, numWagons, newWagons);
+      deallocateWagons(this->wagons, this->numWagons, this->capacity);
+      this->capacity = newCapacity;
+      this->wagons = newWagons;
+    } else {
+      // Reuse the existing array: overwrite the live wagons, construct or destroy the difference
+      int common = std::min(this->numWagons, numWagons);
+      std::copy_n(wagons, common, this->wagons);
+      std::uninitialized_copy(wagons + common, wagons + numWagons, this->wagons + common);
+      std::destroy(this->wagons + numWagons, this->wagons + this->numWagons);
+    }
+    this->numWagons = numWagons;
+    markAllDirty();
+  }
+
+  /**
+   * @brief Set the capacity of the train's wagon array.
+   *
+   * This method sets the capacity (the number of available slots) of the train's wagon array. It dynamically allocates memory for the wagons based on the new capacity.
+   *
+   * @param capacity The new capacity for the train's wagon array.
+   *
+   * @throws std::invalid_argument if capacity is negative.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::setCapacity(int capacity) {
+    TRAIN_INSTR_OP(TRAIN_SET_CAPACITY);
+    if (capacity < numWagons) {
+      throw std::invalid_argument("Capacity cannot be less than numWagons in train.");
+    }
+    if (capacity < 0) {
+      throw std::invalid_argument("Capacity cannot be negative.");
+    }
+
+    if (capacity != this->capacity) {
+      reallocate(capacity);
+    }
+  }
+  
+  /**
+   * @brief Destructor for the Train class.
+   *
+   * This destructor is responsible for releasing the memory used by the train's wagon array when the Train object is destroyed.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  BasicTrain<WagonT, Storage>::~BasicTrain() {
+      deallocateWagons(wagons, numWagons, capacity); // Release memory when the object is destroyed
+  }
+
+  /**
+   * @brief Add a wagon to the train.
+   *
+   * This method adds a new wagon to the train. If the capacity of the train's wagon array is exceeded,
+   * it grows the array according to the growth policy (doubling by default).
+   *
+   * @param wagon The wagon to be added to the train.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::addWagon(const WagonT &wagon) {
+    TRAIN_INSTR_OP(TRAIN_ADD_WAGON);
+
+    // The wagon may refer to a wagon of this train, which could move during growth
+    WagonT added = wagon;
+
+    // Make sure there is space in the array for the new wagon
+    ensureCapacity(numWagons + 1);
+
+    // Add the new wagon to the end of the array
+    std::construct_at(wagons + numWagons, added);
+    numWagons++;
+    markDirty(numWagons - 1);
+  }
+
+  /**
+   * @brief Append a contiguous sequence of wagons to the end of the train.
+   *
+   * The array grows at most once, according to the growth policy. When it grows, the appended wagons are
+   * copied before the old array is released, so the sequence may refer to wagons of this train.
+   *
+   * @param wagons The wagons to append.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::append(std::span<const WagonT> wagons) {
+    TRAIN_INSTR_OP(TRAIN_APPEND);
+    int count = static_cast<int>(wagons.size());
+    int oldNumWagons = numWagons;
+
+    if (numWagons + count > capacity) {
+      int newCapacity = growthPolicy.grow(capacity, numWagons + count);
+      WagonT* newWagons = allocateWagons(newCapacity);
+      TRAIN_INSTR_COUNT(TRAIN_REALLOCATIONS, 1);
+      std::uninitialized_copy(wagons.begin(), wagons.end(), newWagons + numWagons);
+      relocateWagons(this->wagons, numWagons, newWagons);
+      storage.deallocate(this->wagons, capacity);
+      this->wagons = newWagons;
+      capacity = newCapacity;
+    } else {
+      std::uninitialized_copy(wagons.begin(), wagons.end(), this->wagons + numWagons);
+    }
+    numWagons += count;
+    markDirtyFrom(oldNumWagons);
+  }
+
+  /**
+   * @brief Get a wagon from the train by its index.
+   *
+   * This method retrieves a wagon from the train by its index and returns it by reference.
+   *
+   * @param index The index of the wagon to retrieve (0-based).
+   * @return A reference to the wagon at the specified index.
+   * @throws std::out_of_range if the index is invalid (less than 0 or greater than or equal to the number of wagons).
+   */
+  template <TrainWagon WagonT, typename Storage>
+  const WagonT& BasicTrain<WagonT, Storage>::getWagonByIndex(int index) const {
+    if (index < 0 || index >= numWagons) {
+      throw std::out_of_range("Invalid wagon index.");
+    }
+    return wagons[index];
+  }
+
+  /**
+   * @brief Remove a wagon from the train by its index.
+   *
+   * This method removes a wagon from the train by its index and shifts the wagons with higher indices to the left.
+   *
+   * @param index The index of the wagon to remove (0-based).
+   * @throws std::out_of_range if the index is invalid (less than 0 or greater than or equal to the number of wagons).
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::removeWagonByIndex(int index) {
+    TRAIN_INSTR_OP(TRAIN_REMOVE_WAGON);
+    if (index < 0 || index >= numWagons) {
+      throw std::out_of_range("Invalid wagon index.");
+    }
+
+    // Shift wagons with higher indices to the left
+    std::move(wagons + index + 1, wagons + numWagons, wagons + index);
+    std::destroy_at(wagons + numWagons - 1);
+
+    numWagons--; // Decrease the number of wagons
+    markDirtyFrom(index);
+    shrinkIfSparse();
+  }
+
+  /**
+   * @brief Board a specified number of passengers into the most available wagon of a given class.
+   *
+   * This method boards the specified number of passengers into the most available wagon of the specified class.
+   *
+   * @param passengers The number of passengers to board.
+   * @param wagonType The class of wagon to board passengers into.
+   * @return The index of the wagon the passengers boarded.
+   * @throws std::invalid_argument if an error occurs while boarding passengers.
+   * @throws std::runtime_error if there are no available wagons of the specified class that can accommodate the passengers.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  int BasicTrain<WagonT, Storage>::boardPassengersToMostAvailableWagon(int passengers, WagonType wagonType) {
+    TRAIN_INSTR_OP(TRAIN_BOARD_MOST_AVAILABLE);
+    TRAIN_INSTR_COUNT(WAGONS_SCANNED_FOR_BOARDING, numWagons);
+
+    // Find the most available wagon among those of the specified class that can accommodate the passengers,
+    // in a single pass and without allocating, since boarding runs in simulation and forecasting loops
+    int mostAvailableIndex = -1;
+    for (int i = 0; i < numWagons; ++i) {
+      if (wagons[i].getType() == wagonType && wagons[i].getMaxCapacity() - wagons[i].getOccupiedSeats() >= passengers &&
+          (mostAvailableIndex < 0 || wagons[i].getOccupiedSeats() > wagons[mostAvailableIndex].getOccupiedSeats())) {
+        mostAvailableIndex = i;
+      }
+    }
+
+    if (mostAvailableIndex < 0) {
+      throw std::invalid_argument("No available wagons of the specified type can accommodate the specified number of passengers.");
+    }
+
+    // Board passengers into the most available wagon of the specified class
+    wagons[mostAvailableIndex].boardPassengers(passengers);
+    markDirty(mostAvailableIndex);
+    return mostAvailableIndex;
+  }
+
+  /**
+   * @brief Check whether a wagon of the given class has room for a group.
+   *
+   * Negative counts and classes that carry no passengers are rejected here, as are wagons without seats,
+   * because boarding them throws even when the free-seat arithmetic would allow it.
+   *
+   * @param passengers The number of passengers.
+   * @param wagonType The class of wagon.
+   * @return True if boardPassengersToMostAvailableWagon would succeed.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  bool BasicTrain<WagonT, Storage>::hasWagonWithRoom(int passengers, WagonType wagonType) const {
+    if (passengers < 0 || !wagonTypeTraits(wagonType).canBoard) {
+      return false;
+    }
+    for (int i = 0; i < numWagons; ++i) {
+      if (wagons[i].getType() == wagonType && wagons[i].getMaxCapacity() != 0 &&
+          wagons[i].getMaxCapacity() - wagons[i].getOccupiedSeats() >= passengers) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Find the shortest run of adjacent wagons of a class whose free seats together fit a group.
+   *
+   * The window [left, right] never crosses a wagon of another class. Each wagon enters and leaves the window
+   * once, and the seats in the window are read from a prefix array of free seats.
+   *
+   * @param passengers The number of passengers in the group.
+   * @param wagonType The class of wagon.
+   * @return The index of the first wagon and the number of wagons; {-1, 0} if the group does not fit.
+   * @throws std::invalid_argument if the group is empty.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  std::pair<int, int> BasicTrain<WagonT, Storage>::findAdjacentWagonsForGroup(int passengers, WagonType wagonType) const {
+    if (passengers <= 0) {
+      throw std::invalid_argument("A group must have at least one passenger.");
+    }
+    std::vector<long long> freePrefix(numWagons + 1, 0);
+    for (int i = 0; i < numWagons; i++) {
+      int free = wagons[i].getType() == wagonType ? wagons[i].getMaxCapacity() - wagons[i].getOccupiedSeats() : 0;
+      freePrefix[i + 1] = freePrefix[i] + free;
+    }
+
+    std::pair<int, int> best(-1, 0);
+    int left = 0;
+    for (int right = 0; right < numWagons; right++) {
+      if (wagons[right].getType() != wagonType) {
+        left = right + 1;
+        continue;
+      }
+      while (freePrefix[right + 1] - freePrefix[left + 1] >= passengers) {
+        left++;
+      }
+      if (freePrefix[right + 1] - freePrefix[left] >= passengers && (best.first < 0 || right - left + 1 < best.second)) {
+        best = {left, right - left + 1};
+      }
+    }
+    return best;
+  }
+
+  /**
+   * @brief Board a group into the run of wagons findAdjacentWagonsForGroup chooses, filling them in order.
+   *
+   * The wagons of the run are saved before boarding and restored if a wagon throws, so the train is either
+   * fully updated or unchanged.
+   *
+   * @param passengers The number of passengers in the group.
+   * @param wagonType The class of wagon.
+   * @return The index of the first wagon and the number of wagons.
+   * @throws std::invalid_argument if the group is empty or does not fit into any run of adjacent wagons.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  std::pair<int, int> BasicTrain<WagonT, Storage>::boardGroupToAdjacentWagons(int passengers, WagonType wagonType) {
+    TRAIN_INSTR_OP(TRAIN_BOARD_GROUP);
+    TRAIN_INSTR_COUNT(WAGONS_SCANNED_FOR_BOARDING, numWagons);
+
+    std::pair<int, int> run = findAdjacentWagonsForGroup(passengers, wagonType);
+    if (run.first < 0) {
+      throw std::invalid_argument("No run of adjacent wagons of the specified type can accommodate the group.");
+    }
+
+    std::vector<WagonT> saved(wagons + run.first, wagons + run.first + run.second);
+    try {
+      int remaining = passengers;
+      for (int i = run.first; remaining > 0; i++) {
+        int boarding = std::min(remaining, wagons[i].getMaxCapacity() - wagons[i].getOccupiedSeats());
+        if (boarding > 0) {
+          wagons[i].boardPassengers(boarding);
+          remaining -= boarding;
+        }
+      }
+    } catch (...) {
+      std::copy(saved.begin(), saved.end(), wagons + run.first);
+      throw;
+    }
+    for (int i = run.first; i < run.first + run.second; i++) {
+      markDirty(i);
+    }
+    return run;
+  }
+
+  /**
+   * @brief Get the number of passengers and maximum capacity in wagons of a specified class.
+   *
+   * This auxiliary method calculates the total number of passengers and maximum capacity in the wagons
+   * of the specified class in the train. The loop is branch-free, so the compiler can vectorize it, e.g. over
+   * the 32-bit words of packed wagons.
+   *
+   * @param wagonType The class of wagons to consider.
+   * @param occupiedSeats Output parameter to store the total number of occupied seats in wagons of the specified class.
+   * @param maxCapacity Output parameter to store the total maximum capacity of wagons of the specified class.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::getPassengerCountByType(lab2SimpleClass::WagonType wagonType, int& occupiedSeats, int& maxCapacity) const {
+    TRAIN_INSTR_OP(TRAIN_PASSENGER_COUNT_BY_TYPE);
+    // Local sums: accumulating through the output references would force a store per wagon
+    int occupied = 0;
+    int capacity = 0;
+    for (const WagonT& wagon : view()) {
+      int selected = wagon.getType() == wagonType ? -1 : 0;
+      occupied += wagon.getOccupiedSeats() & selected;
+      capacity += wagon.getMaxCapacity() & selected;
+    }
+    occupiedSeats = occupied;
+    maxCapacity = capacity;
+  }
+
+  /**
+   * @brief Redistribute passengers among wagons to maximize occupancy balance.
+   *
+   * This method redistributes passengers among wagons of different classes (economy, sitting, luxury)
+   * to achieve a balanced occupancy percentage among all wagons. It calculates the average occupancy
+   * percentages for each class of wagons and adjusts the number of passengers in each wagon accordingly.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::redistributePassengers() {
+    TRAIN_INSTR_OP(TRAIN_REDISTRIBUTE);
+    int occupiedByType[WAGON_TYPE_COUNT] = {};
+    int capacityByType[WAGON_TYPE_COUNT] = {};
+
+    // Determine the number of occupied seats and total capacity for each wagon class in a single pass
+    for (int i = 0; i < numWagons; i++) {
+      int type = static_cast<int>(wagons[i].getType());
+      occupiedByType[type] += wagons[i].getOccupiedSeats();
+      capacityByType[type] += wagons[i].getMaxCapacity();
+    }
+
+    // Calculate the average occupancy percentage for each wagon class
+    double occupancyByType[WAGON_TYPE_COUNT] = {};
+    for (int type = 0; type < WAGON_TYPE_COUNT; type++) {
+      if (capacityByType[type] != 0) {
+        occupancyByType[type] = static_cast<double>(occupiedByType[type]) / capacityByType[type];
+      }
+    }
+
+    // Set the number of passengers in each wagon to achieve the calculated occupancy percentages; wagons that
+    // already hold their share are left alone, so they stay out of the next incremental checkpoint
+    for (int i = 0; i < numWagons; i++) {
+      int type = static_cast<int>(wagons[i].getType());
+      if (!WAGON_TYPE_TRAITS[type].canBoard) {
+        continue;
+      }
+      int seats = static_cast<int>(wagons[i].getMaxCapacity() * occupancyByType[type]);
+      if (wagons[i].getOccupiedSeats() != seats) {
+        wagons[i].setOccupiedSeats(seats);
+        markDirty(i);
+      }
+    }
+  }
+
+  /**
+   * @brief Optimize the train by minimizing the number of wagons and redistributing passengers.
+   *
+   * This method minimizes the number of wagons by redistributing passengers among them and removing
+   * wagons with no passengers. It ensures that each wagon type (economy, sitting, luxury) has as many
+   * passengers as possible, reducing the number of empty or underutilized wagons.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::optimizeTrain() {
+    TRAIN_INSTR_OP(TRAIN_OPTIMIZE);
+    int remainingByType[WAGON_TYPE_COUNT] = {};
+
+    // Determine the number of passengers of each wagon class in a single pass
+    for (int i = 0; i < numWagons; i++) {
+      remainingByType[static_cast<int>(wagons[i].getType())] += wagons[i].getOccupiedSeats();
+    }
+
+    // Fill the wagons of each class in order, leaving the last ones empty
+    for (int i = 0; i < numWagons; i++) {
+      int type = static_cast<int>(wagons[i].getType());
+      if (!WAGON_TYPE_TRAITS[type].canBoard) {
+        continue;
+      }
+      int seats = std::min(remainingByType[type], wagons[i].getMaxCapacity());
+      remainingByType[type] -= seats;
+      if (wagons[i].getOccupiedSeats() != seats) {
+        wagons[i].setOccupiedSeats(seats);
+        markDirty(i);
+      }
+    }
+
+    // Remove the empty wagons in a single pass, keeping the order of the remaining ones
+    int kept = 0;
+    int firstRemoved = numWagons;
+    for (int j = 0; j < numWagons; j++) {
+      if (wagons[j].getOccupiedSeats() == 0) {
+        if (firstRemoved == numWagons) {
+          firstRemoved = j;
+        }
+        continue;
+      }
+      if (kept != j) {
+        wagons[kept] = wagons[j];
+      }
+      kept++;
+    }
+
+    if (kept != numWagons) {
+      TRAIN_INSTR_COUNT(WAGONS_REMOVED_BY_OPTIMIZE, numWagons - kept);
+      std::destroy(wagons + kept, wagons + numWagons);
+      numWagons = kept;
+      markDirtyFrom(firstRemoved);
+      shrinkIfSparse();
+    }
+  }
+  
+  /**
+   * @brief Add a new wagon at the specified index.
+   *
+   * This method adds a new wagon to the train at the specified index. The capacity grows according to the
+   * growth policy when needed, and the existing wagons are shifted to accommodate the new wagon at the given position.
+   *
+   * @param newWagon The new wagon to add.
+   * @param index The index at which to insert the new wagon.
+   *
+   * @throw std::invalid_argument if the index is out of bounds.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::addWagonAtIndex(const WagonT& newWagon, int index) {
+    TRAIN_INSTR_OP(TRAIN_ADD_WAGON_AT_INDEX);
+    if (index < 0 || index > numWagons) {
+      throw std::invalid_argument("Invalid index for adding a wagon.");
+    }
+
+    // The new wagon may refer to a wagon of this train, which could move during growth
+    WagonT inserted = newWagon;
+    ensureCapacity(numWagons + 1);
+
+    // Shift the wagons after the specified index one position to the right
+    if (index == numWagons) {
+      std::construct_at(wagons + numWagons, inserted);
+    } else {
+      std::construct_at(wagons + numWagons, std::move(wagons[numWagons - 1]));
+      std::move_backward(wagons + index, wagons + numWagons - 1, wagons + numWagons);
+      wagons[index] = inserted;
+    }
+    numWagons++;
+    markDirtyFrom(index);
+  }
+
+  /**
+   * @brief Optimize the placement of a restaurant wagon for even distribution of passengers.
+   *
+   * This method optimizes the placement of a restaurant wagon within the train to achieve an approximately even
+   * distribution of passengers before and after the restaurant wagon. It calculates the position where the restaurant
+   * wagon should be inserted, taking into account the number of passengers in different wagon types. The restaurant wagon
+   * is then added to the train at the optimal position.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::optimizeRestaurantPlacement() {
+    TRAIN_INSTR_OP(TRAIN_RESTAURANT_PLACEMENT);
+    int totalPassengers = 0;
+    for (int i = 0; i < numWagons; i++) {
+      if (wagons[i].getType() != WagonType::LUXURY) {
+        totalPassengers += wagons[i].getOccupiedSeats();
+      }
+    }
+
+    int midPassengers = totalPassengers / 2;
+
+    int needPosition = 0;
+    for (int j = 0; j < numWagons; j++) {
+      if (wagons[j].getType() != WagonType::LUXURY) {
+        totalPassengers -= wagons[j].getOccupiedSeats();
+        if (totalPassengers != midPassengers) {
+            j++;
+            needPosition = j;
+            break;
+        } else {
+            needPosition = j;
+	    break;
+        }
+      }
+    }
+
+    // Insert the restaurant wagon at the optimal position
+    WagonT restaurantWagon;
+    addWagonAtIndex(restaurantWagon, needPosition);
+  }
+
+  /**
+   * @brief Add a new wagon to the train using the '+=' operator.
+   *
+   * This operator allows you to add a new wagon to the train by using the '+=' operator. The provided wagon is added to
+   * the train's collection of wagon.
+   *
+   * @param wagon The wagon to be added to the train.
+   * @return A reference to the modified train after adding the wagon.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  BasicTrain<WagonT, Storage>& BasicTrain<WagonT, Storage>::operator+=(const WagonT& wagon) {
+    addWagon(wagon);
+    return *this;
+  }
+
+  /**
+   * @brief Access a wagon by its index using the '[]' operator.
+   *
+   * This operator allows you to access a wagon within the train's collection of wagons using an index.
+   *
+   * @param index The index of the wagon to be accessed.
+   * @return A reference to the wagon at the specified index.
+   * @throws std::invalid_argument if the provided index is out of bounds.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  WagonT& BasicTrain<WagonT, Storage>::operator[](int index) {
+    if (index < 0 || index >= numWagons) {
+      throw std::invalid_argument("Invalid wagon index.");
+    }
+
+    markDirty(index);
+    return wagons[index];
+  }
+
+  /**
+   * @brief Access a wagon by its index using the '[]' operator (const version).
+   *
+   * This operator allows you to access a wagon within the train's collection of wagons using an index, and it is a const version that ensures the train remains unmodified.
+   *
+   * @param index The index of the wagon to be accessed.
+   * @return A constant reference to the wagon at the specified index.
+   * @throws std::out_of_range if the provided index is out of bounds.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  const WagonT& BasicTrain<WagonT, Storage>::operator[](int index) const {
+    if (index < 0 || index >= numWagons) {
+      throw std::out_of_range("Index out of range");
+    }
+    return wagons[index];
+  }
+
+  /**
+   * @brief Get the wagons as a modifiable contiguous view.
+   *
+   * The wagons can be modified through the view, so every wagon is marked as changed since the last checkpoint.
+   *
+   * @return The view over all wagons.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  std::span<WagonT> BasicTrain<WagonT, Storage>::mutableWagons() {
+    markAllDirty();
+    return {wagons, static_cast<size_t>(numWagons)};
+  }
+
+  /**
+   * @brief Get an iterator to the first wagon.
+   *
+   * @return A random-access iterator to the first wagon.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  const WagonT* BasicTrain<WagonT, Storage>::begin() const { return wagons; }
+
+  /**
+   * @brief Get an iterator past the last wagon.
+   *
+   * @return A random-access iterator past the last wagon.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  const WagonT* BasicTrain<WagonT, Storage>::end() const { return wagons + numWagons; }
+
+  /**
+   * @brief Copy assignment operator.
+   *
+   * This operator overloads the assignment operator to allow you to make a deep copy of another train object.
+   * It checks for self-assignment to prevent unnecessary work.
+   *
+   * When the current capacity can hold the other train, the existing array is reused and nothing is allocated
+   * (apart from the first growth of the dirty-wagon bitset), which makes repeated assignment into a scratch
+   * train allocation-free. Otherwise a new array is built before the old one is released. In both cases the
+   * assignment gives the strong exception guarantee: if it throws, this train is unchanged.
+   *
+   * @param other The train object to be copied.
+   * @return A reference to the modified train object.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  BasicTrain<WagonT, Storage>& BasicTrain<WagonT, Storage>::operator=(const BasicTrain& other) {
+    TRAIN_INSTR_OP(TRAIN_COPY_ASSIGN);
+    if (this == &other) {
+      return *this; // Check for self-assignment
+    }
+
+    // The only allocation that may fail on the reuse path happens before anything is modified
+    dirtyWagons.reserve(other.numWagons);
+
+    if constexpr (std::is_nothrow_copy_constructible_v<WagonT> && std::is_nothrow_copy_assignable_v<WagonT>) {
+      if (other.numWagons <= capacity) {
+        // Reuse the existing array: overwrite the live wagons, construct or destroy the difference
+        int common = std::min(numWagons, other.numWagons);
+        std::copy_n(other.wagons, common, wagons);
+        std::uninitialized_copy(other.wagons + common, other.wagons + other.numWagons, wagons + common);
+        std::destroy(wagons + other.numWagons, wagons + numWagons);
+
+        numWagons = other.numWagons;
+        growthPolicy = other.growthPolicy;
+        markAllDirty();
+        return *this;
+      }
+    }
+
+    // Build the copy first, so that a failure leaves this train unchanged
+    int newCapacity = growthPolicy.grow(capacity, other.numWagons);
+    WagonT* newWagons = allocateWagons(newCapacity);
+    TRAIN_INSTR_COUNT(TRAIN_REALLOCATIONS, 1);
+    try {
+      std::uninitialized_copy_n(other.wagons, other.numWagons, newWagons);
+    } catch (...) {
+      storage.deallocate(newWagons, newCapacity);
+      throw;
+    }
+    deallocateWagons(wagons, numWagons, capacity);
+
+    numWagons = other.numWagons;
+    wagons = newWagons;
+    capacity = newCapacity;
+    growthPolicy = other.growthPolicy;
+
+    markAllDirty();
+    return *this;
+  }
+
+  /**
+   * @brief Move assignment operator.
+   *
+   * This operator overloads the move assignment operator, allowing you to efficiently transfer the resources
+   * (e.g., wagons) from one train object to another. It checks for self-assignment to avoid issues and releases
+   * the resources of the current object before moving the resources from the other object.
+   *
+   * The array of the other train is taken over when this train's storage can release it. Wagons in an
+   * inline buffer, or in an arena this train cannot release, are relocated into this train's own storage
+   * instead; only the latter may allocate.
+   *
+   * @param other The train object to move resources from.
+   * @return A reference to the modified train object.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  BasicTrain<WagonT, Storage>& BasicTrain<WagonT, Storage>::operator=(BasicTrain&& other) noexcept(StorageType::NOTHROW_TRANSFER) {
+    if (this == &other) {
+      return *this; // Check for self-assignment
+    }
+
+    if (!other.storage.isInline(other.wagons) && storage.canAdopt(other.storage)) {
+      // Release resources of the current object
+      deallocateWagons(wagons, numWagons, capacity);
+
+      // Move resources from 'other' to 'this'
+      wagons = other.wagons;
+      capacity = other.capacity;
+      other.wagons = nullptr;
+      other.capacity = 0;
+    } else {
+      // Relocate the wagons into this train's storage; the other train keeps its (now empty) array
+      WagonT* target = wagons;
+      int targetCapacity = capacity;
+      if (other.numWagons > capacity) {
+        targetCapacity = other.numWagons;
+        target = allocateWagons(targetCapacity);
+      }
+      std::destroy_n(wagons, numWagons);
+      if (target != wagons) {
+        storage.deallocate(wagons, capacity);
+      }
+      relocateWagons(other.wagons, other.numWagons, target);
+      wagons = target;
+      capacity = targetCapacity;
+    }
+    numWagons = other.numWagons;
+    dirtyWagons = std::move(other.dirtyWagons);
+    growthPolicy = other.growthPolicy;
+
+    // Reset 'other' to a valid but empty state
+    other.dirtyWagons.clear();
+    other.numWagons = 0;
+
+    return *this;
+  }
+    
+  /**
+   * @brief Overload of the input stream operator (>>) to input a train instance.
+   *
+   * This operator allows you to input a `Train` object from an input stream, which consists of an integer
+   * representing the number of wagons in the train followed by the details of each wagon. It validates the
+   * input to ensure it's well-formed and constructs a new `Train` object based on the input data.
+   *
+   * The friend operator>> forwards to this method. If the stream fails, the train is left unchanged.
+   *
+   * @param is The input stream to read the train data from.
+   * @return A reference to the input stream after reading the train data.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  std::istream& BasicTrain<WagonT, Storage>::read(std::istream& is) {
+    TRAIN_INSTR_OP(TRAIN_READ);
+    int numWagons;
+    is >> numWagons;
+
+    // Check for EOF
+    if (!is.good()) {
+        return is;
+    }
+
+    // Check for invalid input
+    if (numWagons < 0) {
+        is.setstate(std::ios::failbit);
+        return is;
+    }
+
+    // The temporary uses the same kind of storage, so it can be moved into this train at the end
+    BasicTrain tempTrain(storage);
+
+    tempTrain.capacity = numWagons;
+    try {
+      tempTrain.wagons = tempTrain.allocateWagons(tempTrain.capacity);
+    } catch (const std::length_error&) {
+      tempTrain.capacity = 0;
+      is.setstate(std::ios::failbit);
+      return is;
+    }
+
+    for (int i = 0; i < numWagons; i++) {
+      std::construct_at(tempTrain.wagons + i);
+      tempTrain.numWagons = i + 1;
+      is >> tempTrain.wagons[i];
+      if (!is.good()) {
+        return is;
+      }
+    }
+
+    tempTrain.markAllDirty();
+    *this = std::move(tempTrain);
+
+    return is;
+  }
+
+  /**
+   * @brief Overload of the output stream operator (<<) to output the train to an output stream.
+   *
+   * This operator allows you to output a `Train` object to an output stream. It prints the number of wagons in the
+   * train and the details of each wagon. This makes it easy to display the entire state of the train in a formatted way.
+   *
+   * The friend operator<< forwards to this method.
+   *
+   * @param os The output stream to which the train should be written.
+   * @return A reference to the output stream after writing the train data.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  std::ostream& BasicTrain<WagonT, Storage>::write(std::ostream& os) const {
+    TRAIN_INSTR_OP(TRAIN_WRITE);
+    os << numWagons << std::endl;
+    for (int i = 0; i < numWagons; i++) {
+        os << wagons[i];
+    }
+    return os;
+  }
+
+  /**
+   * @brief Mark a single wagon as changed since the last checkpoint.
+   *
+   * The dirty bitset grows lazily, so wagons appended since the last call are covered as well.
+   *
+   * @param index The index of the changed wagon.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::markDirty(int index) {
+    if (static_cast<int>(dirtyWagons.size()) < numWagons) {
+      dirtyWagons.resize(numWagons, false);
+    }
+    dirtyWagons[index] = true;
+  }
+
+  /**
+   * @brief Mark every wagon from the given index to the end of the train as changed.
+   *
+   * Structural operations (insertion, removal, growth) shift the tail of the array, so every
+   * wagon after the change point has a new position and must be written again. The bitset is
+   * trimmed to the current number of wagons.
+   *
+   * @param index The first changed index.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::markDirtyFrom(int index) {
+    dirtyWagons.resize(numWagons, false);
+    for (int i = index; i < numWagons; i++) {
+      dirtyWagons[i] = true;
+    }
+  }
+
+  /**
+   * @brief Check whether a wagon was changed since the last checkpoint.
+   *
+   * @param index The index of the wagon.
+   * @return True if the wagon is dirty, false otherwise.
+   * @throws std::out_of_range if the index is invalid.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  bool BasicTrain<WagonT, Storage>::isWagonDirty(int index) const {
+    if (index < 0 || index >= numWagons) {
+      throw std::out_of_range("Invalid wagon index.");
+    }
+    return index < static_cast<int>(dirtyWagons.size()) && dirtyWagons[index];
+  }
+
+  /**
+   * @brief Get the number of wagons changed since the last checkpoint.
+   *
+   * @return The number of dirty wagons.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  int BasicTrain<WagonT, Storage>::getDirtyCount() const {
+    int count = 0;
+    for (int i = 0; i < numWagons && i < static_cast<int>(dirtyWagons.size()); i++) {
+      if (dirtyWagons[i]) {
+        count++;
+      }
+    }
+    return count;
+  }
+
+  /**
+   * @brief Forget all recorded changes.
+   *
+   * Called by the checkpoint writer once the current state of the train has been persisted.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::clearDirty() {
+    dirtyWagons.assign(numWagons, false);
+  }
+
+  /**
+   * @brief Mark every wagon as changed, forcing it into the next checkpoint.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::markAllDirty() {
+    dirtyWagons.assign(numWagons, true);
+  }
+
+  /**
+   * @brief Move the wagons into a newly allocated array of the given capacity.
+   *
+   * This is the only place where the wagon array is reallocated after construction. Wagons in an inline
+   * buffer that can hold the new capacity stay where they are.
+   *
+   * @param newCapacity The new capacity, not less than the number of wagons.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::reallocate(int newCapacity) {
+    if (storage.isInline(wagons) && newCapacity <= StorageType::INLINE_CAPACITY) {
+      return;
+    }
+    WagonT* newWagons = allocateWagons(newCapacity);
+    TRAIN_INSTR_COUNT(TRAIN_REALLOCATIONS, 1);
+
+    // Relocate existing wagons into the new array; the slots past them stay uninitialized
+    relocateWagons(wagons, numWagons, newWagons);
+
+    storage.deallocate(wagons, capacity);
+    wagons = newWagons;
+    capacity = newCapacity;
+  }
+
+  /**
+   * @brief Allocate uninitialized storage for wagons.
+   *
+   * No wagon is constructed, so growing the capacity does not pay for default construction. The storage
+   * policy may hand out more room than requested (an inline buffer), which is reported back in capacity.
+   *
+   * @param capacity The number of wagons the storage must hold; updated to the number it can hold.
+   * @return The storage, or nullptr if capacity is 0.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  WagonT* BasicTrain<WagonT, Storage>::allocateWagons(int& capacity) {
+    if (capacity == 0) {
+      return nullptr;
+    }
+    return storage.allocate(capacity);
+  }
+
+  /**
+   * @brief Destroy the live wagons of an array and release its storage.
+   *
+   * @param wagons The storage returned by allocateWagons.
+   * @param numWagons The number of live wagons at the beginning of the storage.
+   * @param capacity The capacity of the storage.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::deallocateWagons(WagonT* wagons, int numWagons, int capacity) {
+    std::destroy_n(wagons, numWagons);
+    storage.deallocate(wagons, capacity);
+  }
+
+  /**
+   * @brief Move wagons into uninitialized storage and end their lifetime in the source.
+   *
+   * Trivially copyable wagons are relocated with a single memmove; the source and destination may overlap.
+   *
+   * @param from The source wagons.
+   * @param numWagons The number of wagons to relocate.
+   * @param to The uninitialized destination storage.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::relocateWagons(WagonT* from, int numWagons, WagonT* to) {
+    if (numWagons == 0 || from == to) {
+      return;
+    }
+    if constexpr (std::is_trivially_copyable_v<WagonT>) {
+      std::memmove(static_cast<void*>(to), from, static_cast<size_t>(numWagons) * sizeof(WagonT));
+    } else if (to < from) {
+      for (int i = 0; i < numWagons; i++) {
+        std::construct_at(to + i, std::move(from[i]));
+        std::destroy_at(from + i);
+      }
+    } else {
+      for (int i = numWagons - 1; i >= 0; i--) {
+        std::construct_at(to + i, std::move(from[i]));
+        std::destroy_at(from + i);
+      }
+    }
+  }
+
+  /**
+   * @brief Grow the array according to the growth policy if it cannot hold the required number of wagons.
+   *
+   * @param required The required capacity.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::ensureCapacity(int required) {
+    if (required > capacity) {
+      reallocate(growthPolicy.grow(capacity, required));
+    }
+  }
+
+  /**
+   * @brief Shift the wagons from the index to the right, leaving a gap of uninitialized slots.
+   *
+   * When the array has to grow, the wagons before and after the gap are relocated straight into their final
+   * positions in the new array, so every wagon moves once.
+   *
+   * @param index The position of the gap.
+   * @param count The number of slots in the gap.
+   * @return The first slot of the gap.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  WagonT* BasicTrain<WagonT, Storage>::openGap(int index, int count) {
+    if (numWagons + count > capacity) {
+      int newCapacity = growthPolicy.grow(capacity, numWagons + count);
+      WagonT* newWagons = allocateWagons(newCapacity);
+      TRAIN_INSTR_COUNT(TRAIN_REALLOCATIONS, 1);
+      relocateWagons(wagons, index, newWagons);
+      relocateWagons(wagons + index, numWagons - index, newWagons + index + count);
+      storage.deallocate(wagons, capacity);
+      wagons = newWagons;
+      capacity = newCapacity;
+    } else {
+      relocateWagons(wagons + index, numWagons - index, wagons + index + count);
+    }
+    numWagons += count;
+    return wagons + index;
+  }
+
+  /**
+   * @brief Remove a gap of uninitialized slots left by openGap, shifting the wagons after it back.
+   *
+   * @param index The position of the gap.
+   * @param count The number of slots in the gap.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::closeGap(int index, int count) {
+    relocateWagons(wagons + index + count, numWagons - index - count, wagons + index);
+    numWagons -= count;
+  }
+
+  /**
+   * @brief Shrink the array if the growth policy considers it too sparse.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::shrinkIfSparse() {
+    if (growthPolicy.shouldShrink(numWagons, capacity)) {
+      reallocate(growthPolicy.shrinkTarget(numWagons));
+    }
+  }
+
+  /**
+   * @brief Make sure the wagon array can hold at least the given number of wagons without reallocation.
+   *
+   * Unlike the growth paths, reserve allocates exactly the requested capacity.
+   *
+   * @param minCapacity The minimum capacity.
+   * @throws std::invalid_argument if minCapacity is negative.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::reserve(int minCapacity) {
+    if (minCapacity < 0) {
+      throw std::invalid_argument("Capacity cannot be negative.");
+    }
+    if (minCapacity > capacity) {
+      reallocate(minCapacity);
+    }
+  }
+
+  /**
+   * @brief Release the unused capacity of the wagon array.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::shrinkToFit() {
+    if (capacity != numWagons) {
+      reallocate(numWagons);
+    }
+    dirtyWagons.shrink_to_fit();
+  }
+
+  /**
+   * @brief Get the heap memory owned by the train.
+   *
+   * @return The number of bytes used by the wagon array and the dirty-wagon bitset; an inline array is part
+   * of the train object and is not counted.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  size_t BasicTrain<WagonT, Storage>::bytesUsed() const {
+    size_t bitsetWords = (dirtyWagons.capacity() + 63) / 64;
+    size_t arrayBytes = storage.isInline(wagons) ? 0 : static_cast<size_t>(capacity) * sizeof(WagonT);
+    return arrayBytes + bitsetWords * sizeof(uint64_t);
+  }
+
+  /**
+   * @brief Get the memory reserved for wagons that are not in the train.
+   *
+   * @return The number of unused bytes in the wagon array.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  size_t BasicTrain<WagonT, Storage>::slack() const {
+    return static_cast<size_t>(capacity - numWagons) * sizeof(WagonT);
+  }
+
+  /**
+   * @brief Get the growth policy of the train.
+   *
+   * @return The growth policy.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  const GrowthPolicy& BasicTrain<WagonT, Storage>::getGrowthPolicy() const { return growthPolicy; }
+
+  /**
+   * @brief Set the growth policy used by all growth paths of the train.
+   *
+   * The new policy takes effect on the next growth or removal; the current capacity is kept.
+   *
+   * @param policy The new growth policy.
+   */
+  template <TrainWagon WagonT, typename Storage>
+  void BasicTrain<WagonT, Storage>::setGrowthPolicy(const GrowthPolicy& policy) { growthPolicy = policy; }
+
+} // namespace lab2ComplexClass
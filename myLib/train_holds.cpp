@@ -0,0 +1,133 @@
+#include <stdexcept>
+#include "train_holds.h"
+
+namespace lab2ComplexClass {
+
+  /**
+   * @brief Constructor.
+   *
+   * @param train The train; its occupied seats are confirmed.
+   * @param start The current time in milliseconds.
+   * @throws std::invalid_argument if the time is negative.
+   */
+  TrainHolds::TrainHolds(const Train& train, int64_t start) : train(train), wheel(start) {}
+
+  /**
+   * @brief Get the train.
+   *
+   * @return The train, with held seats counted as occupied.
+   */
+  const Train& TrainHolds::getTrain() const { return train; }
+
+  /**
+   * @brief Get the current time.
+   *
+   * @return The time in milliseconds.
+   */
+  int64_t TrainHolds::getTime() const { return wheel.getTime(); }
+
+  /**
+   * @brief Get the number of pending holds.
+   *
+   * @return The number of holds neither confirmed, released nor expired.
+   */
+  size_t TrainHolds::getActiveHoldCount() const { return wheel.size(); }
+
+  /**
+   * @brief Get the number of seats under pending holds.
+   *
+   * @return The number of seats.
+   */
+  int64_t TrainHolds::getHeldSeats() const { return heldSeats; }
+
+  /**
+   * @brief Hold seats in the wagon boardPassengersToMostAvailableWagon chooses.
+   *
+   * @param passengers The number of passengers, positive.
+   * @param wagonType The class of wagon.
+   * @param ttl How long the hold lasts unless confirmed, in milliseconds, positive.
+   * @return The id of the hold.
+   * @throws std::invalid_argument if the count or the ttl is invalid, or no wagon can take the passengers.
+   */
+  HoldId TrainHolds::hold(int passengers, WagonType wagonType, int64_t ttl) {
+    if (passengers <= 0) {
+      throw std::invalid_argument("Number of passengers must be positive.");
+    }
+    if (ttl <= 0) {
+      throw std::invalid_argument("Hold time must be positive.");
+    }
+    // Таймер ставится до посадки, чтобы слишком долгое удержание не оставило занятых мест
+    HoldId id = wheel.schedule(wheel.getTime() + ttl, Hold{-1, passengers});
+    try {
+      wheel.find(id)->wagon = train.boardPassengersToMostAvailableWagon(passengers, wagonType);
+    } catch (...) {
+      wheel.cancel(id);
+      throw;
+    }
+    heldSeats += passengers;
+    return id;
+  }
+
+  /**
+   * @brief Confirm a hold; its seats stay occupied for good.
+   *
+   * @param id The id of the hold.
+   * @return False if the hold has already expired, been confirmed or been released.
+   */
+  bool TrainHolds::confirm(HoldId id) {
+    const Hold* pending = wheel.find(id);
+    if (pending == nullptr) {
+      return false;
+    }
+    heldSeats -= pending->passengers;
+    wheel.cancel(id);
+    return true;
+  }
+
+  /**
+   * @brief Release a hold before it expires and free its seats.
+   *
+   * @param id The id of the hold.
+   * @return False if the hold has already expired, been confirmed or been released.
+   */
+  bool TrainHolds::release(HoldId id) {
+    const Hold* pending = wheel.find(id);
+    if (pending == nullptr) {
+      return false;
+    }
+    Hold freed = *pending;
+    wheel.cancel(id);
+    train[freed.wagon].disembarkPassengers(freed.passengers);
+    heldSeats -= freed.passengers;
+    return true;
+  }
+
+  /**
+   * @brief Move the clock forward and free the seats of every hold that expires.
+   *
+   * Seats are summed per wagon first, so each wagon is written once per call however many of its holds expire.
+   *
+   * @param now The new time in milliseconds.
+   * @return The number of holds that expired.
+   * @throws std::invalid_argument if the time goes backwards.
+   */
+  size_t TrainHolds::advanceTo(int64_t now) {
+    expired.clear();
+    size_t fired = wheel.advance(now, expired);
+    if (fired == 0) {
+      return 0;
+    }
+    released.assign(train.getNumWagons(), 0);
+    for (const Hold& freed : expired) {
+      released[freed.wagon] += freed.passengers;
+      heldSeats -= freed.passengers;
+    }
+    for (int i = 0; i < static_cast<int>(released.size()); i++) {
+      if (released[i] > 0) {
+        train[i].disembarkPassengers(released[i]);
+      }
+    }
+    return fired;
+  }
+
+} // namespace lab2ComplexClass
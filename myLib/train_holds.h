@@ -0,0 +1,113 @@
+#ifndef TRAIN_HOLDS_H
+#define TRAIN_HOLDS_H
+
+#include <cstdint>
+#include <vector>
+#include "timing_wheel.h"
+#include "train.h"
+
+namespace lab2ComplexClass {
+
+  /// @brief Handle of a seat hold.
+  using HoldId = TimerId;
+
+  /**
+   * @brief Temporary seat holds on a train that expire unless confirmed.
+   *
+   * A hold boards its passengers at once, exactly as boardPassengersToMostAvailableWagon does, so held seats
+   * are taken for every other query on the train. Its expiry is a timer of a TimingWheel, so holding, confirming
+   * and releasing are O(1) however many holds are pending. Advancing the clock collects every expired hold first
+   * and then disembarks the total of each wagon in one call, instead of one call per hold.
+   */
+  class TrainHolds {
+    private:
+      /// @brief Seats taken by a pending hold.
+      struct Hold {
+        int wagon = -1;      // Индекс вагона
+        int passengers = 0;  // Число удерживаемых мест
+      };
+
+      Train train;                 // Поезд; удерживаемые места в нем уже заняты
+      TimingWheel<Hold> wheel;     // Сроки истечения неподтвержденных удержаний
+      int64_t heldSeats = 0;       // Число мест под неподтвержденными удержаниями
+      std::vector<Hold> expired;   // Буфер истекших удержаний, переиспользуется между вызовами
+      std::vector<int> released;   // Освобождаемые места каждого вагона при пакетной обработке
+
+    public:
+      /**
+       * @brief Constructor.
+       *
+       * @param train The train; its occupied seats are confirmed.
+       * @param start The current time in milliseconds.
+       * @throws std::invalid_argument if the time is negative.
+       */
+      explicit TrainHolds(const Train& train, int64_t start = 0);
+
+      /**
+       * @brief Get the train.
+       *
+       * @return The train, with held seats counted as occupied.
+       */
+      const Train& getTrain() const;
+
+      /**
+       * @brief Get the current time.
+       *
+       * @return The time in milliseconds.
+       */
+      int64_t getTime() const;
+
+      /**
+       * @brief Get the number of pending holds.
+       *
+       * @return The number of holds neither confirmed, released nor expired.
+       */
+      size_t getActiveHoldCount() const;
+
+      /**
+       * @brief Get the number of seats under pending holds.
+       *
+       * @return The number of seats.
+       */
+      int64_t getHeldSeats() const;
+
+      /**
+       * @brief Hold seats in the wagon boardPassengersToMostAvailableWagon chooses.
+       *
+       * @param passengers The number of passengers, positive.
+       * @param wagonType The class of wagon.
+       * @param ttl How long the hold lasts unless confirmed, in milliseconds, positive.
+       * @return The id of the hold.
+       * @throws std::invalid_argument if the count or the ttl is invalid, or no wagon can take the passengers.
+       */
+      HoldId hold(int passengers, WagonType wagonType, int64_t ttl);
+
+      /**
+       * @brief Confirm a hold; its seats stay occupied for good.
+       *
+       * @param id The id of the hold.
+       * @return False if the hold has already expired, been confirmed or been released.
+       */
+      bool confirm(HoldId id);
+
+      /**
+       * @brief Release a hold before it expires and free its seats.
+       *
+       * @param id The id of the hold.
+       * @return False if the hold has already expired, been confirmed or been released.
+       */
+      bool release(HoldId id);
+
+      /**
+       * @brief Move the clock forward and free the seats of every hold that expires.
+       *
+       * @param now The new time in milliseconds.
+       * @return The number of holds that expired.
+       * @throws std::invalid_argument if the time goes backwards.
+       */
+      size_t advanceTo(int64_t now);
+  };
+
+} // namespace lab2ComplexClass
+
+#endif // TRAIN_HOLDS_H
@@ -0,0 +1,202 @@
+#ifndef TRAIN_STORAGE_H
+#define TRAIN_STORAGE_H
+
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+
+namespace lab2ComplexClass {
+
+  /*
+   * Storage policies of BasicTrain.
+   *
+   * A policy is a type with a member template For<WagonT>; the train keeps one For<WagonT> object and
+   * obtains every wagon array from it. For<WagonT> provides:
+   *
+   *   static constexpr int INLINE_CAPACITY   - number of wagons kept inside the train object (0 if none);
+   *   static constexpr bool NOTHROW_TRANSFER - whether moving a train never allocates;
+   *   WagonT* allocate(int& capacity)        - uninitialized storage for at least capacity wagons, capacity is
+   *                                            updated to what the storage actually holds;
+   *   void deallocate(WagonT*, int capacity) - release storage returned by allocate (nullptr is ignored);
+   *   bool isInline(const WagonT*) const     - whether the array lives inside the train object;
+   *   bool canAdopt(const For& other) const  - whether this storage can release an array allocated by other.
+   *
+   * Copying a For object gives a storage with the same source of memory but none of the arrays: an inline
+   * buffer is never shared. The train only requests an array of at most INLINE_CAPACITY wagons when its
+   * current array is not inline, so the inline buffer holds at most one array at a time.
+   */
+
+  /**
+   * @brief Storage policy that allocates every wagon array from the global heap.
+   */
+  struct HeapStorage {
+    template <typename WagonT>
+    class For {
+      public:
+        static constexpr int INLINE_CAPACITY = 0;     ///< No wagons inside the train object.
+        static constexpr bool NOTHROW_TRANSFER = true; ///< Moving always takes over the array.
+
+        /// @brief Allocate uninitialized storage from the global heap.
+        /// @param capacity The number of wagons; unchanged.
+        /// @return The storage.
+        WagonT* allocate(int& capacity) {
+          return static_cast<WagonT*>(::operator new(static_cast<size_t>(capacity) * sizeof(WagonT)));
+        }
+
+        /// @brief Release storage returned by allocate.
+        void deallocate(WagonT* wagons, int) noexcept { ::operator delete(wagons); }
+
+        /// @brief Heap arrays are never inline.
+        bool isInline(const WagonT*) const noexcept { return false; }
+
+        /// @brief Every heap array can be released by any heap storage.
+        bool canAdopt(const For&) const noexcept { return true; }
+    };
+  };
+
+  /**
+   * @brief Storage policy that keeps up to N wagons inside the train object and spills to the heap beyond that.
+   *
+   * Short trains need no allocation at all; moving a train whose wagons are inline relocates them.
+   */
+  template <int N>
+  struct SmallBufferStorage {
+    static_assert(N > 0, "SmallBufferStorage must hold at least one wagon");
+
+    template <typename WagonT>
+    class For {
+      private:
+        alignas(WagonT) unsigned char buffer[N * sizeof(WagonT)]; // Встроенный буфер на N вагонов
+
+        WagonT* inlineSlots() noexcept { return reinterpret_cast<WagonT*>(buffer); }
+        const WagonT* inlineSlots() const noexcept { return reinterpret_cast<const WagonT*>(buffer); }
+
+      public:
+        static constexpr int INLINE_CAPACITY = N;      ///< Wagons kept inside the train object.
+        static constexpr bool NOTHROW_TRANSFER = true; ///< Inline wagons always fit into the inline buffer of the target.
+
+        For() noexcept {}
+        For(const For&) noexcept {}
+        For& operator=(const For&) noexcept { return *this; }
+
+        /// @brief Use the inline buffer for up to N wagons, the heap otherwise.
+        /// @param capacity The number of wagons; raised to N when the inline buffer is used.
+        /// @return The storage.
+        WagonT* allocate(int& capacity) {
+          if (capacity <= N) {
+            capacity = N;
+            return inlineSlots();
+          }
+          return static_cast<WagonT*>(::operator new(static_cast<size_t>(capacity) * sizeof(WagonT)));
+        }
+
+        /// @brief Release storage returned by allocate.
+        void deallocate(WagonT* wagons, int) noexcept {
+          if (!isInline(wagons)) {
+            ::operator delete(wagons);
+          }
+        }
+
+        /// @brief Check whether the array is the inline buffer.
+        bool isInline(const WagonT* wagons) const noexcept { return wagons == inlineSlots(); }
+
+        /// @brief Spilled arrays come from the global heap and can be released by any storage of this kind.
+        bool canAdopt(const For&) const noexcept { return true; }
+    };
+  };
+
+  /**
+   * @brief Storage policy with a fixed inline capacity of N wagons and no heap allocation at all.
+   *
+   * Growing past N wagons throws std::length_error.
+   */
+  template <int N>
+  struct FixedStorage {
+    static_assert(N > 0, "FixedStorage must hold at least one wagon");
+
+    template <typename WagonT>
+    class For {
+      private:
+        alignas(WagonT) unsigned char buffer[N * sizeof(WagonT)]; // Встроенный буфер на N вагонов
+
+        WagonT* inlineSlots() noexcept { return reinterpret_cast<WagonT*>(buffer); }
+        const WagonT* inlineSlots() const noexcept { return reinterpret_cast<const WagonT*>(buffer); }
+
+      public:
+        static constexpr int INLINE_CAPACITY = N;      ///< Wagons kept inside the train object.
+        static constexpr bool NOTHROW_TRANSFER = true; ///< A train never holds more than N wagons.
+
+        For() noexcept {}
+        For(const For&) noexcept {}
+        For& operator=(const For&) noexcept { return *this; }
+
+        /// @brief Use the inline buffer.
+        /// @param capacity The number of wagons; raised to N.
+        /// @return The storage.
+        /// @throws std::length_error if more than N wagons are requested.
+        WagonT* allocate(int& capacity) {
+          if (capacity > N) {
+            throw std::length_error("Train with fixed storage is full.");
+          }
+          capacity = N;
+          return inlineSlots();
+        }
+
+        /// @brief Nothing to release.
+        void deallocate(WagonT*, int) noexcept {}
+
+        /// @brief Check whether the array is the inline buffer.
+        bool isInline(const WagonT* wagons) const noexcept { return wagons == inlineSlots(); }
+
+        /// @brief Only an empty train is ever adopted, and it owns no storage.
+        bool canAdopt(const For&) const noexcept { return true; }
+    };
+  };
+
+  /**
+   * @brief Storage policy that allocates wagon arrays from a polymorphic memory resource.
+   *
+   * With a std::pmr::monotonic_buffer_resource a batch of trains is carved out of one arena and released at
+   * once. Only the wagon arrays come from the resource; the dirty-wagon bitset stays on the global heap.
+   */
+  struct ArenaStorage {
+    template <typename WagonT>
+    class For {
+      private:
+        std::pmr::memory_resource* resource; // Источник памяти для массивов вагонов
+
+      public:
+        static constexpr int INLINE_CAPACITY = 0;       ///< No wagons inside the train object.
+        static constexpr bool NOTHROW_TRANSFER = false; ///< Moving between different resources copies the wagons.
+
+        /// @brief Use the given resource, the default resource if none is given.
+        For(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) noexcept : resource(resource) {}
+
+        /// @brief Allocate uninitialized storage from the resource.
+        /// @param capacity The number of wagons; unchanged.
+        /// @return The storage.
+        WagonT* allocate(int& capacity) {
+          return static_cast<WagonT*>(resource->allocate(static_cast<size_t>(capacity) * sizeof(WagonT), alignof(WagonT)));
+        }
+
+        /// @brief Return storage to the resource.
+        void deallocate(WagonT* wagons, int capacity) noexcept {
+          if (wagons != nullptr) {
+            resource->deallocate(wagons, static_cast<size_t>(capacity) * sizeof(WagonT), alignof(WagonT));
+          }
+        }
+
+        /// @brief Arena arrays are never inline.
+        bool isInline(const WagonT*) const noexcept { return false; }
+
+        /// @brief An array can only be released by an equal resource.
+        bool canAdopt(const For& other) const noexcept { return resource->is_equal(*other.resource); }
+
+        /// @brief Get the memory resource.
+        std::pmr::memory_resource* getResource() const noexcept { return resource; }
+    };
+  };
+
+} // namespace lab2ComplexClass
+
+#endif // TRAIN_STORAGE_H
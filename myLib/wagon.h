@@ -1,17 +1,73 @@
 #ifndef WAGON_H
 #define WAGON_H
 
+#include <array>
 #include <cstring>
 #include <iostream>
 #include <limits>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include "instrumentation.h"
 
 namespace lab2SimpleClass {
   
   /// @brief Enumeration for wagon types.
   enum class WagonType { SITTING, ECONOMY, LUXURY, RESTAURANT };
 
+  /// @brief Number of wagon types in WagonType.
+  constexpr int WAGON_TYPE_COUNT = 4;
+
+  /// @brief Compile-time properties of a wagon type.
+  struct WagonTypeTraits {
+    int defaultCapacity;      ///< Capacity of a wagon created by Wagon(WagonType) or converted by setType.
+    bool canBoard;            ///< Whether wagons of the type carry passengers.
+    bool checksLoadOnRetype;  ///< Whether setType to the type rejects a load above its default capacity.
+    int serialCode;           ///< Code of the type in the stream formats.
+    const char* displayName;  ///< Human-readable name.
+  };
+
+  /// @brief Traits of every wagon type, indexed by WagonType. Adding a wagon type means adding a row here.
+  inline constexpr std::array<WagonTypeTraits, WAGON_TYPE_COUNT> WAGON_TYPE_TRAITS = {{
+    {100, true, false, 0, "sitting"},
+    {50, true, true, 1, "economy"},
+    {30, true, true, 2, "luxury"},
+    {0, false, false, 3, "restaurant"},
+  }};
+
+  /// @brief Get the traits of a wagon type.
+  /// @param type The wagon type.
+  /// @return The traits.
+  constexpr const WagonTypeTraits& wagonTypeTraits(WagonType type) { return WAGON_TYPE_TRAITS[static_cast<int>(type)]; }
+
+  /// @brief Find the wagon type with a serialization code.
+  /// @param serialCode The code read from a stream.
+  /// @param type The found type.
+  /// @return True if the code belongs to a wagon type.
+  constexpr bool wagonTypeFromSerialCode(int serialCode, WagonType& type) {
+    for (int i = 0; i < WAGON_TYPE_COUNT; i++) {
+      if (WAGON_TYPE_TRAITS[i].serialCode == serialCode) {
+        type = static_cast<WagonType>(i);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  class Wagon;
+
+  /// @brief Write a wagon as one "type capacity occupied" record, the line format of traces, checkpoints and dumps.
+  /// @param os The output stream.
+  /// @param wagon The wagon to write.
+  /// @return The output stream.
+  std::ostream& writeWagonRecord(std::ostream& os, const Wagon& wagon);
+
+  /// @brief Read a wagon written by writeWagonRecord.
+  /// @param is The input stream.
+  /// @param wagon The wagon to read into; left unchanged on failure.
+  /// @return The input stream; failbit is set on an unknown type or a wagon the constructor rejects.
+  std::istream& readWagonRecord(std::istream& is, Wagon& wagon);
+
   /// @brief Class representing a train wagon.
   class Wagon {
   private:
@@ -24,70 +80,82 @@ namespace lab2SimpleClass {
     /// @brief Equality operator for comparing two wagon objects.
     /// @param other The other wagon to compare to.
     /// @return True if the wagons are equal, false otherwise.
-    bool operator==(const Wagon& other) const;
+    constexpr bool operator==(const Wagon& other) const;
 
-    /// @brief Assignment operator overload for the Wagon class. This operator allows copying the data from another Wagon object.
-    /// @param other The Wagon object to be copied.
+    /// @brief Default constructor (implicit constructor).
+    constexpr Wagon();
+
+    /// @brief Copy constructor. Trivial, so wagon arrays can be relocated with memcpy.
+    Wagon(const Wagon&) noexcept = default;
+
+    /// @brief Move constructor. Trivial, identical to copying.
+    Wagon(Wagon&&) noexcept = default;
+
+    /// @brief Copy assignment operator. Trivial, so wagon arrays can be relocated with memcpy.
     /// @return A reference to the current Wagon object.
-    Wagon& operator=(const Wagon& other);
+    Wagon& operator=(const Wagon&) noexcept = default;
 
-    /// @brief Default constructor (implicit constructor).
-    Wagon();
+    /// @brief Move assignment operator. Trivial, identical to copying.
+    /// @return A reference to the current Wagon object.
+    Wagon& operator=(Wagon&&) noexcept = default;
+
+    /// @brief Destructor. Trivial.
+    ~Wagon() = default;
 
     /// @brief Constructor with parameters.
     /// @param maxCapacity Maximum capacity of the wagon.
     /// @param occupiedSeats Number of currently occupied seats.
     /// @param type Type of the wagon.
-    Wagon(int maxCapacity, int occupiedSeats, WagonType type);
+    constexpr Wagon(int maxCapacity, int occupiedSeats, WagonType type);
 
     /// @brief Constructor with initialization of only the type.
     /// @param type Type of the wagon.
-    Wagon(WagonType type);
+    constexpr Wagon(WagonType type);
 
     /// @brief Get the percentage of occupancy of the wagon.
     /// @return The percentage of occupancy.
-    double getOccupancyPercentage() const;
+    constexpr double getOccupancyPercentage() const;
 
     /// @brief Board a specified number of passengers into the wagon.
     /// @param passengers Number of passengers to board.
-    void boardPassengers(int passengers);
+    constexpr void boardPassengers(int passengers);
 
     /// @brief Disembark a specified number of passengers from the wagon.
     /// @param passengers Number of passengers to disembark.
-    void disembarkPassengers(int passengers);
+    constexpr void disembarkPassengers(int passengers);
 
     /// @brief Get the maximum capacity of the wagon.
     /// @return Maximum capacity.
-    int getMaxCapacity() const;
+    constexpr int getMaxCapacity() const;
 
     /// @brief Get the number of currently occupied seats in the wagon.
     /// @return Number of occupied seats.
-    int getOccupiedSeats() const;
+    constexpr int getOccupiedSeats() const;
 
     /// @brief Get the type of the wagon.
     /// @return Type of the wagon.
-    WagonType getType() const;
+    constexpr WagonType getType() const;
 
     /// @brief Set the maximum capacity of the wagon.
     /// @param capacity Maximum capacity to set.
-    void setMaxCapacity(int capacity);
+    constexpr void setMaxCapacity(int capacity);
 
     /// @brief Set the number of currently occupied seats in the wagon.
     /// @param seats Number of occupied seats to set.
-    void setOccupiedSeats(int seats);
+    constexpr void setOccupiedSeats(int seats);
 
     /// @brief Set the type of the wagon.
     /// @param wagonType Type of the wagon to set.
-    void setType(WagonType wagonType);
+    constexpr void setType(WagonType wagonType);
 
     /// @brief Transfer passengers from the current wagon to another wagon.
     /// @param otherWagon The target wagon for passenger transfer.
-    void transferPassengers(Wagon &otherWagon);
+    constexpr void transferPassengers(Wagon &otherWagon);
 
     /// @brief Overloaded operator for transferring passengers from one wagon to another.
     /// @param other The target wagon for passenger transfer.
     /// @return Reference to the current wagon.
-    Wagon &operator>>(Wagon &other);
+    constexpr Wagon &operator>>(Wagon &other);
 
     /// @brief Friend function to overload the input stream operator (>>).
     /// @param is Input stream.
@@ -102,6 +170,260 @@ namespace lab2SimpleClass {
     friend std::ostream& operator<<(std::ostream& os, const Wagon& wagon);
   };
 
+  // Train relies on this to relocate wagon arrays without constructing or assigning element by element
+  static_assert(std::is_trivially_copyable_v<Wagon>, "Wagon must stay trivially copyable");
+
+  // Все операции, кроме потокового ввода-вывода, определены здесь, чтобы быть доступными в constexpr-контексте
+
+  /** @brief Equality operator for comparing two wagon objects.
+  *
+  * @param other The other wagon to compare to.
+  *
+  * @return True if the wagons are equal, false otherwise.
+  */
+  constexpr bool Wagon::operator==(const Wagon& other) const {
+    return (maxCapacity == other.maxCapacity && occupiedSeats == other.occupiedSeats && type == other.type);
+  }
+  
+  /**
+   * @brief Default constructor for the Wagon class.
+   *
+   * This constructor initializes a Wagon object with default values:
+   * - Maximum capacity is set to 0.
+   * - Occupied seats are set to 0.
+   * - The wagon type is set to RESTAURANT.
+   */
+  constexpr Wagon::Wagon() : maxCapacity(0), occupiedSeats(0), type(WagonType::RESTAURANT) {}
+
+  /**
+   * @brief Constructor with parameters for the Wagon class.
+   *
+   * This constructor allows you to create a Wagon object with specified parameters.
+   *
+   * @param maxCapacity The maximum capacity of the wagon.
+   * @param occupiedSeats The number of occupied seats in the wagon.
+   * @param type The type of the wagon (e.g., SITTING, ECONOMY, LUXURY, RESTAURANT).
+   *
+   * @throw std::invalid_argument if the type is set to RESTAURANT, as restaurant wagons cannot have capacity or occupied seats.
+   */
+  constexpr Wagon::Wagon(int maxCapacit, int occupiedSeat, WagonType type) : type(type) {
+    if (!wagonTypeTraits(type).canBoard) {
+      occupiedSeats = 0;
+      maxCapacity = 0;
+    } else {
+      if (occupiedSeat > maxCapacit || occupiedSeat < 0 || maxCapacit < 0) {
+        throw std::invalid_argument("Occupied seats cannot exceed max capacity.");
+      }
+      occupiedSeats = occupiedSeat;
+      maxCapacity = maxCapacit;
+    }
+  }
+
+  /**
+   * @brief Constructor with type initialization for the Wagon class.
+   *
+   * This constructor allows you to create a Wagon object with an initial type. The constructor
+   * automatically sets the maximum capacity and occupied seats based on the specified type.
+   *
+   * @param type The type of the wagon (e.g., SITTING, ECONOMY, LUXURY, RESTAURANT).
+   */
+  constexpr Wagon::Wagon(WagonType type)
+      : maxCapacity(wagonTypeTraits(type).defaultCapacity), occupiedSeats(0), type(type) {}
+
+  /**
+   * @brief Get the occupancy percentage of the wagon.
+   *
+   * This method calculates the percentage of occupied seats in the wagon based on its maximum capacity.
+   *
+   * @return The occupancy percentage as a double value. If the wagon is a restaurant, the occupancy percentage is always 0%.
+   */
+  constexpr double Wagon::getOccupancyPercentage() const {
+    if (maxCapacity == 0) {
+      return 0.0; // If the wagon is a restaurant, occupancy is always 0%.
+    }
+    return static_cast<double>(occupiedSeats) / maxCapacity * 100.0;
+  }
+
+  /**
+   * @brief Board a specified number of passengers into the wagon.
+   *
+   * This method allows you to board a certain number of passengers into the wagon, but only if the wagon is not a restaurant and has available capacity.
+   *
+   * @param passengers The number of passengers to board.
+   *
+   * @throw std::invalid_argument if the wagon is full and cannot board more passengers.
+   */
+  constexpr void Wagon::boardPassengers(int passengers) {
+    TRAIN_INSTR_OP(WAGON_BOARD);
+    if (passengers < 0) {
+      throw std::invalid_argument("Cannot board negative number of passengers");
+    }
+    if (maxCapacity != 0) {
+      if (occupiedSeats + passengers > maxCapacity) {
+        throw std::invalid_argument("Wagon is full. Cannot board more passengers.");
+      }
+      occupiedSeats += passengers;
+    } else {
+      throw std::invalid_argument("Cannot board to Restaurant");
+    }
+  }
+
+  /**
+   * @brief Disembark passengers from the wagon.
+   *
+   * This method is used to disembark a specified number of passengers from the wagon.
+   * It checks if there are enough passengers in the wagon to disembark and then updates the count of occupied seats accordingly.
+   *
+   * @param passengers The number of passengers to disembark.
+   *
+   * @throws std::invalid_argument If there are not enough passengers in the wagon to disembark.
+   */
+  constexpr void Wagon::disembarkPassengers(int passengers) {
+    TRAIN_INSTR_OP(WAGON_DISEMBARK);
+    if (passengers < 0) {
+      throw std::invalid_argument("Cannot disembark negative number of passengers");
+    }
+    if (maxCapacity != 0) {
+      if (occupiedSeats - passengers < 0) {
+        throw std::invalid_argument("There are not enough people in the Wagon to disembark.");
+      }
+      occupiedSeats -= passengers;
+    } else {
+      throw std::invalid_argument("Cannot disembark from Restaurant");
+    }
+  }
+
+  /**
+   * @brief Get the maximum capacity of the wagon.
+   *
+   * @return The maximum capacity of the wagon as an integer.
+   */
+  constexpr int Wagon::getMaxCapacity() const { return maxCapacity; }
+
+  /**
+   * @brief Get the number of occupied seats in the wagon.
+   *
+   * @return The number of occupied seats in the wagon as an integer.
+   */
+  constexpr int Wagon::getOccupiedSeats() const { return occupiedSeats; }
+
+  /**
+   * @brief Get the type of the wagon.
+   *
+   * @return The type of the wagon (e.g., SITTING, ECONOMY, LUXURY, RESTAURANT) as a WagonType enum.
+   */
+  constexpr WagonType Wagon::getType() const { return type; }
+
+  /**
+   * @brief Set the maximum capacity of the wagon.
+   *
+   * This method allows you to set the maximum capacity of the wagon, but it must not be negative and must not be less than the number of occupied seats.
+   *
+   * @param capacity The new maximum capacity for the wagon.
+   *
+   * @throw std::invalid_argument if the capacity is negative or less than the number of occupied seats.
+   */
+  constexpr void Wagon::setMaxCapacity(int capacity) {
+    TRAIN_INSTR_OP(WAGON_SET_MAX_CAPACITY);
+    if (!wagonTypeTraits(type).canBoard) {
+      throw std::invalid_argument("Can't set maxcapacity in restaurant wagon");
+    }
+    if (capacity < 0 || occupiedSeats > capacity) {
+      throw std::invalid_argument("Max capacity cannot be negative or cannot be less than occupied seats.");
+    }
+    maxCapacity = capacity;
+  }
+
+  /**
+   * @brief Set the number of occupied seats in the wagon.
+   *
+   * This method allows you to set the number of occupied seats in the wagon, but it must not be negative and must not exceed the maximum capacity of the wagon.
+   *
+   * @param seats The new number of occupied seats.
+   *
+   * @throw std::invalid_argument if the number of occupied seats is negative or exceeds the maximum capacity.
+   */
+  constexpr void Wagon::setOccupiedSeats(int seats) {
+    TRAIN_INSTR_OP(WAGON_SET_OCCUPIED_SEATS);
+    if (!wagonTypeTraits(type).canBoard) {
+      throw std::invalid_argument("Can't set occupied seats in restaurant wagon");
+    }
+    if (seats < 0 || seats > maxCapacity) {
+      throw std::invalid_argument("Invalid number of occupied seats.");
+    }
+    occupiedSeats = seats; 
+  }
+
+  /**
+   * @brief Set the type of the wagon.
+   *
+   * The wagon takes the default capacity of the new type from WAGON_TYPE_TRAITS, and all of its seats count as occupied.
+   *
+   * @param wagonType The new type of the wagon.
+   *
+   * @throw std::invalid_argument if the new type checks the load on retype and its default capacity is less than the current number of passengers.
+   */
+  constexpr void Wagon::setType(WagonType wagonType) {
+    TRAIN_INSTR_OP(WAGON_SET_TYPE);
+    const WagonTypeTraits& traits = wagonTypeTraits(wagonType);
+    if (traits.checksLoadOnRetype && this->getOccupiedSeats() > traits.defaultCapacity) {
+      throw std::invalid_argument("Cann't change type");
+    }
+    occupiedSeats = traits.defaultCapacity;
+    maxCapacity = traits.defaultCapacity;
+    type = wagonType;
+  }
+  
+  /**
+   * @brief Transfer passengers from the current wagon to another wagon.
+   *
+   * This method allows the transfer of passengers between two wagons with the same type. The number of passengers to transfer is determined based on the average occupancy percentage of both wagons.
+   *
+   * @param otherWagon The wagon to which passengers are transferred.
+   *
+   * @throw std::invalid_argument if either of the wagons is a restaurant wagon or if the wagon types do not match.
+   */
+  constexpr void Wagon::transferPassengers(Wagon &otherWagon) {
+    TRAIN_INSTR_OP(WAGON_TRANSFER);
+    if (!wagonTypeTraits(type).canBoard || !wagonTypeTraits(otherWagon.getType()).canBoard) {
+      throw std::invalid_argument("Passengers cannot be transferred to or from a restaurant wagon.");
+    }
+    if (getType() != otherWagon.getType()) {
+      throw std::invalid_argument("Incorrect type of wagons");
+    } else {
+      int totalOccupiedSeats = occupiedSeats + otherWagon.getOccupiedSeats();
+      int totalMaxCapacity = maxCapacity + otherWagon.getMaxCapacity();
+
+       // Calculate the average occupancy percentage
+      double occupancyPercentageMid = static_cast<double>(totalOccupiedSeats) / totalMaxCapacity;
+      
+      // Calculate the number of passengers to transfer based on the occupancy percentage
+      int passengersThis = static_cast<int>(occupancyPercentageMid * maxCapacity);
+      int passengersOther = static_cast<int>(occupancyPercentageMid * otherWagon.maxCapacity);
+
+      // Update the number of occupied seats in both wagons
+      setOccupiedSeats(passengersThis);
+      otherWagon.setOccupiedSeats(passengersOther);
+    }
+  }
+
+ /**
+ * @brief Overloaded operator for transferring passengers from one wagon to another.
+ *
+ * This operator allows the transfer of passengers from the current wagon to another wagon using the `>>` operator.
+ * It is a shorthand for calling the `transferPassengers` method.
+ *
+ * @param other The wagon to which passengers are transferred.
+ *
+ * @return A reference to the current wagon after the passengers have been transferred.
+ *
+ * @throw std::invalid_argument if either of the wagons is a restaurant wagon or if the wagon types do not match.
+ */
+  constexpr Wagon &Wagon::operator >>(Wagon &other) {
+    this->transferPassengers(other);
+    return *this;
+  }
+
 } // namespace lab2SimpleClass
 
 #endif // WAGON_H
@@ -1,9 +1,34 @@
 #define CATCH_CONFIG_MAIN
+#include "../myLib/checkpoint.h"
+#include "../myLib/cow_train.h"
+#include "../myLib/demand_forecast.h"
+#include "../myLib/fleet_index.h"
+#include "../myLib/fleet_operations.h"
 #include "../myLib/getnum.h"
+#include "../myLib/instrumentation.h"
+#include "../myLib/memory_report.h"
+#include "../myLib/min_cost_flow.h"
+#include "../myLib/packed_train.h"
+#include "../myLib/persistent_train.h"
+#include "../myLib/random_stream.h"
+#include "../myLib/rebalancing.h"
+#include "../myLib/replay.h"
+#include "../myLib/route_reservations.h"
+#include "../myLib/seat_map.h"
+#include "../myLib/simulation.h"
+#include "../myLib/static_train.h"
+#include "../myLib/timing_wheel.h"
 #include "../myLib/train.h"
+#include "../myLib/train_holds.h"
 #include "../myLib/wagon.h"
 #include <catch2/catch.hpp>
+#include <algorithm>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <set>
 #include <sstream>
+#include <thread>
 
 using namespace lab2ComplexClass;
 using namespace lab2SimpleClass;
@@ -392,6 +417,25 @@ TEST_CASE("Wagon output operator test", "[Wagon]") {
     REQUIRE(output.str() == expectedOutput);
 }
 
+TEST_CASE("Wagon records round-trip through one line", "[Wagon]") {
+    std::ostringstream output;
+    writeWagonRecord(output, Wagon(50, 20, WagonType::ECONOMY));
+    REQUIRE(output.str() == "1 50 20\n");
+
+    Wagon wagon;
+    std::istringstream input(output.str());
+    REQUIRE_FALSE(readWagonRecord(input, wagon).fail());
+    REQUIRE(wagon == Wagon(50, 20, WagonType::ECONOMY));
+
+    SECTION("An unknown type or an overfull wagon fails the stream and keeps the wagon") {
+        std::istringstream unknown("9 50 20\n");
+        REQUIRE(readWagonRecord(unknown, wagon).fail());
+        std::istringstream overfull("1 50 60\n");
+        REQUIRE(readWagonRecord(overfull, wagon).fail());
+        REQUIRE(wagon == Wagon(50, 20, WagonType::ECONOMY));
+    }
+}
+
 TEST_CASE("Default Constructor for Train") {
     Train train;
     REQUIRE(train.getNumWagons() == 0);
@@ -965,3 +1009,1707 @@ TEST_CASE("Train::operator<< (output stream operator)", "[Train]") {
     // Проверьте, что данные были выведены корректно
     REQUIRE(trainOutput == "3\n200\n100\n1\n150\n70\n0\n50\n10\n2\n");
 }
+
+TEST_CASE("Train dirty wagon tracking", "[Train][checkpoint]") {
+    Train train;
+    train += Wagon(200, 100, WagonType::ECONOMY);
+    train += Wagon(150, 70, WagonType::SITTING);
+    train += Wagon(50, 10, WagonType::LUXURY);
+    train.clearDirty();
+
+    SECTION("A clean train has no dirty wagons") {
+        REQUIRE(train.getDirtyCount() == 0);
+        REQUIRE_FALSE(train.isWagonDirty(0));
+    }
+
+    SECTION("Boarding marks only the boarded wagon") {
+        train.boardPassengersToMostAvailableWagon(5, WagonType::SITTING);
+        REQUIRE(train.getDirtyCount() == 1);
+        REQUIRE(train.isWagonDirty(1));
+    }
+
+    SECTION("Non-const operator[] marks the accessed wagon") {
+        train[2].disembarkPassengers(5);
+        REQUIRE(train.getDirtyCount() == 1);
+        REQUIRE(train.isWagonDirty(2));
+    }
+
+    SECTION("Structural changes mark the shifted tail") {
+        train.removeWagonByIndex(1);
+        REQUIRE(train.getDirtyCount() == 1);
+        REQUIRE(train.isWagonDirty(1));
+        REQUIRE_FALSE(train.isWagonDirty(0));
+    }
+
+    SECTION("Const access does not mark anything") {
+        const Train& constTrain = train;
+        REQUIRE(constTrain[0].getOccupiedSeats() == 100);
+        REQUIRE(train.getDirtyCount() == 0);
+    }
+
+    SECTION("Redistributing marks only the wagons whose load changes") {
+        Train balanced;
+        balanced += Wagon(200, 100, WagonType::ECONOMY);
+        balanced += Wagon(100, 50, WagonType::ECONOMY);
+        balanced += Wagon(50, 10, WagonType::LUXURY);
+        balanced.clearDirty();
+        balanced.redistributePassengers();
+        REQUIRE(balanced.getDirtyCount() == 0);
+
+        balanced[1].disembarkPassengers(20);
+        balanced.clearDirty();
+        balanced.redistributePassengers();
+        REQUIRE(balanced.getDirtyCount() == 2);
+        REQUIRE_FALSE(balanced.isWagonDirty(2));
+    }
+}
+
+TEST_CASE("CheckpointWriter writes deltas and compacts into snapshots", "[checkpoint]") {
+    Train fleet[2];
+    fleet[0] += Wagon(200, 100, WagonType::ECONOMY);
+    fleet[0] += Wagon(150, 70, WagonType::SITTING);
+    fleet[1] += Wagon(50, 10, WagonType::LUXURY);
+
+    std::stringstream log;
+    CheckpointWriter writer(log, 2);
+    std::vector<Train> restored;
+
+    REQUIRE(writer.writeCheckpoint(fleet, 2));
+    REQUIRE(fleet[0].getDirtyCount() == 0);
+
+    fleet[0][1].boardPassengers(10);
+    fleet[1] += Wagon(WagonType::ECONOMY);
+    REQUIRE_FALSE(writer.writeCheckpoint(fleet, 2));
+
+    fleet[0].removeWagonByIndex(1);
+    REQUIRE_FALSE(writer.writeCheckpoint(fleet, 2));
+
+    // The compaction interval is reached: a full snapshot is written again
+    REQUIRE(writer.writeCheckpoint(fleet, 2));
+
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(readCheckpoint(log, restored));
+        REQUIRE(restored.size() == 2);
+    }
+
+    for (int i = 0; i < 2; i++) {
+        REQUIRE(restored[i].getNumWagons() == fleet[i].getNumWagons());
+        for (int j = 0; j < fleet[i].getNumWagons(); j++) {
+            const Train& expected = fleet[i];
+            const Train& actual = restored[i];
+            REQUIRE(actual[j] == expected[j]);
+        }
+    }
+
+    SECTION("Deltas contain only the changed wagons") {
+        std::stringstream deltaLog;
+        CheckpointWriter deltaWriter(deltaLog, 100);
+        deltaWriter.writeCheckpoint(fleet, 2);
+        deltaLog.str("");
+        fleet[1][1].boardPassengers(3);
+        REQUIRE_FALSE(deltaWriter.writeCheckpoint(fleet, 2));
+        REQUIRE(deltaLog.str() == "D 2 1\n1 2 1\n1 1 50 3\n");
+    }
+}
+
+TEST_CASE("Trace input operator", "[replay]") {
+    SECTION("Valid trace") {
+        std::istringstream iss("2\n1 200 100\n0 150 70\nB 1 5\nD 1 10\nA 2 30 0\nI 0 3 0 0\nR 0\nS\nO\nP\n");
+        Trace trace;
+        REQUIRE(iss >> trace);
+        REQUIRE(trace.initial.getNumWagons() == 2);
+        REQUIRE(trace.ops.size() == 8);
+        REQUIRE(trace.ops[0].type == TraceOpType::BOARD);
+        REQUIRE(trace.ops[0].wagonType == WagonType::ECONOMY);
+        REQUIRE(trace.ops[0].passengers == 5);
+        REQUIRE(trace.ops[2].wagon == Wagon(30, 0, WagonType::LUXURY));
+        REQUIRE(trace.ops[3].index == 0);
+        REQUIRE(trace.ops[7].type == TraceOpType::RESTAURANT_PLACEMENT);
+    }
+
+    SECTION("Unknown operation") {
+        std::istringstream iss("0\nX\n");
+        Trace trace;
+        iss >> trace;
+        REQUIRE(iss.fail());
+    }
+}
+
+TEST_CASE("replayTrace reports latencies and the final state", "[replay]") {
+    std::istringstream iss("2\n1 200 100\n0 150 70\nB 1 5\nB 1 5\nB 2 5\nD 1 10\nA 2 30 0\n");
+    Trace trace;
+    REQUIRE(iss >> trace);
+
+    Train train;
+    ReplayReport report = replayTrace(trace, train);
+
+    REQUIRE(report.totalOps == 5);
+    REQUIRE(report.ops[static_cast<int>(TraceOpType::BOARD)].count == 3);
+    REQUIRE(report.ops[static_cast<int>(TraceOpType::BOARD)].failures == 1); // no LUXURY wagon yet
+    REQUIRE(report.ops[static_cast<int>(TraceOpType::BOARD)].p50 <= report.ops[static_cast<int>(TraceOpType::BOARD)].p999);
+    REQUIRE(report.ops[static_cast<int>(TraceOpType::OPTIMIZE)].count == 0);
+    REQUIRE(report.getThroughput() > 0.0);
+
+    Wagon expected[3] = {Wagon(200, 110, WagonType::ECONOMY), Wagon(150, 60, WagonType::SITTING), Wagon(30, 0, WagonType::LUXURY)};
+    Train reference(expected, 3);
+    REQUIRE(findFirstDifference(train, reference) == -1);
+
+    reference.removeWagonByIndex(2);
+    REQUIRE(findFirstDifference(train, reference) == 2);
+
+    std::ostringstream oss;
+    oss << report;
+    REQUIRE(oss.str().find("board") != std::string::npos);
+}
+
+TEST_CASE("nearestRankPercentile takes the sample of rank ceil(f * n)", "[replay]") {
+    REQUIRE(nearestRankPercentile({}, 0.5) == 0);
+    REQUIRE(nearestRankPercentile({7}, 0.0) == 7);
+    REQUIRE(nearestRankPercentile({7}, 1.0) == 7);
+    REQUIRE(nearestRankPercentile({1, 2}, 0.5) == 1);
+    REQUIRE(nearestRankPercentile({1, 2}, 0.51) == 2);
+    REQUIRE(nearestRankPercentile({1, 2, 3}, 0.5) == 2);
+
+    std::vector<int64_t> samples(100);
+    std::iota(samples.begin(), samples.end(), 1);
+    REQUIRE(nearestRankPercentile(samples, 0.5) == 50);
+    REQUIRE(nearestRankPercentile(samples, 0.99) == 99);
+    REQUIRE(nearestRankPercentile(samples, 1.0) == 100);
+    samples.resize(1000);
+    std::iota(samples.begin(), samples.end(), 1);
+    REQUIRE(nearestRankPercentile(samples, 0.999) == 999);
+}
+
+TEST_CASE("Latency buckets are log-linear", "[instrumentation]") {
+    using lab2Instrumentation::LatencyBuckets;
+
+    REQUIRE(LatencyBuckets::indexOf(0) == 0);
+    REQUIRE(LatencyBuckets::indexOf(7) == 7);
+    REQUIRE(LatencyBuckets::upperBound(LatencyBuckets::indexOf(7)) == 7);
+
+    // Every value lies within its bucket and the bucket width is at most 1/8 of the value
+    for (uint64_t value : {8ull, 9ull, 100ull, 1000ull, 123456ull, 987654321ull}) {
+        int index = LatencyBuckets::indexOf(value);
+        REQUIRE(LatencyBuckets::upperBound(index) >= value);
+        REQUIRE((index == 0 || LatencyBuckets::upperBound(index - 1) < value));
+        REQUIRE(LatencyBuckets::upperBound(index) - value <= value / 8);
+    }
+
+    REQUIRE(LatencyBuckets::indexOf(~0ull) == LatencyBuckets::COUNT - 1);
+}
+
+TEST_CASE("Instrumentation snapshot aggregates across threads", "[instrumentation]") {
+    using namespace lab2Instrumentation;
+    reset();
+
+    std::thread worker([] {
+        for (int i = 0; i < 100; i++) {
+            recordLatency(Op::TRAIN_ADD_WAGON, 1000);
+        }
+        addCounter(Counter::TRAIN_REALLOCATIONS, 3);
+    });
+    worker.join();
+
+    recordLatency(Op::TRAIN_ADD_WAGON, 5);
+    addCounter(Counter::TRAIN_REALLOCATIONS, 1);
+
+    Snapshot snap = snapshot();
+    REQUIRE(snap.counters[static_cast<int>(Counter::TRAIN_REALLOCATIONS)] == 4);
+    const OpStats& stats = snap.ops[static_cast<int>(Op::TRAIN_ADD_WAGON)];
+    REQUIRE(stats.calls == 101);
+    REQUIRE(stats.percentile(0.0) == 5);
+    REQUIRE(stats.percentile(0.5) >= 1000);
+    REQUIRE(stats.percentile(0.5) <= 1000 + 1000 / 8);
+
+    std::ostringstream json;
+    writeJson(json, snap);
+    REQUIRE(json.str().find("\"Train::addWagon\":{\"calls\":101") != std::string::npos);
+    REQUIRE(json.str().find("\"trainReallocations\":4") != std::string::npos);
+
+    reset();
+    REQUIRE(snapshot().ops[static_cast<int>(Op::TRAIN_ADD_WAGON)].calls == 0);
+}
+
+TEST_CASE("Histogram percentiles use the nearest rank on small counts", "[instrumentation]") {
+    using namespace lab2Instrumentation;
+
+    OpStats pair;
+    pair.histogram[LatencyBuckets::indexOf(5)]++;
+    pair.histogram[LatencyBuckets::indexOf(1000)]++;
+    pair.calls = 2;
+    REQUIRE(pair.percentile(0.5) == LatencyBuckets::upperBound(LatencyBuckets::indexOf(5)));
+    REQUIRE(pair.percentile(1.0) == LatencyBuckets::upperBound(LatencyBuckets::indexOf(1000)));
+
+    // The 99th of 100 samples is not the single slow one
+    OpStats hundred;
+    hundred.histogram[LatencyBuckets::indexOf(10)] = 99;
+    hundred.histogram[LatencyBuckets::indexOf(1'000'000)] = 1;
+    hundred.calls = 100;
+    REQUIRE(hundred.percentile(0.99) == LatencyBuckets::upperBound(LatencyBuckets::indexOf(10)));
+    REQUIRE(hundred.percentile(0.99) != LatencyBuckets::upperBound(LatencyBuckets::indexOf(1'000'000)));
+
+    REQUIRE(nearestRankIndex(0.999, 1000) == 998);
+    REQUIRE(nearestRankIndex(0.0, 3) == 0);
+}
+
+#ifdef TRAIN_INSTRUMENTATION
+TEST_CASE("Train operations feed the instrumentation counters", "[instrumentation]") {
+    using namespace lab2Instrumentation;
+    reset();
+
+    Train train;
+    for (int i = 0; i < 5; i++) {
+        train.addWagon(Wagon(50, 0, WagonType::ECONOMY));
+    }
+    train.boardPassengersToMostAvailableWagon(10, WagonType::ECONOMY);
+    train.optimizeTrain();
+    // Пакетное добавление учитывается отдельно от addWagon
+    Wagon batch[2] = {Wagon(WagonType::LUXURY), Wagon(WagonType::SITTING)};
+    train.append(batch);
+
+    Snapshot snap = snapshot();
+    REQUIRE(snap.ops[static_cast<int>(Op::TRAIN_ADD_WAGON)].calls == 5);
+    REQUIRE(snap.ops[static_cast<int>(Op::TRAIN_APPEND)].calls == 1);
+    REQUIRE(snap.counters[static_cast<int>(Counter::TRAIN_REALLOCATIONS)] == 4); // 1, 2, 4, 8
+    REQUIRE(snap.counters[static_cast<int>(Counter::WAGONS_SCANNED_FOR_BOARDING)] == 5);
+    REQUIRE(snap.counters[static_cast<int>(Counter::WAGONS_REMOVED_BY_OPTIMIZE)] == 4);
+}
+#endif
+
+TEST_CASE("GrowthPolicy computes capacities", "[Train][memory]") {
+    SECTION("Geometric growth doubles by default") {
+        GrowthPolicy policy;
+        REQUIRE(policy.grow(0, 1) == 1);
+        REQUIRE(policy.grow(1, 2) == 2);
+        REQUIRE(policy.grow(4, 5) == 8);
+        REQUIRE(policy.grow(4, 20) == 20);
+        REQUIRE_FALSE(policy.shouldShrink(0, 100));
+    }
+
+    SECTION("Fixed step and exact growth") {
+        REQUIRE(GrowthPolicy::fixedStep(4).grow(8, 9) == 12);
+        REQUIRE(GrowthPolicy::exact().grow(8, 9) == 9);
+    }
+
+    SECTION("Invalid parameters") {
+        REQUIRE_THROWS_AS(GrowthPolicy::geometric(1.0), std::invalid_argument);
+        REQUIRE_THROWS_AS(GrowthPolicy::fixedStep(0), std::invalid_argument);
+        REQUIRE_THROWS_AS(GrowthPolicy::exact(1.5), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Train memory accounting and growth policy", "[Train][memory]") {
+    Train train;
+    Wagon wagon(100, 10, WagonType::SITTING);
+
+    SECTION("reserve and shrinkToFit") {
+        train.reserve(10);
+        REQUIRE(train.getCapacity() == 10);
+        train.addWagon(wagon);
+        REQUIRE(train.getCapacity() == 10);
+        REQUIRE(train.slack() == 9 * sizeof(Wagon));
+        REQUIRE(train.bytesUsed() >= 10 * sizeof(Wagon));
+
+        train.shrinkToFit();
+        REQUIRE(train.getCapacity() == 1);
+        REQUIRE(train.slack() == 0);
+        REQUIRE(train.getWagonByIndex(0) == wagon);
+        REQUIRE_THROWS_AS(train.reserve(-1), std::invalid_argument);
+    }
+
+    SECTION("The policy applies to every growth path") {
+        train.setGrowthPolicy(GrowthPolicy::fixedStep(4));
+        train.addWagon(wagon);
+        REQUIRE(train.getCapacity() == 4);
+        train.addWagonAtIndex(wagon, 0);
+        train.addWagonAtIndex(wagon, 1);
+        train.addWagonAtIndex(wagon, 3);
+        REQUIRE(train.getCapacity() == 4);
+        train.addWagonAtIndex(wagon, 0);
+        REQUIRE(train.getCapacity() == 8);
+        train.setNumWagons(9);
+        REQUIRE(train.getCapacity() == 12);
+        REQUIRE(train.getWagonByIndex(8) == Wagon());
+    }
+
+    SECTION("Removals shrink a sparse array") {
+        train.setGrowthPolicy(GrowthPolicy::geometric(2.0, 0.25));
+        for (int i = 0; i < 16; i++) {
+            train.addWagon(wagon);
+        }
+        REQUIRE(train.getCapacity() == 16);
+        for (int i = 0; i < 12; i++) {
+            train.removeWagonByIndex(0);
+        }
+        REQUIRE(train.getNumWagons() == 4);
+        REQUIRE(train.getCapacity() == 8);
+        REQUIRE(train.getWagonByIndex(3) == wagon);
+    }
+
+    SECTION("optimizeTrain shrinks a sparse array") {
+        train.setGrowthPolicy(GrowthPolicy::exact(0.5));
+        train.addWagon(Wagon(100, 90, WagonType::SITTING));
+        for (int i = 0; i < 5; i++) {
+            train.addWagon(Wagon(100, 0, WagonType::SITTING));
+        }
+        train.optimizeTrain();
+        REQUIRE(train.getNumWagons() == 1);
+        REQUIRE(train.getCapacity() == 1);
+    }
+}
+
+TEST_CASE("reportFleetMemory sums the fleet slack", "[memory]") {
+    Train fleet[3];
+    fleet[0].reserve(10);
+    fleet[1].addWagon(Wagon(WagonType::ECONOMY));
+    fleet[2].reserve(4);
+    fleet[2].addWagon(Wagon(WagonType::LUXURY));
+
+    FleetMemoryReport report = reportFleetMemory(fleet, 3);
+    REQUIRE(report.numTrains == 3);
+    REQUIRE(report.numWagons == 2);
+    REQUIRE(report.capacity == 15);
+    REQUIRE(report.slackBytes == 13 * sizeof(Wagon));
+    REQUIRE(report.mostWastefulTrain == 0);
+    REQUIRE(report.getWastedFraction() > 0.5);
+
+    std::ostringstream oss;
+    oss << report;
+    REQUIRE(oss.str().find("most wasteful train: 0") != std::string::npos);
+}
+
+TEST_CASE("Wagon and Train special members are cheap to relocate", "[Wagon][Train]") {
+    STATIC_REQUIRE(std::is_trivially_copyable_v<Wagon>);
+    STATIC_REQUIRE(std::is_nothrow_move_constructible_v<Wagon>);
+    STATIC_REQUIRE(std::is_nothrow_move_constructible_v<Train>);
+    STATIC_REQUIRE(std::is_nothrow_move_assignable_v<Train>);
+}
+
+TEST_CASE("Train growth keeps wagons that alias the train", "[Train]") {
+    Train train;
+    train.addWagon(Wagon(100, 10, WagonType::SITTING));
+    train.shrinkToFit();
+
+    // Both calls reallocate while the argument refers into the old array
+    train.addWagon(train[0]);
+    train.addWagonAtIndex(train[1], 0);
+
+    REQUIRE(train.getNumWagons() == 3);
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(train.getWagonByIndex(i) == Wagon(100, 10, WagonType::SITTING));
+    }
+}
+
+TEST_CASE("Train copy assignment reuses a large enough buffer", "[Train]") {
+    Train big;
+    for (int i = 0; i < 8; i++) {
+        big.addWagon(Wagon(50 + i, i, WagonType::ECONOMY));
+    }
+    Train small;
+    small.addWagon(Wagon(10, 3, WagonType::LUXURY));
+    small.addWagon(Wagon(20, 4, WagonType::SITTING));
+
+    Train scratch;
+    scratch = big;
+    const Wagon* buffer = scratch.getWagons();
+    int capacity = scratch.getCapacity();
+
+    SECTION("Assigning a smaller train keeps the buffer") {
+        scratch = small;
+        REQUIRE(scratch.getWagons() == buffer);
+        REQUIRE(scratch.getCapacity() == capacity);
+        REQUIRE(scratch.getNumWagons() == 2);
+        REQUIRE(scratch[1] == Wagon(20, 4, WagonType::SITTING));
+        REQUIRE(scratch.getDirtyCount() == 2);
+
+        scratch = big;
+        REQUIRE(scratch.getWagons() == buffer);
+        REQUIRE(scratch.getNumWagons() == 8);
+        REQUIRE(scratch[7] == Wagon(57, 7, WagonType::ECONOMY));
+    }
+
+    SECTION("Assigning a larger train grows the buffer") {
+        Train tiny;
+        tiny = small;
+        tiny = big;
+        REQUIRE(tiny.getCapacity() >= 8);
+        REQUIRE(tiny.getNumWagons() == 8);
+        REQUIRE(tiny[0] == Wagon(50, 0, WagonType::ECONOMY));
+    }
+}
+
+TEST_CASE("Train emplace and range APIs", "[Train]") {
+    std::vector<Wagon> feed = {Wagon(10, 1, WagonType::SITTING), Wagon(20, 2, WagonType::ECONOMY), Wagon(30, 3, WagonType::LUXURY)};
+
+    SECTION("Construction from a range allocates once") {
+        Train train(feed);
+        REQUIRE(train.getNumWagons() == 3);
+        REQUIRE(train.getCapacity() == 3);
+        REQUIRE(train[2] == Wagon(30, 3, WagonType::LUXURY));
+        REQUIRE(train.getDirtyCount() == 3);
+    }
+
+    SECTION("Construction from a single-pass range") {
+        std::istringstream iss("0 2 3");
+        auto types = std::views::istream<int>(iss) | std::views::transform([](int type) { return Wagon(static_cast<WagonType>(type)); });
+        Train train(types);
+        REQUIRE(train.getNumWagons() == 3);
+        REQUIRE(train[0].getType() == WagonType::SITTING);
+        REQUIRE(train[2].getType() == WagonType::RESTAURANT);
+    }
+
+    SECTION("emplaceWagon constructs in place and validates the arguments") {
+        Train train;
+        train.reserve(2);
+        Wagon& added = train.emplaceWagon(40, 5, WagonType::ECONOMY);
+        REQUIRE(&added == train.getWagons());
+        train.emplaceWagon(WagonType::LUXURY);
+        train.emplaceWagon(train[0]);
+        REQUIRE(train.getNumWagons() == 3);
+        REQUIRE(train[2] == Wagon(40, 5, WagonType::ECONOMY));
+        REQUIRE_THROWS_AS(train.emplaceWagon(10, 20, WagonType::ECONOMY), std::invalid_argument);
+        REQUIRE(train.getNumWagons() == 3);
+    }
+
+    SECTION("insert places the range at the index with a single growth") {
+        Train train;
+        train.addWagon(Wagon(1, 0, WagonType::SITTING));
+        train.addWagon(Wagon(2, 0, WagonType::SITTING));
+        train.setGrowthPolicy(GrowthPolicy::exact());
+        train.clearDirty();
+
+        train.insert(1, feed.begin(), feed.end());
+        REQUIRE(train.getNumWagons() == 5);
+        REQUIRE(train.getCapacity() == 5);
+        REQUIRE_FALSE(train.isWagonDirty(0));
+        REQUIRE(train.getDirtyCount() == 4);
+        REQUIRE(train.getWagonByIndex(0).getMaxCapacity() == 1);
+        REQUIRE(train.getWagonByIndex(1).getMaxCapacity() == 10);
+        REQUIRE(train.getWagonByIndex(3).getMaxCapacity() == 30);
+        REQUIRE(train.getWagonByIndex(4).getMaxCapacity() == 2);
+        REQUIRE_THROWS_AS(train.insert(7, feed.begin(), feed.end()), std::invalid_argument);
+    }
+
+    SECTION("insert leaves the train unchanged when a wagon cannot be constructed") {
+        Train train(feed);
+        std::vector<int> capacities = {10, 2};
+        auto wagons = capacities | std::views::transform([](int capacity) { return Wagon(capacity, 5, WagonType::ECONOMY); });
+        REQUIRE_THROWS_AS(train.insert(1, wagons.begin(), wagons.end()), std::invalid_argument);
+        REQUIRE(train.getNumWagons() == 3);
+        REQUIRE(train[1] == Wagon(20, 2, WagonType::ECONOMY));
+    }
+
+    SECTION("append accepts wagons of the same train") {
+        Train train(feed);
+        train.append(std::span<const Wagon>(train.getWagons(), train.getNumWagons()));
+        REQUIRE(train.getNumWagons() == 6);
+        REQUIRE(train[3] == train[0]);
+        REQUIRE(train[5] == Wagon(30, 3, WagonType::LUXURY));
+    }
+}
+
+TEST_CASE("Train iterators and lazy views", "[Train]") {
+    STATIC_REQUIRE(std::ranges::contiguous_range<const Train>);
+    STATIC_REQUIRE(std::ranges::random_access_range<decltype(std::declval<const Train&>().occupancyColumn())>);
+
+    Train train(std::vector<Wagon>{Wagon(50, 10, WagonType::ECONOMY), Wagon(100, 95, WagonType::SITTING),
+                                   Wagon(50, 45, WagonType::ECONOMY), Wagon(30, 0, WagonType::LUXURY)});
+    train.clearDirty();
+    const Train& readOnly = train;
+
+    SECTION("Const iteration does not touch the checkpoint state") {
+        int total = 0;
+        for (const Wagon& wagon : readOnly) {
+            total += wagon.getOccupiedSeats();
+        }
+        REQUIRE(total == 150);
+        REQUIRE(readOnly.end() - readOnly.begin() == 4);
+        REQUIRE(readOnly.getWagonUnchecked(1).getOccupiedSeats() == 95);
+        REQUIRE(train.getDirtyCount() == 0);
+    }
+
+    SECTION("Read-only iteration of a non-const train does not touch the checkpoint state") {
+        int total = 0;
+        for (auto it = train.begin(); it != train.end(); ++it) {
+            total += it->getOccupiedSeats();
+        }
+        for (const Wagon& wagon : train) {
+            total += wagon.getMaxCapacity();
+        }
+        REQUIRE(total == 150 + 230);
+        REQUIRE(std::ranges::count(train, WagonType::ECONOMY, &Wagon::getType) == 2);
+        REQUIRE(train.getDirtyCount() == 0);
+    }
+
+    SECTION("Mutable iteration marks every wagon") {
+        std::ranges::sort(train.mutableWagons(), {}, &Wagon::getMaxCapacity);
+        REQUIRE(readOnly.getWagonUnchecked(0).getType() == WagonType::LUXURY);
+        REQUIRE(train.getDirtyCount() == 4);
+    }
+
+    SECTION("Views compose with range algorithms") {
+        REQUIRE(std::ranges::distance(readOnly.wagonsOfType(WagonType::ECONOMY)) == 2);
+        REQUIRE(std::ranges::distance(readOnly.wagonsWithFreeSeats(10)) == 2);
+        auto economyFree = readOnly.wagonsOfType(WagonType::ECONOMY) | std::views::filter([](const Wagon& wagon) {
+            return wagon.getOccupiedSeats() < 20;
+        });
+        REQUIRE(std::ranges::distance(economyFree) == 1);
+
+        auto column = readOnly.occupancyColumn();
+        REQUIRE(column.size() == 4);
+        REQUIRE(column[2] == 45);
+        REQUIRE(*std::ranges::max_element(column) == 95);
+        REQUIRE(train.getDirtyCount() == 0);
+    }
+}
+
+TEST_CASE("StaticTrain matches Train", "[StaticTrain]") {
+    std::initializer_list<Wagon> wagons = {Wagon(100, 40, WagonType::SITTING), Wagon(50, 10, WagonType::ECONOMY),
+                                           Wagon(100, 5, WagonType::SITTING), Wagon(30, 0, WagonType::LUXURY),
+                                           Wagon(50, 35, WagonType::ECONOMY)};
+    StaticTrain<8> fixed(wagons);
+    Train dynamic(wagons);
+
+    auto requireSame = [&]() {
+        REQUIRE(fixed.getNumWagons() == dynamic.getNumWagons());
+        REQUIRE(std::ranges::equal(fixed.view(), dynamic.view()));
+    };
+
+    SECTION("Boarding picks the same wagon") {
+        fixed.boardPassengersToMostAvailableWagon(20, WagonType::SITTING);
+        dynamic.boardPassengersToMostAvailableWagon(20, WagonType::SITTING);
+        requireSame();
+        REQUIRE_THROWS_AS(fixed.boardPassengersToMostAvailableWagon(60, WagonType::ECONOMY), std::invalid_argument);
+    }
+
+    SECTION("Redistribution, optimization and restaurant placement give the same consist") {
+        fixed.redistributePassengers();
+        dynamic.redistributePassengers();
+        requireSame();
+        fixed.optimizeTrain();
+        dynamic.optimizeTrain();
+        requireSame();
+        fixed.optimizeRestaurantPlacement();
+        dynamic.optimizeRestaurantPlacement();
+        requireSame();
+
+        int fixedOccupied, fixedCapacity, dynamicOccupied, dynamicCapacity;
+        fixed.getPassengerCountByType(WagonType::ECONOMY, fixedOccupied, fixedCapacity);
+        dynamic.getPassengerCountByType(WagonType::ECONOMY, dynamicOccupied, dynamicCapacity);
+        REQUIRE(fixedOccupied == dynamicOccupied);
+        REQUIRE(fixedCapacity == dynamicCapacity);
+    }
+
+    SECTION("Structural changes and output") {
+        fixed.addWagonAtIndex(Wagon(WagonType::LUXURY), 1);
+        dynamic.addWagonAtIndex(Wagon(WagonType::LUXURY), 1);
+        fixed.removeWagonByIndex(0);
+        dynamic.removeWagonByIndex(0);
+        requireSame();
+
+        std::ostringstream fixedOut, dynamicOut;
+        fixedOut << fixed;
+        dynamicOut << dynamic;
+        REQUIRE(fixedOut.str() == dynamicOut.str());
+        REQUIRE_THROWS_AS(fixed.removeWagonByIndex(5), std::out_of_range);
+    }
+
+    SECTION("A full train rejects new wagons") {
+        StaticTrain<2> small = {Wagon(WagonType::SITTING), Wagon(WagonType::ECONOMY)};
+        REQUIRE(StaticTrain<2>::getCapacity() == 2);
+        REQUIRE_THROWS_AS(small.addWagon(Wagon()), std::length_error);
+        REQUIRE_THROWS_AS(small.optimizeRestaurantPlacement(), std::length_error);
+        REQUIRE(small.getNumWagons() == 2);
+        REQUIRE_THROWS_AS((StaticTrain<1>{Wagon(), Wagon()}), std::length_error);
+    }
+}
+
+namespace {
+
+    // Consist built and balanced entirely by the compiler
+    constexpr StaticTrain<6> makeBalancedConsist() {
+        StaticTrain<6> consist = makeConsist<6>({{WagonType::ECONOMY, 2}, {WagonType::SITTING, 2}});
+        consist[0].boardPassengers(40);
+        consist[1].boardPassengers(10);
+        consist[2].boardPassengers(30);
+        consist.redistributePassengers();
+        consist.optimizeRestaurantPlacement();
+        return consist;
+    }
+
+    constexpr StaticTrain<6> BALANCED_CONSIST = makeBalancedConsist();
+
+} // namespace
+
+TEST_CASE("Wagon and StaticTrain work at compile time", "[Wagon][StaticTrain]") {
+    STATIC_REQUIRE(Wagon(WagonType::SITTING).getMaxCapacity() == 100);
+    STATIC_REQUIRE(Wagon(WagonType::LUXURY).getMaxCapacity() == 30);
+    STATIC_REQUIRE(Wagon(40, 10, WagonType::ECONOMY).getOccupancyPercentage() == 25.0);
+    STATIC_REQUIRE(Wagon() == Wagon(0, 0, WagonType::RESTAURANT));
+
+    STATIC_REQUIRE(INTERCITY_CONSIST.getNumWagons() == 9);
+    STATIC_REQUIRE(INTERCITY_CONSIST.getWagonUnchecked(2).getType() == WagonType::RESTAURANT);
+    STATIC_REQUIRE(INTERCITY_CONSIST.getWagonUnchecked(8).getMaxCapacity() == 50);
+    STATIC_REQUIRE(REGIONAL_CONSIST.getNumWagons() == 8);
+
+    STATIC_REQUIRE(BALANCED_CONSIST.getNumWagons() == 5);
+    STATIC_REQUIRE(BALANCED_CONSIST.getWagonUnchecked(0).getOccupiedSeats() == 25);
+    STATIC_REQUIRE(BALANCED_CONSIST.getWagonUnchecked(1).getType() == WagonType::RESTAURANT);
+
+    // The same operations at run time give the same consist
+    Train train(std::vector<Wagon>{Wagon(WagonType::ECONOMY), Wagon(WagonType::ECONOMY), Wagon(WagonType::SITTING), Wagon(WagonType::SITTING)});
+    train[0].boardPassengers(40);
+    train[1].boardPassengers(10);
+    train[2].boardPassengers(30);
+    train.redistributePassengers();
+    train.optimizeRestaurantPlacement();
+    REQUIRE(std::ranges::equal(train.view(), BALANCED_CONSIST.view()));
+
+    // Templates are copied into heap trains in one step
+    Train intercity(INTERCITY_CONSIST);
+    REQUIRE(intercity.getNumWagons() == 9);
+    REQUIRE(intercity.getCapacity() == 9);
+    REQUIRE(intercity.getWagonByIndex(0) == Wagon(WagonType::LUXURY));
+}
+
+TEST_CASE("PackedWagon and PackedTrain", "[PackedWagon][PackedTrain]") {
+    STATIC_REQUIRE(sizeof(PackedWagon) * 3 == sizeof(Wagon));
+    STATIC_REQUIRE(PackedWagon(Wagon(PackedWagon::MAX_SEATS, 7, WagonType::LUXURY)).getMaxCapacity() == PackedWagon::MAX_SEATS);
+    STATIC_REQUIRE(PackedWagon().toWagon() == Wagon());
+
+    SECTION("Conversion round-trips and rejects oversized wagons") {
+        for (WagonType type : {WagonType::SITTING, WagonType::ECONOMY, WagonType::LUXURY, WagonType::RESTAURANT}) {
+            Wagon wagon(1000, 999, type);
+            REQUIRE(PackedWagon(wagon).toWagon() == wagon);
+        }
+        REQUIRE_THROWS_AS(PackedWagon(Wagon(PackedWagon::MAX_SEATS + 1, 0, WagonType::SITTING)), std::out_of_range);
+    }
+
+    SECTION("Boarding follows the Wagon rules") {
+        PackedWagon wagon(Wagon(10, 8, WagonType::ECONOMY));
+        wagon.boardPassengers(2);
+        REQUIRE(wagon.getOccupiedSeats() == 10);
+        REQUIRE(wagon.getFreeSeats() == 0);
+        REQUIRE_THROWS_AS(wagon.boardPassengers(1), std::invalid_argument);
+        wagon.disembarkPassengers(10);
+        REQUIRE(wagon.getOccupiedSeats() == 0);
+        REQUIRE_THROWS_AS(PackedWagon().boardPassengers(1), std::invalid_argument);
+    }
+
+    SECTION("PackedTrain gives the same results as Train") {
+        Train train(std::vector<Wagon>{Wagon(50, 10, WagonType::ECONOMY), Wagon(100, 30, WagonType::SITTING),
+                                       Wagon(), Wagon(50, 20, WagonType::ECONOMY)});
+        PackedTrain packed(train.view());
+        REQUIRE(packed.getNumWagons() == 4);
+        REQUIRE(packed.bytesUsed() < train.bytesUsed());
+
+        int occupied, capacity, packedOccupied, packedCapacity;
+        train.getPassengerCountByType(WagonType::ECONOMY, occupied, capacity);
+        packed.getPassengerCountByType(WagonType::ECONOMY, packedOccupied, packedCapacity);
+        REQUIRE(packedOccupied == occupied);
+        REQUIRE(packedCapacity == capacity);
+
+        train.boardPassengersToMostAvailableWagon(5, WagonType::ECONOMY);
+        packed.boardPassengersToMostAvailableWagon(5, WagonType::ECONOMY);
+        REQUIRE(std::ranges::equal(Train(packed.view()).view(), train.view()));
+        REQUIRE_THROWS_AS(packed.boardPassengersToMostAvailableWagon(5, WagonType::LUXURY), std::invalid_argument);
+        REQUIRE_THROWS_AS(std::as_const(packed)[4], std::out_of_range);
+
+        packed.addWagon(PackedWagon(Wagon(WagonType::LUXURY)));
+        REQUIRE(packed[4].getType() == WagonType::LUXURY);
+        REQUIRE_THROWS_AS(PackedTrain(std::vector<Wagon>{Wagon(PackedWagon::MAX_SEATS + 1, 0, WagonType::SITTING)}), std::out_of_range);
+    }
+}
+
+TEST_CASE("Wagon type traits table", "[Wagon]") {
+    STATIC_REQUIRE(wagonTypeTraits(WagonType::ECONOMY).defaultCapacity == 50);
+    STATIC_REQUIRE_FALSE(wagonTypeTraits(WagonType::RESTAURANT).canBoard);
+
+    for (int i = 0; i < WAGON_TYPE_COUNT; i++) {
+        WagonType type = static_cast<WagonType>(i);
+        const WagonTypeTraits& traits = wagonTypeTraits(type);
+        REQUIRE(Wagon(type).getMaxCapacity() == traits.defaultCapacity);
+
+        WagonType decoded;
+        REQUIRE(wagonTypeFromSerialCode(traits.serialCode, decoded));
+        REQUIRE(decoded == type);
+
+        std::ostringstream oss;
+        oss << Wagon(type);
+        REQUIRE(oss.str() == std::to_string(traits.defaultCapacity) + "\n0\n" + std::to_string(traits.serialCode) + "\n");
+    }
+    WagonType unused;
+    REQUIRE_FALSE(wagonTypeFromSerialCode(WAGON_TYPE_COUNT, unused));
+    REQUIRE(std::string(wagonTypeTraits(WagonType::LUXURY).displayName) == "luxury");
+
+    SECTION("setType applies the default capacity of the new type") {
+        Wagon wagon(200, 120, WagonType::ECONOMY);
+        REQUIRE_THROWS_AS(wagon.setType(WagonType::LUXURY), std::invalid_argument);
+        wagon.setOccupiedSeats(20);
+        wagon.setType(WagonType::LUXURY);
+        REQUIRE(wagon.getMaxCapacity() == 30);
+        REQUIRE(wagon.getOccupiedSeats() == 30);
+    }
+
+    SECTION("setType to SITTING accepts any load, as before the traits table") {
+        STATIC_REQUIRE_FALSE(wagonTypeTraits(WagonType::SITTING).checksLoadOnRetype);
+        Wagon wagon(200, 120, WagonType::ECONOMY);
+        wagon.setType(WagonType::SITTING);
+        REQUIRE(wagon.getType() == WagonType::SITTING);
+        REQUIRE(wagon.getMaxCapacity() == 100);
+        REQUIRE(wagon.getOccupiedSeats() == 100);
+    }
+}
+
+TEST_CASE("BasicTrain storage policies and wagon representations", "[Train]") {
+    const std::vector<Wagon> consist = {Wagon(50, 10, WagonType::ECONOMY), Wagon(100, 30, WagonType::SITTING),
+                                        Wagon(), Wagon(50, 40, WagonType::ECONOMY), Wagon(30, 5, WagonType::LUXURY)};
+    const std::span<const Wagon> wagons(consist);
+
+    SECTION("Small buffer keeps short trains inline and spills to the heap") {
+        using SmallTrain = BasicTrain<Wagon, SmallBufferStorage<4>>;
+        SmallTrain train(wagons.first(3));
+        REQUIRE(train.getCapacity() == 4);
+        REQUIRE(train.bytesUsed() < 4 * sizeof(Wagon));
+
+        SmallTrain moved(std::move(train));
+        REQUIRE(train.getNumWagons() == 0);
+        REQUIRE(std::ranges::equal(moved.view(), wagons.first(3)));
+
+        moved.addWagon(consist[3]);
+        moved.addWagon(consist[4]);
+        REQUIRE(moved.getCapacity() > 4);
+        REQUIRE(std::ranges::equal(moved.view(), consist));
+
+        moved.removeWagonByIndex(4);
+        moved.shrinkToFit();
+        REQUIRE(moved.getCapacity() == 4);
+        REQUIRE(std::ranges::equal(moved.view(), wagons.first(4)));
+
+        train = std::move(moved);
+        REQUIRE(train.getNumWagons() == 4);
+        REQUIRE(train.getWagonByIndex(3) == consist[3]);
+    }
+
+    SECTION("Fixed storage never allocates and rejects growth past its capacity") {
+        using FixedTrain = BasicTrain<Wagon, FixedStorage<3>>;
+        FixedTrain train(wagons.first(3));
+        REQUIRE(train.getCapacity() == 3);
+        REQUIRE_THROWS_AS(train.addWagon(consist[3]), std::length_error);
+        REQUIRE(std::ranges::equal(train.view(), wagons.first(3)));
+
+        std::istringstream iss("4\n50\n0\n1\n50\n0\n1\n50\n0\n1\n50\n0\n1\n");
+        iss >> train;
+        REQUIRE(iss.fail());
+        REQUIRE(train.getNumWagons() == 3);
+
+        FixedTrain copy;
+        copy = train;
+        copy.optimizeTrain();
+        REQUIRE(copy.getNumWagons() == 2);
+    }
+
+    SECTION("Arena storage takes its arrays from the memory resource") {
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::monotonic_buffer_resource otherArena;
+        using ArenaTrain = BasicTrain<Wagon, ArenaStorage>;
+        ArenaTrain train(consist, &arena);
+        REQUIRE(train.getStorage().getResource() == &arena);
+
+        ArenaTrain sameArena(&arena);
+        const Wagon* array = train.getWagons();
+        sameArena = std::move(train);
+        REQUIRE(sameArena.getWagons() == array);
+
+        ArenaTrain otherTrain(&otherArena);
+        otherTrain = std::move(sameArena);
+        REQUIRE(otherTrain.getWagons() != array);
+        REQUIRE(otherTrain.getStorage().getResource() == &otherArena);
+        REQUIRE(std::ranges::equal(otherTrain.view(), consist));
+    }
+
+    SECTION("Packed wagons run the same algorithms with the same results") {
+        std::pmr::monotonic_buffer_resource arena;
+        Train train(consist);
+        BasicTrain<PackedWagon, ArenaStorage> packed(train.view(), &arena);
+        REQUIRE(packed.bytesUsed() < train.bytesUsed());
+
+        train.boardPassengersToMostAvailableWagon(5, WagonType::ECONOMY);
+        packed.boardPassengersToMostAvailableWagon(5, WagonType::ECONOMY);
+        train.redistributePassengers();
+        packed.redistributePassengers();
+        train.optimizeRestaurantPlacement();
+        packed.optimizeRestaurantPlacement();
+        train.optimizeTrain();
+        packed.optimizeTrain();
+
+        REQUIRE(std::ranges::equal(Train(packed.view()).view(), train.view()));
+        REQUIRE_THROWS_AS(packed.boardPassengersToMostAvailableWagon(1000, WagonType::SITTING), std::invalid_argument);
+    }
+}
+
+TEST_CASE("CowTrain shares chunks until they are modified", "[CowTrain]") {
+    Train train;
+    for (int i = 0; i < 5 * CowTrain::CHUNK_SIZE; i++) {
+        WagonType type = i % 3 == 0 ? WagonType::SITTING : (i % 3 == 1 ? WagonType::ECONOMY : WagonType::RESTAURANT);
+        Wagon wagon(type);
+        if (type != WagonType::RESTAURANT) {
+            wagon.setOccupiedSeats(i % 7);
+        }
+        train.addWagon(wagon);
+    }
+    const CowTrain base(train);
+    REQUIRE(base.getChunkCount() == 5);
+    REQUIRE(std::ranges::equal(base.toTrain().view(), train.view()));
+
+    SECTION("Copies share everything until the first write") {
+        CowTrain copy = base;
+        REQUIRE(copy == base);
+        REQUIRE(copy.countSharedChunks(base) == 5);
+        REQUIRE(copy.bytesOwned() == 0);
+
+        copy[1].setOccupiedSeats(40);
+        REQUIRE(copy.countSharedChunks(base) == 4);
+        REQUIRE(copy.bytesOwned() > 0);
+        REQUIRE(base[1].getOccupiedSeats() == 1);
+        REQUIRE_FALSE(copy == base);
+        REQUIRE_THROWS_AS(copy[5 * CowTrain::CHUNK_SIZE], std::invalid_argument);
+        REQUIRE_THROWS_AS(base[-1], std::out_of_range);
+    }
+
+    SECTION("Structural changes touch one chunk and split it when it grows too large") {
+        CowTrain copy = base;
+        for (int i = 0; i <= CowTrain::CHUNK_SIZE; i++) {
+            copy.addWagonAtIndex(Wagon(WagonType::LUXURY), 2 * CowTrain::CHUNK_SIZE);
+            train.addWagonAtIndex(Wagon(WagonType::LUXURY), 2 * CowTrain::CHUNK_SIZE);
+        }
+        REQUIRE(copy.getChunkCount() == 6);
+        REQUIRE(copy.countSharedChunks(base) == 4);
+        copy.removeWagonByIndex(0);
+        train.removeWagonByIndex(0);
+        REQUIRE(copy.countSharedChunks(base) == 3);
+        REQUIRE(std::ranges::equal(copy.toTrain().view(), train.view()));
+        REQUIRE_THROWS_AS(copy.addWagonAtIndex(Wagon(), copy.getNumWagons() + 1), std::invalid_argument);
+        REQUIRE_THROWS_AS(copy.removeWagonByIndex(copy.getNumWagons()), std::out_of_range);
+    }
+
+    SECTION("Planning operations give the same results as Train") {
+        CowTrain copy = base;
+        copy.boardPassengersToMostAvailableWagon(3, WagonType::ECONOMY);
+        train.boardPassengersToMostAvailableWagon(3, WagonType::ECONOMY);
+        REQUIRE(copy.countSharedChunks(base) == 4);
+
+        int occupied, capacity, trainOccupied, trainCapacity;
+        copy.getPassengerCountByType(WagonType::ECONOMY, occupied, capacity);
+        train.getPassengerCountByType(WagonType::ECONOMY, trainOccupied, trainCapacity);
+        REQUIRE(occupied == trainOccupied);
+        REQUIRE(capacity == trainCapacity);
+
+        copy.redistributePassengers();
+        train.redistributePassengers();
+        copy.optimizeRestaurantPlacement();
+        train.optimizeRestaurantPlacement();
+        copy.optimizeTrain();
+        train.optimizeTrain();
+        REQUIRE(std::ranges::equal(copy.toTrain().view(), train.view()));
+        REQUIRE(std::ranges::equal(base.toTrain().view(), CowTrain(base).toTrain().view()));
+
+        std::ostringstream cowOutput, trainOutput;
+        cowOutput << copy;
+        trainOutput << train;
+        REQUIRE(cowOutput.str() == trainOutput.str());
+    }
+
+    SECTION("Unchanged chunks survive optimizeTrain shared") {
+        CowTrain full(std::vector<Wagon>(3 * CowTrain::CHUNK_SIZE, Wagon(50, 50, WagonType::ECONOMY)));
+        CowTrain copy = full;
+        copy.addWagon(Wagon(WagonType::ECONOMY));
+        copy.optimizeTrain();
+        REQUIRE(copy.getNumWagons() == 3 * CowTrain::CHUNK_SIZE);
+        REQUIRE(copy.countSharedChunks(full) == 2);
+    }
+}
+
+TEST_CASE("PersistentTrain versions share structure", "[PersistentTrain]") {
+    Train train;
+    for (int i = 0; i < 100; i++) {
+        train.addWagon(Wagon(50, i % 10, WagonType::ECONOMY));
+    }
+    const PersistentTrain base(train);
+    REQUIRE(base.getNumWagons() == 100);
+    REQUIRE(base.getTotalOccupiedSeats() == 450);
+    REQUIRE(base.getHeight() <= 7);
+    REQUIRE(std::ranges::equal(base.toTrain().view(), train.view()));
+
+    SECTION("Operations return new versions and leave the old one unchanged") {
+        PersistentTrain boarded = base.boardPassengers(42, 5);
+        REQUIRE(boarded.getWagonByIndex(42).getOccupiedSeats() == 7);
+        REQUIRE(base.getWagonByIndex(42).getOccupiedSeats() == 2);
+        REQUIRE(boarded.getTotalOccupiedSeats() == 455);
+
+        PersistentTrain disembarked = boarded.disembarkPassengers(42, 7);
+        REQUIRE(disembarked[42].getOccupiedSeats() == 0);
+        REQUIRE_THROWS_AS(base.disembarkPassengers(0, 1), std::invalid_argument);
+        REQUIRE_THROWS_AS(base.boardPassengers(100, 1), std::out_of_range);
+
+        PersistentTrain inserted = base.addWagonAtIndex(Wagon(WagonType::LUXURY), 10);
+        train.addWagonAtIndex(Wagon(WagonType::LUXURY), 10);
+        REQUIRE(std::ranges::equal(inserted.toTrain().view(), train.view()));
+        PersistentTrain removed = inserted.removeWagonByIndex(0);
+        train.removeWagonByIndex(0);
+        REQUIRE(std::ranges::equal(removed.toTrain().view(), train.view()));
+        REQUIRE(base.getNumWagons() == 100);
+        REQUIRE_THROWS_AS(base.addWagonAtIndex(Wagon(), 101), std::invalid_argument);
+        REQUIRE_THROWS_AS(base.removeWagonByIndex(-1), std::out_of_range);
+
+        train.boardPassengersToMostAvailableWagon(3, WagonType::ECONOMY);
+        REQUIRE(std::ranges::equal(removed.boardPassengersToMostAvailableWagon(3, WagonType::ECONOMY).toTrain().view(), train.view()));
+        REQUIRE_THROWS_AS(base.boardPassengersToMostAvailableWagon(1, WagonType::LUXURY), std::invalid_argument);
+    }
+
+    SECTION("The tree stays balanced under appends and removals") {
+        PersistentTrain grown;
+        for (int i = 0; i < 1000; i++) {
+            grown = grown.addWagon(Wagon(WagonType::SITTING));
+        }
+        REQUIRE(grown.getHeight() <= 14);
+        for (int i = 0; i < 900; i++) {
+            grown = grown.removeWagonByIndex(0);
+        }
+        REQUIRE(grown.getNumWagons() == 100);
+        REQUIRE(grown.getHeight() <= 10);
+    }
+
+    SECTION("History memory grows with the number of changes") {
+        TrainHistory history(base);
+        for (int i = 0; i < 50; i++) {
+            history.commit(history.current().boardPassengers(i, 1));
+        }
+        REQUIRE(history.getVersionCount() == 51);
+        REQUIRE(history.countDistinctNodes() <= 100 + 50 * 7);
+        REQUIRE(history.at(0).isSameVersion(base));
+        REQUIRE(history.at(10).getWagonByIndex(9).getOccupiedSeats() == 10);
+        REQUIRE(history.at(10).getWagonByIndex(10).getOccupiedSeats() == 0);
+
+        history.rollbackTo(10);
+        REQUIRE(history.getVersionCount() == 11);
+        REQUIRE(history.current().getTotalOccupiedSeats() == 460);
+        REQUIRE_THROWS_AS(history.at(11), std::out_of_range);
+        REQUIRE_THROWS_AS(history.rollbackTo(-1), std::out_of_range);
+    }
+}
+
+TEST_CASE("SeatMap and SeatedWagon assign concrete seats", "[SeatMap]") {
+    SECTION("Free seats and adjacent blocks are found across words") {
+        SeatMap seats(130);
+        REQUIRE(seats.findFreeSeat() == 0);
+        for (int seat = 0; seat < 130; seat++) {
+            if (seat % 3 != 0 && !(seat >= 60 && seat < 70)) {
+                seats.occupy(seat);
+            }
+        }
+        REQUIRE(seats.findFreeSeat(1) == 3);
+        REQUIRE(seats.findAdjacentFreeSeats(1) == 0);
+        REQUIRE(seats.findAdjacentFreeSeats(2) == 60);
+        REQUIRE(seats.findAdjacentFreeSeats(10) == 60);
+        REQUIRE(seats.findAdjacentFreeSeats(11) == -1);
+        REQUIRE(seats.assignAdjacentSeats(3) == std::vector<int>{60, 61, 62});
+        REQUIRE(seats.findAdjacentFreeSeats(7) == 63);
+        REQUIRE(seats.findAdjacentFreeSeats(8) == -1);
+        REQUIRE(seats.findFreeSeat(130) == -1);
+        REQUIRE_THROWS_AS(seats.findAdjacentFreeSeats(0), std::invalid_argument);
+        REQUIRE_THROWS_AS(seats.occupy(130), std::out_of_range);
+        REQUIRE_THROWS_AS(seats.occupy(1), std::invalid_argument);
+        REQUIRE_THROWS_AS(seats.release(0), std::invalid_argument);
+
+        SeatMap empty(128);
+        REQUIRE(empty.findAdjacentFreeSeats(128) == 0);
+        REQUIRE(empty.findAdjacentFreeSeats(129) == -1);
+        empty.occupy(63);
+        REQUIRE(empty.findAdjacentFreeSeats(64) == 64);
+        REQUIRE(empty.assignSeats(3) == std::vector<int>{0, 1, 2});
+        REQUIRE(empty.countOccupied() == 4);
+        empty.releaseLastSeats(2);
+        REQUIRE(empty.isOccupied(0));
+        REQUIRE(empty.isOccupied(1));
+        REQUIRE_FALSE(empty.isOccupied(2));
+        REQUIRE_FALSE(empty.isOccupied(63));
+        REQUIRE_THROWS_AS(empty.assignSeats(127), std::invalid_argument);
+        REQUIRE(empty.countOccupied() == 2);
+    }
+
+    SECTION("The seated wagon keeps its count equal to the occupied seats") {
+        SeatedWagon wagon(Wagon(10, 3, WagonType::LUXURY));
+        REQUIRE(wagon.getSeatMap().countOccupied() == 3);
+        REQUIRE(wagon.boardPassengersWithSeats(2) == std::vector<int>{3, 4});
+        int leaving[] = {1, 3};
+        wagon.disembarkSeats(leaving);
+        REQUIRE(wagon.getOccupiedSeats() == 3);
+        REQUIRE(wagon.boardAdjacentPassengers(5) == std::vector<int>{5, 6, 7, 8, 9});
+        REQUIRE_THROWS_AS(wagon.boardAdjacentPassengers(2), std::invalid_argument);
+        REQUIRE_THROWS_AS(wagon.disembarkSeats(leaving), std::invalid_argument);
+        REQUIRE(wagon.getOccupiedSeats() == 8);
+        wagon.setOccupiedSeats(4);
+        REQUIRE(wagon.getSeatMap().countOccupied() == 4);
+        wagon.disembarkPassengers(1);
+        REQUIRE(static_cast<Wagon>(wagon) == Wagon(10, 3, WagonType::LUXURY));
+        REQUIRE_THROWS_AS(wagon.boardPassengers(8), std::invalid_argument);
+        REQUIRE(wagon.getSeatMap().countOccupied() == 3);
+        REQUIRE_THROWS_AS(SeatedWagon(WagonType::RESTAURANT).boardAdjacentPassengers(1), std::invalid_argument);
+    }
+
+    SECTION("A train of seated wagons boards like a train of wagons") {
+        BasicTrain<SeatedWagon> seated;
+        Train train;
+        for (const Wagon& wagon : {Wagon(50, 10, WagonType::ECONOMY), Wagon(50, 20, WagonType::ECONOMY), Wagon(WagonType::RESTAURANT)}) {
+            seated.addWagon(SeatedWagon(wagon));
+            train.addWagon(wagon);
+        }
+        seated.boardPassengersToMostAvailableWagon(5, WagonType::ECONOMY);
+        train.boardPassengersToMostAvailableWagon(5, WagonType::ECONOMY);
+        REQUIRE(seated[1].getSeatMap().isOccupied(24));
+        REQUIRE(std::ranges::equal(seated.view() | std::views::transform(&SeatedWagon::getWagon), train.view()));
+    }
+}
+
+TEST_CASE("RouteReservations books journeys between stops", "[RouteReservations]") {
+    SECTION("Segment occupancy answers range queries") {
+        SegmentOccupancy occupancy(9, 2);
+        occupancy.addPassengers(1, 4, 5);
+        occupancy.addPassengers(3, 8, 1);
+        REQUIRE(occupancy.maxOccupancy(0, 8) == 8);
+        REQUIRE(occupancy.maxOccupancy(0, 1) == 2);
+        REQUIRE(occupancy.maxOccupancy(4, 8) == 3);
+        REQUIRE(occupancy.minOccupancy(0, 8) == 2);
+        REQUIRE(occupancy.minOccupancy(1, 4) == 7);
+        occupancy.addPassengers(3, 4, -8);
+        REQUIRE(occupancy.minOccupancy(0, 8) == 0);
+        REQUIRE(occupancy.maxOccupancy(2, 5) == 7);
+        REQUIRE_THROWS_AS(occupancy.maxOccupancy(3, 3), std::out_of_range);
+        REQUIRE_THROWS_AS(occupancy.addPassengers(0, 9, 1), std::out_of_range);
+        REQUIRE_THROWS_AS(SegmentOccupancy(1), std::invalid_argument);
+    }
+
+    SECTION("Seats are reused after passengers leave") {
+        Train train;
+        train.addWagon(Wagon(10, 2, WagonType::ECONOMY));
+        train.addWagon(Wagon(WagonType::RESTAURANT));
+        train.addWagon(Wagon(10, 0, WagonType::ECONOMY));
+        RouteReservations reservations(train, 5);
+
+        REQUIRE(reservations.bookToMostAvailableWagon(8, WagonType::ECONOMY, 0, 2) == 0);
+        REQUIRE(reservations.getFreeSeats(0, 0, 4) == 0);
+        REQUIRE(reservations.getFreeSeats(0, 2, 4) == 8);
+        REQUIRE(reservations.bookToMostAvailableWagon(6, WagonType::ECONOMY, 2, 4) == 0);
+        REQUIRE(reservations.bookToMostAvailableWagon(3, WagonType::ECONOMY, 1, 3) == 2);
+        REQUIRE(reservations.findMostAvailableWagon(8, WagonType::ECONOMY, 0, 4) == -1);
+        REQUIRE_THROWS_AS(reservations.bookToMostAvailableWagon(8, WagonType::ECONOMY, 0, 4), std::invalid_argument);
+        REQUIRE_THROWS_AS(reservations.bookToMostAvailableWagon(0, WagonType::RESTAURANT, 0, 4), std::invalid_argument);
+        REQUIRE_THROWS_AS(reservations.book(0, 1, 1, 2), std::invalid_argument);
+
+        reservations.cancel(0, 8, 0, 2);
+        REQUIRE(reservations.getFreeSeats(0, 0, 2) == 8);
+        REQUIRE_THROWS_AS(reservations.cancel(0, 3, 0, 4), std::invalid_argument);
+        reservations.book(0, 8, 0, 2);
+        REQUIRE(reservations.getFreeSeats(0, 0, 4) == 0);
+        REQUIRE_THROWS_AS(reservations.getFreeSeats(3, 0, 1), std::out_of_range);
+        REQUIRE_THROWS_AS(reservations.findMostAvailableWagon(1, WagonType::ECONOMY, 2, 5), std::out_of_range);
+        REQUIRE(reservations.getTrain().getNumWagons() == 3);
+    }
+}
+
+TEST_CASE("Groups board into the shortest run of adjacent wagons", "[Train]") {
+    Train train;
+    train.addWagon(Wagon(50, 40, WagonType::ECONOMY));
+    train.addWagon(Wagon(50, 30, WagonType::ECONOMY));
+    train.addWagon(Wagon(WagonType::RESTAURANT));
+    train.addWagon(Wagon(50, 45, WagonType::ECONOMY));
+    train.addWagon(Wagon(50, 50, WagonType::ECONOMY));
+    train.addWagon(Wagon(50, 10, WagonType::ECONOMY));
+    train.addWagon(Wagon(50, 35, WagonType::ECONOMY));
+    train.addWagon(Wagon(WagonType::LUXURY));
+
+    REQUIRE(train.findAdjacentWagonsForGroup(15, WagonType::ECONOMY) == std::pair(1, 1));
+    REQUIRE(train.findAdjacentWagonsForGroup(40, WagonType::ECONOMY) == std::pair(5, 1));
+    REQUIRE(train.findAdjacentWagonsForGroup(55, WagonType::ECONOMY) == std::pair(5, 2));
+    REQUIRE(train.findAdjacentWagonsForGroup(56, WagonType::ECONOMY) == std::pair(3, 4));
+    REQUIRE(train.findAdjacentWagonsForGroup(61, WagonType::ECONOMY) == std::pair(-1, 0));
+    REQUIRE(train.findAdjacentWagonsForGroup(30, WagonType::LUXURY) == std::pair(7, 1));
+    REQUIRE_THROWS_AS(train.findAdjacentWagonsForGroup(0, WagonType::ECONOMY), std::invalid_argument);
+
+    SECTION("The group fills the run in order") {
+        train.clearDirty();
+        REQUIRE(train.boardGroupToAdjacentWagons(50, WagonType::ECONOMY) == std::pair(5, 2));
+        REQUIRE(train.getDirtyCount() == 2);
+        REQUIRE(train.isWagonDirty(6));
+        REQUIRE(train[5].getOccupiedSeats() == 50);
+        REQUIRE(train[6].getOccupiedSeats() == 45);
+        REQUIRE(train.boardGroupToAdjacentWagons(30, WagonType::ECONOMY) == std::pair(0, 2));
+        REQUIRE(train[0].getOccupiedSeats() == 50);
+        REQUIRE(train[1].getOccupiedSeats() == 50);
+    }
+
+    SECTION("A group that does not fit leaves the train unchanged") {
+        Train before = train;
+        REQUIRE_THROWS_AS(train.boardGroupToAdjacentWagons(61, WagonType::ECONOMY), std::invalid_argument);
+        REQUIRE_THROWS_AS(train.boardGroupToAdjacentWagons(1, WagonType::SITTING), std::invalid_argument);
+        REQUIRE(std::ranges::equal(train.view(), before.view()));
+    }
+}
+
+TEST_CASE("FleetAvailabilityIndex finds trains with free seats", "[FleetIndex]") {
+    FleetAvailabilityIndex fleet;
+    for (int i = 0; i < 5; i++) {
+        Train train;
+        train.addWagon(Wagon(30, 5 * i, WagonType::LUXURY));
+        train.addWagon(Wagon(30, 10, WagonType::LUXURY));
+        train.addWagon(Wagon(50, 0, WagonType::ECONOMY));
+        REQUIRE(fleet.addTrain(train) == i);
+    }
+    fleet.addTrain(Train());
+    REQUIRE(fleet.getTrainCount() == 6);
+    REQUIRE(fleet.getFreeSeats(3, WagonType::LUXURY) == 35);
+    REQUIRE(fleet.getLargestWagonFreeSeats(3, WagonType::LUXURY) == 20);
+    REQUIRE(fleet.getLargestWagonFreeSeats(5, WagonType::LUXURY) == 0);
+
+    REQUIRE(fleet.findTrainsWithFreeSeats(WagonType::LUXURY, 40) == std::vector<int>{2, 1, 0});
+    REQUIRE(fleet.findTrainsWithWagonFreeSeats(WagonType::LUXURY, 21) == std::vector<int>{1, 0});
+    REQUIRE(fleet.findTrainsWithWagonFreeSeats(WagonType::LUXURY, 31).empty());
+    REQUIRE(fleet.findTrainsWithFreeSeats(WagonType::SITTING, 1).empty());
+    REQUIRE(fleet.findTrainsWithFreeSeats(WagonType::ECONOMY, 50).size() == 5);
+
+    SECTION("Boarding through the index updates the keys") {
+        fleet.boardPassengersToMostAvailableWagon(0, 25, WagonType::LUXURY);
+        REQUIRE(fleet.getTrain(0).getWagonByIndex(0).getOccupiedSeats() == 25);
+        REQUIRE(fleet.getFreeSeats(0, WagonType::LUXURY) == 25);
+        REQUIRE(fleet.findTrainsWithFreeSeats(WagonType::LUXURY, 40) == std::vector<int>{2, 1});
+
+        REQUIRE(fleet.boardGroupToAdjacentWagons(1, 40, WagonType::LUXURY) == std::pair(0, 2));
+        REQUIRE(fleet.getFreeSeats(1, WagonType::LUXURY) == 5);
+        REQUIRE_THROWS_AS(fleet.boardPassengersToMostAvailableWagon(1, 6, WagonType::LUXURY), std::invalid_argument);
+        REQUIRE_THROWS_AS(fleet.getFreeSeats(6, WagonType::LUXURY), std::out_of_range);
+    }
+
+    SECTION("Arbitrary changes are re-keyed, even when they throw") {
+        fleet.modifyTrain(5, [](Train& train) { train.addWagon(Wagon(WagonType::SITTING)); });
+        REQUIRE(fleet.findTrainsWithWagonFreeSeats(WagonType::SITTING, 100) == std::vector<int>{5});
+        REQUIRE_THROWS_AS(fleet.modifyTrain(4, [](Train& train) {
+            train.removeWagonByIndex(2);
+            throw std::runtime_error("interrupted");
+        }), std::runtime_error);
+        REQUIRE(fleet.getFreeSeats(4, WagonType::ECONOMY) == 0);
+        REQUIRE(fleet.findTrainsWithFreeSeats(WagonType::ECONOMY, 1).size() == 4);
+    }
+
+    SECTION("A query for no seats returns only trains that could board") {
+        Train full;
+        full.addWagon(Wagon(30, 30, WagonType::LUXURY));
+        REQUIRE(fleet.addTrain(full) == 6);
+        REQUIRE(fleet.findTrainsWithWagonFreeSeats(WagonType::LUXURY, 0) == std::vector<int>{6, 2, 3, 4, 1, 0});
+        REQUIRE(fleet.findTrainsWithWagonFreeSeats(WagonType::SITTING, 0).empty());
+        REQUIRE(fleet.findTrainsWithWagonFreeSeats(WagonType::RESTAURANT, 0).empty());
+        REQUIRE(fleet.findTrainsWithWagonFreeSeats(WagonType::LUXURY, -1).empty());
+        fleet.boardPassengersToMostAvailableWagon(6, 0, WagonType::LUXURY);
+    }
+}
+
+TEST_CASE("Fleet operations run in parallel with deterministic results", "[ThreadPool]") {
+    std::vector<Train> fleet;
+    for (int size : {1, 40, 3, 200, 0, 7, 7, 90}) {
+        Train train;
+        for (int i = 0; i < size; i++) {
+            train.addWagon(i % 5 == 4 ? Wagon(WagonType::RESTAURANT) : Wagon(50, (i * 17) % 51, WagonType::ECONOMY));
+        }
+        fleet.push_back(train);
+    }
+    const FleetOperation batch[] = {FleetOperation::REDISTRIBUTE_PASSENGERS, FleetOperation::OPTIMIZE_TRAIN,
+                                    FleetOperation::OPTIMIZE_RESTAURANT_PLACEMENT};
+
+    std::vector<Train> expected = fleet;
+    for (Train& train : expected) {
+        for (FleetOperation operation : batch) {
+            applyFleetOperation(train, operation);
+        }
+    }
+
+    for (int threads : {1, 3, 8}) {
+        ThreadPool pool(threads);
+        REQUIRE(pool.getThreadCount() == threads);
+        std::vector<Train> work = fleet;
+        runFleetOperations(work, batch, pool);
+        for (size_t i = 0; i < work.size(); i++) {
+            REQUIRE(std::ranges::equal(work[i].view(), expected[i].view()));
+        }
+    }
+
+    SECTION("parallelFor runs every index and rethrows the lowest failure") {
+        ThreadPool pool(4);
+        std::vector<int> hits(1000, 0);
+        pool.parallelFor(1000, [&](int i) { hits[i]++; });
+        REQUIRE(std::ranges::count(hits, 1) == 1000);
+
+        std::atomic<int> ran{0};
+        try {
+            pool.parallelFor(100, [&](int i) {
+                ran++;
+                if (i % 10 == 3) {
+                    throw std::out_of_range(std::to_string(i));
+                }
+            });
+            FAIL("parallelFor did not rethrow");
+        } catch (const std::out_of_range& error) {
+            REQUIRE(std::string(error.what()) == "3");
+        }
+        REQUIRE(ran == 100);
+
+        std::atomic<int> nested{0};
+        pool.parallelFor(4, [&](int) { pool.parallelFor(5, [&](int) { nested++; }); });
+        REQUIRE(nested == 20);
+        REQUIRE_FALSE(pool.isWorkerThread());
+    }
+}
+
+TEST_CASE("Min-cost flow rebalances passengers between trains", "[Rebalancing]") {
+    SECTION("The solver finds the cheapest flow along the path") {
+        std::vector<int64_t> supply{5, 0, 0, 4, 0};
+        std::vector<int64_t> capacity{0, 2, 3, 0, 10};
+        PathFlow flow = solvePathFlow(supply, capacity);
+        REQUIRE(flow.edgeFlow == std::vector<int64_t>{5, 3, 0, 4});
+        REQUIRE(flow.absorbed == std::vector<int64_t>{0, 2, 3, 0, 4});
+        REQUIRE(flow.cost == 5 + 3 + 4);
+
+        // Поток может идти в обе стороны
+        supply = {0, 6, 0};
+        capacity = {4, 0, 3};
+        flow = solvePathFlow(supply, capacity);
+        REQUIRE(flow.cost == 6);
+        REQUIRE(flow.absorbed[0] + flow.absorbed[2] == 6);
+
+        REQUIRE(solvePathFlow(std::vector<int64_t>{}, std::vector<int64_t>{}).cost == 0);
+        REQUIRE_THROWS_AS(solvePathFlow(std::vector<int64_t>{3, 0}, std::vector<int64_t>{0, 2}), std::invalid_argument);
+        REQUIRE_THROWS_AS(solvePathFlow(std::vector<int64_t>{1}, std::vector<int64_t>{1, 1}), std::invalid_argument);
+    }
+
+    std::vector<Train> corridor(4);
+    corridor[0].addWagon(Wagon(50, 50, WagonType::ECONOMY));
+    corridor[0].addWagon(Wagon(30, 2, WagonType::LUXURY));
+    corridor[1].addWagon(Wagon(50, 0, WagonType::ECONOMY));
+    corridor[2].addWagon(Wagon(50, 10, WagonType::ECONOMY));
+    corridor[2].addWagon(Wagon(WagonType::RESTAURANT));
+    corridor[3].addWagon(Wagon(50, 0, WagonType::ECONOMY));
+    corridor[3].addWagon(Wagon(50, 0, WagonType::ECONOMY));
+    corridor[3].addWagon(Wagon(30, 4, WagonType::LUXURY));
+
+    SECTION("BALANCE gives every train its proportional share") {
+        TransferPlan plan = planRebalancing(corridor, RebalanceGoal::BALANCE);
+        REQUIRE(plan.transfers == std::vector<PassengerTransfer>{
+            {0, 1, WagonType::ECONOMY, 12}, {0, 2, WagonType::ECONOMY, 2}, {0, 3, WagonType::ECONOMY, 24}, {3, 0, WagonType::LUXURY, 1}});
+        REQUIRE(plan.passengersMoved == 39);
+        REQUIRE(plan.totalCost == 12 + 2 * 2 + 24 * 3 + 3);
+        REQUIRE(plan.freedTrains.empty());
+
+        applyTransferPlan(corridor, plan);
+        REQUIRE(corridor[0].view()[0].getOccupiedSeats() == 12);
+        REQUIRE(corridor[1].view()[0].getOccupiedSeats() == 12);
+        REQUIRE(corridor[2].view()[0].getOccupiedSeats() == 12);
+        REQUIRE(corridor[3].view()[0].getOccupiedSeats() == 24);
+        REQUIRE(corridor[3].view()[1].getOccupiedSeats() == 0);
+        REQUIRE(corridor[0].view()[1].getOccupiedSeats() == 3);
+        REQUIRE(corridor[3].view()[2].getOccupiedSeats() == 3);
+        REQUIRE(planRebalancing(corridor, RebalanceGoal::BALANCE).transfers.empty());
+    }
+
+    SECTION("CONSOLIDATE empties the least occupied trains that the rest can absorb") {
+        TransferPlan plan = planRebalancing(corridor, RebalanceGoal::CONSOLIDATE);
+        REQUIRE(plan.freedTrains == std::vector<int>{1, 3});
+        REQUIRE(plan.transfers == std::vector<PassengerTransfer>{{3, 0, WagonType::LUXURY, 4}});
+        REQUIRE(plan.totalCost == 12);
+        applyTransferPlan(corridor, plan);
+        REQUIRE(corridor[3].view()[2].getOccupiedSeats() == 0);
+        REQUIRE(corridor[0].view()[1].getOccupiedSeats() == 6);
+    }
+
+    SECTION("A plan that does not fit changes nothing") {
+        TransferPlan plan;
+        plan.transfers = {{0, 1, WagonType::ECONOMY, 40}, {2, 1, WagonType::ECONOMY, 11}};
+        REQUIRE_THROWS_AS(applyTransferPlan(corridor, plan), std::invalid_argument);
+        plan.transfers = {{0, 4, WagonType::ECONOMY, 1}};
+        REQUIRE_THROWS_AS(applyTransferPlan(corridor, plan), std::out_of_range);
+        REQUIRE(corridor[0].view()[0].getOccupiedSeats() == 50);
+        REQUIRE(corridor[1].view()[0].getOccupiedSeats() == 0);
+    }
+}
+
+TEST_CASE("Discrete-event station simulation", "[Simulation]") {
+    SECTION("Trains draw from streams that share no outputs") {
+        // Потоки поездов при начальном значении по умолчанию не должны быть сдвинутыми копиями друг друга
+        std::set<uint64_t> outputs;
+        for (uint64_t seed : {uint64_t{0}, SimulationConfig().seed}) {
+            outputs.clear();
+            for (uint64_t train = 0; train < 64; train++) {
+                RandomStream random(seed, train);
+                for (int i = 0; i < 256; i++) {
+                    outputs.insert(random());
+                }
+            }
+            REQUIRE(outputs.size() == 64 * 256);
+        }
+    }
+
+    SECTION("The event queue pops events in order as it grows and shrinks") {
+        EventQueue queue;
+        std::mt19937 rng(7);
+        std::vector<SimulationEvent> events;
+        for (int i = 0; i < 1000; i++) {
+            // Редкие далёкие события не должны растягивать дни календаря
+            int64_t time = i % 50 == 0 ? 1'000'000 + i : static_cast<int64_t>(rng() % 100);
+            events.push_back({time, static_cast<int>(rng() % 5), SimulationEventType::PASSENGER_ARRIVAL, i});
+            queue.push(events.back());
+        }
+        REQUIRE(queue.size() == 1000);
+        REQUIRE(queue.getBucketCount() >= 500);
+        std::sort(events.begin(), events.end());
+        std::vector<SimulationEvent> popped;
+        for (int i = 0; i < 500; i++) {
+            popped.push_back(queue.pop());
+        }
+        // Событие раньше уже извлечённых снова становится первым
+        queue.push({0, 0, SimulationEventType::STATION_ARRIVAL, 0});
+        REQUIRE(queue.pop() == SimulationEvent{0, 0, SimulationEventType::STATION_ARRIVAL, 0});
+        while (!queue.empty()) {
+            popped.push_back(queue.pop());
+        }
+        REQUIRE(popped == events);
+        REQUIRE(queue.getBucketCount() == 16);
+        REQUIRE_THROWS_AS(queue.pop(), std::out_of_range);
+        REQUIRE_THROWS_AS(queue.push({-1, 0, SimulationEventType::DEPARTURE, 0}), std::invalid_argument);
+    }
+
+    SimulationConfig config;
+    config.numStations = 3;
+    config.travelTime = 10;
+    config.dwellTime = 5;
+    config.headway = 0;
+    config.meanGroupInterval = 1'000'000'000'000;
+    config.maintenanceInterval = 0;
+    config.duration = 100;
+
+    SECTION("Trains follow the timetable") {
+        std::vector<Train> trains(1);
+        trains[0].addWagon(Wagon(WagonType::ECONOMY));
+        ThreadPool pool(1);
+        SimulationReport report = runSimulation(trains, config, pool);
+        // Отправление в 0, прибытия в 10, 25, 40, 55, 70, 85, 100
+        REQUIRE(report.stationStops == 7);
+        REQUIRE(report.events == 14);
+        REQUIRE(report.passengerGroups == 0);
+    }
+
+    SECTION("Passengers board and leave through the train operations") {
+        config.meanGroupInterval = 3;
+        config.duration = 10'000;
+        std::vector<Train> trains(2);
+        trains[0].addWagon(Wagon(50, 50, WagonType::ECONOMY));
+        trains[1].addWagon(Wagon(WagonType::SITTING));
+        trains[1].addWagon(Wagon(WagonType::RESTAURANT));
+        trains[1].addWagon(Wagon(WagonType::LUXURY));
+        config.disembarkShare = 0;
+        ThreadPool pool(2);
+        SimulationReport report = runSimulation(trains, config, pool);
+        REQUIRE(report.passengerGroups > 0);
+        REQUIRE(report.disembarkedPassengers == 0);
+        REQUIRE(report.boardedPassengers == trains[1].view()[0].getOccupiedSeats() + trains[1].view()[2].getOccupiedSeats());
+        REQUIRE(trains[0].view()[0].getOccupiedSeats() == 50);
+        REQUIRE(report.rejectedGroups > 0);
+        REQUIRE(report.passengerGroups > report.rejectedGroups + report.waitingGroups);
+
+        std::vector<Train> before = trains;
+        config.disembarkShare = 0.5;
+        int occupied = 0;
+        for (const Train& train : trains) {
+            for (const Wagon& wagon : train.view()) {
+                occupied += wagon.getOccupiedSeats();
+            }
+        }
+        report = runSimulation(trains, config, pool);
+        REQUIRE(report.disembarkedPassengers > 0);
+        for (const Train& train : trains) {
+            for (const Wagon& wagon : train.view()) {
+                occupied -= wagon.getOccupiedSeats();
+            }
+        }
+        REQUIRE(occupied == report.disembarkedPassengers - report.boardedPassengers);
+        REQUIRE_FALSE(trains == before);
+    }
+
+    SECTION("A seed gives the same run for any number of threads") {
+        config.meanGroupInterval = 20;
+        config.maintenanceInterval = 200;
+        config.duration = 5'000;
+        std::mt19937 rng(3);
+        std::vector<Train> fleet(13);
+        for (Train& train : fleet) {
+            for (int i = 0; i < 6; i++) {
+                train.addWagon(Wagon(static_cast<WagonType>(rng() % WAGON_TYPE_COUNT)));
+            }
+        }
+        std::vector<Train> single = fleet;
+        std::vector<Train> parallel = fleet;
+        ThreadPool onePool(1);
+        ThreadPool threePool(3);
+        SimulationReport first = runSimulation(single, config, onePool);
+        SimulationReport second = runSimulation(parallel, config, threePool);
+        REQUIRE(first == second);
+        REQUIRE(single == parallel);
+        REQUIRE(first.maintenanceRuns == 13 * 25);
+
+        config.seed = 2;
+        std::vector<Train> reseeded = fleet;
+        REQUIRE_FALSE(runSimulation(reseeded, config, onePool) == first);
+    }
+
+    SECTION("Invalid parameters are rejected") {
+        std::vector<Train> trains(1);
+        ThreadPool pool(1);
+        config.numStations = 0;
+        REQUIRE_THROWS_AS(runSimulation(trains, config, pool), std::invalid_argument);
+        config.numStations = 2;
+        config.disembarkShare = 1.5;
+        REQUIRE_THROWS_AS(runSimulation(trains, config, pool), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Monte Carlo demand forecasting", "[Forecast]") {
+    SECTION("Percent distributions stream and merge") {
+        PercentDistribution first;
+        PercentDistribution second;
+        for (int percent : {10, 20, 20, 50}) {
+            first.add(percent);
+        }
+        second.add(100);
+        REQUIRE(first.getCount() == 4);
+        REQUIRE(first.getMean() == Approx(25.0));
+        REQUIRE(first.getStandardDeviation() == Approx(15.0));
+        REQUIRE(first.getPercentile(0.5) == 20);
+        REQUIRE(first.getPercentile(1.0) == 50);
+        first.merge(second);
+        REQUIRE(first.getCount() == 5);
+        REQUIRE(first.getCountAt(20) == 2);
+        REQUIRE(first.getPercentile(1.0) == 100);
+        REQUIRE(PercentDistribution().getMean() == 0.0);
+        REQUIRE_THROWS_AS(first.add(101), std::out_of_range);
+        REQUIRE_THROWS_AS(first.getPercentile(1.5), std::out_of_range);
+    }
+
+    SECTION("The standard deviation stays exact for huge counts") {
+        PercentDistribution huge;
+        huge.add(0);
+        huge.add(100);
+        // 2^27 значений: сумма квадратов, умноженная на их число, не помещается в int64_t
+        for (int i = 0; i < 26; i++) {
+            PercentDistribution copy = huge;
+            huge.merge(copy);
+        }
+        REQUIRE(huge.getCount() == int64_t{1} << 27);
+        REQUIRE(huge.getMean() == Approx(50.0));
+        REQUIRE(huge.getStandardDeviation() == Approx(50.0));
+    }
+
+    SECTION("Scenario streams share no outputs") {
+        // Соседние сценарии не должны повторять розыгрыши друг друга со сдвигом
+        std::vector<uint64_t> outputs;
+        for (uint64_t seed : {uint64_t{0}, DemandModel().seed}) {
+            outputs.clear();
+            for (uint64_t scenario = 0; scenario < 256; scenario++) {
+                RandomStream random(seed, scenario);
+                for (int i = 0; i < 256; i++) {
+                    outputs.push_back(random());
+                }
+            }
+            std::sort(outputs.begin(), outputs.end());
+            REQUIRE(std::adjacent_find(outputs.begin(), outputs.end()) == outputs.end());
+        }
+    }
+
+    Train consist;
+    consist.addWagon(Wagon(50, 10, WagonType::ECONOMY));
+    consist.addWagon(Wagon(WagonType::RESTAURANT));
+    consist.addWagon(Wagon(50, 0, WagonType::ECONOMY));
+    consist.addWagon(Wagon(30, 0, WagonType::LUXURY));
+    DemandModel model;
+    model.meanGroups[static_cast<int>(WagonType::ECONOMY)] = 20;
+    model.meanGroups[static_cast<int>(WagonType::LUXURY)] = 60;
+    model.meanGroups[static_cast<int>(WagonType::SITTING)] = 5;
+    model.maxGroupSize = 1;
+    model.numScenarios = 500;
+
+    SECTION("hasWagonWithRoom agrees with boarding") {
+        REQUIRE(consist.hasWagonWithRoom(0, WagonType::ECONOMY));
+        REQUIRE(consist.hasWagonWithRoom(50, WagonType::ECONOMY));
+        REQUIRE_FALSE(consist.hasWagonWithRoom(51, WagonType::ECONOMY));
+        REQUIRE_FALSE(consist.hasWagonWithRoom(-1, WagonType::ECONOMY));
+        REQUIRE_FALSE(consist.hasWagonWithRoom(0, WagonType::RESTAURANT));
+        REQUIRE_FALSE(consist.hasWagonWithRoom(0, WagonType::SITTING));
+        REQUIRE_THROWS_AS(consist.boardPassengersToMostAvailableWagon(0, WagonType::RESTAURANT), std::invalid_argument);
+        REQUIRE_THROWS_AS(consist.boardPassengersToMostAvailableWagon(-1, WagonType::ECONOMY), std::invalid_argument);
+    }
+
+    SECTION("Light demand fits and heavy demand is rejected") {
+        ThreadPool pool(2);
+        DemandForecast forecast = forecastDemand(consist, model, pool);
+        REQUIRE(forecast.scenarios == 500);
+        const ClassForecast& economy = forecast.classes[static_cast<int>(WagonType::ECONOMY)];
+        const ClassForecast& luxury = forecast.classes[static_cast<int>(WagonType::LUXURY)];
+        REQUIRE(economy.rejectedGroups == 0);
+        REQUIRE(economy.occupancy.getCount() == 500);
+        REQUIRE(economy.occupancy.getMean() == Approx(30.0).margin(1.0));
+        REQUIRE(luxury.getRejectionRate() == Approx(0.5).margin(0.05));
+        REQUIRE(luxury.occupancy.getPercentile(0.1) == 100);
+        // В поезде нет сидячих вагонов, а вагоны-рестораны не принимают пассажиров
+        REQUIRE(forecast.classes[static_cast<int>(WagonType::SITTING)].groups == 0);
+        REQUIRE(forecast.classes[static_cast<int>(WagonType::RESTAURANT)].occupancy.getCount() == 0);
+        REQUIRE(consist.view()[0].getOccupiedSeats() == 10);
+    }
+
+    SECTION("A seed gives the same forecast for any number of threads") {
+        model.maxGroupSize = 4;
+        ThreadPool onePool(1);
+        ThreadPool threePool(3);
+        DemandForecast first = forecastDemand(consist, model, onePool);
+        REQUIRE(forecastDemand(consist, model, threePool) == first);
+        model.seed = 2;
+        REQUIRE_FALSE(forecastDemand(consist, model, threePool) == first);
+    }
+
+    SECTION("Invalid models are rejected") {
+        ThreadPool pool(1);
+        model.maxGroupSize = 0;
+        REQUIRE_THROWS_AS(forecastDemand(consist, model, pool), std::invalid_argument);
+        model.maxGroupSize = 1;
+        model.meanGroups[0] = -1;
+        REQUIRE_THROWS_AS(forecastDemand(consist, model, pool), std::invalid_argument);
+    }
+}
+
+TEST_CASE("TimingWheel fires timers in order and cancels them", "[TimingWheel]") {
+    SECTION("Timers fire at their expiry across levels, earliest first") {
+        TimingWheel<int> wheel;
+        std::vector<int64_t> expiries = {5, 64, 63, 4096, 70, 300'000, 6, 1LL << 31};
+        for (size_t i = 0; i < expiries.size(); i++) {
+            wheel.schedule(expiries[i], static_cast<int>(i));
+        }
+        std::vector<int> fired;
+        REQUIRE(wheel.advance(4, fired) == 0);
+        REQUIRE(wheel.advance(64, fired) == 4);
+        REQUIRE(fired == std::vector<int>{0, 6, 2, 1});
+        REQUIRE(wheel.advance(300'000, fired) == 3);
+        REQUIRE(fired == std::vector<int>{0, 6, 2, 1, 4, 3, 5});
+        REQUIRE(wheel.getTime() == 300'000);
+        REQUIRE(wheel.size() == 1);
+        REQUIRE(wheel.advance((1LL << 31) - 1, fired) == 0);
+        REQUIRE(wheel.advance(1LL << 31, fired) == 1);
+        REQUIRE(wheel.size() == 0);
+    }
+
+    SECTION("Random timers match a sorted reference, also past the top level") {
+        std::mt19937_64 rng(50);
+        TimingWheel<int64_t> wheel((1LL << 36) - 1000);
+        std::vector<int64_t> reference;
+        int64_t now = wheel.getTime();
+        for (int round = 0; round < 200; round++) {
+            for (int i = 0; i < 20; i++) {
+                int64_t expiry = now + 1 + static_cast<int64_t>(rng() % (rng() % 2 == 0 ? 5000 : 1LL << 33));
+                wheel.schedule(expiry, expiry);
+                reference.push_back(expiry);
+            }
+            now += static_cast<int64_t>(rng() % (1LL << 29));
+            std::vector<int64_t> fired;
+            wheel.advance(now, fired);
+            std::sort(reference.begin(), reference.end());
+            auto due = std::upper_bound(reference.begin(), reference.end(), now);
+            REQUIRE(fired == std::vector<int64_t>(reference.begin(), due));
+            reference.erase(reference.begin(), due);
+            REQUIRE(wheel.size() == reference.size());
+        }
+    }
+
+    SECTION("Cancelled and fired timers cannot be cancelled again") {
+        TimingWheel<int> wheel;
+        TimerId first = wheel.schedule(100, 1);
+        TimerId second = wheel.schedule(100, 2);
+        REQUIRE(*wheel.find(second) == 2);
+        REQUIRE(wheel.cancel(first));
+        REQUIRE_FALSE(wheel.cancel(first));
+        // Узел отмененного таймера переиспользуется, но старый идентификатор к нему не подходит
+        TimerId third = wheel.schedule(200, 3);
+        REQUIRE_FALSE(wheel.cancel(first));
+        std::vector<int> fired;
+        wheel.advance(150, fired);
+        REQUIRE(fired == std::vector<int>{2});
+        REQUIRE(wheel.find(second) == nullptr);
+        REQUIRE_FALSE(wheel.cancel(second));
+        REQUIRE(wheel.cancel(third));
+        REQUIRE(wheel.size() == 0);
+    }
+
+    SECTION("Invalid times are rejected") {
+        TimingWheel<int> wheel(1000);
+        std::vector<int> fired;
+        REQUIRE_THROWS_AS(wheel.schedule(1000, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(wheel.schedule(1000 + (1LL << 36), 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(wheel.advance(999, fired), std::invalid_argument);
+        REQUIRE_THROWS_AS(TimingWheel<int>(-1), std::invalid_argument);
+    }
+}
+
+TEST_CASE("TrainHolds holds, confirms, releases and expires seats", "[TrainHolds]") {
+    Train train;
+    train.addWagon(Wagon(10, 5, WagonType::ECONOMY));
+    train.addWagon(Wagon(WagonType::RESTAURANT));
+    train.addWagon(Wagon(10, 0, WagonType::ECONOMY));
+    TrainHolds holds(train, 1000);
+
+    // Как и boardPassengersToMostAvailableWagon, удержание занимает самый заполненный вагон
+    HoldId first = holds.hold(3, WagonType::ECONOMY, 500);
+    HoldId second = holds.hold(2, WagonType::ECONOMY, 100);
+    HoldId third = holds.hold(4, WagonType::ECONOMY, 100);
+    REQUIRE(holds.getTrain().view()[0].getOccupiedSeats() == 10);
+    REQUIRE(holds.getTrain().view()[2].getOccupiedSeats() == 4);
+    REQUIRE(holds.getActiveHoldCount() == 3);
+    REQUIRE(holds.getHeldSeats() == 9);
+
+    SECTION("Expired holds free their seats") {
+        REQUIRE(holds.advanceTo(1099) == 0);
+        REQUIRE(holds.advanceTo(1100) == 2);
+        REQUIRE(holds.getTrain().view()[0].getOccupiedSeats() == 8);
+        REQUIRE(holds.getTrain().view()[2].getOccupiedSeats() == 0);
+        REQUIRE(holds.getHeldSeats() == 3);
+        REQUIRE_FALSE(holds.confirm(second));
+        REQUIRE(holds.advanceTo(2000) == 1);
+        REQUIRE(holds.getTrain().view()[0].getOccupiedSeats() == 5);
+        REQUIRE(holds.getActiveHoldCount() == 0);
+        REQUIRE(holds.getTime() == 2000);
+    }
+
+    SECTION("Confirmed holds keep their seats and released holds free them at once") {
+        REQUIRE(holds.confirm(first));
+        REQUIRE_FALSE(holds.confirm(first));
+        REQUIRE(holds.release(third));
+        REQUIRE_FALSE(holds.release(third));
+        REQUIRE(holds.getTrain().view()[2].getOccupiedSeats() == 0);
+        REQUIRE(holds.getHeldSeats() == 2);
+        REQUIRE(holds.advanceTo(5000) == 1);
+        REQUIRE(holds.getTrain().view()[0].getOccupiedSeats() == 8);
+        REQUIRE(holds.getHeldSeats() == 0);
+    }
+
+    SECTION("Failed holds leave the train and the holds unchanged") {
+        REQUIRE_THROWS_AS(holds.hold(7, WagonType::ECONOMY, 100), std::invalid_argument);
+        REQUIRE_THROWS_AS(holds.hold(1, WagonType::ECONOMY, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(holds.hold(0, WagonType::ECONOMY, 100), std::invalid_argument);
+        REQUIRE_THROWS_AS(holds.hold(1, WagonType::ECONOMY, 1LL << 40), std::invalid_argument);
+        REQUIRE_THROWS_AS(holds.advanceTo(999), std::invalid_argument);
+        REQUIRE(holds.getActiveHoldCount() == 3);
+        REQUIRE(holds.getTrain().view()[2].getOccupiedSeats() == 4);
+    }
+}